@@ -5,6 +5,9 @@
 #include <cassert>
 #include <complex>
 #include <numbers>
+#include <istream>
+#include <ostream>
+#include <type_traits>
 
 
 template<class T>
@@ -35,4 +38,20 @@ RealType circular_fmod2(const RealType x, const RealType y)
   return result;
 }
 
+// Raw binary I/O of trivially copyable values (host byte order)
+template<typename T>
+void WriteBinary(std::ostream& os, const T& value)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool ReadBinary(std::istream& is, T& value)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  is.read(reinterpret_cast<char*>(&value), sizeof(T));
+  return static_cast<bool>(is);
+}
+
 #endif
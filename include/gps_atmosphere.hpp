@@ -0,0 +1,74 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_ATMOSPHERE
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_ATMOSPHERE
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "gps_ephemeris.hpp"
+
+namespace Gps
+{
+
+// L1 ionospheric group delay (seconds) from the broadcast Klobuchar model (IS-GPS-200 20.3.3.5.2.5).
+// Receiver latitude/longitude and satellite elevation/azimuth in radians, elevations below the
+// horizon are evaluated at the horizon.
+double KlobucharDelay(const IonosphereData& iono, const double gps_time, const double lat, const double lon,
+  const double elevation, const double azimuth);
+
+// Zenith tropospheric delay (meters), Saastamoinen hydrostatic and wet terms for a standard
+// atmosphere (50% humidity) at the receiver height, clamped to [0, 10 km]
+double TroposphereZenithDelay(const double lat, const double height);
+
+// Slant tropospheric delay (meters), the zenith delay scaled by the RTCA MOPS mapping function
+double TroposphereDelay(const double lat, const double height, const double elevation);
+
+
+/*
+Ionospheric and tropospheric delays for many receivers and satellites at once, with the same models
+as the scalar functions. Receiver geodetic terms (latitude, longitude, local frame and zenith
+tropospheric delay) are computed in SetReceivers, so a pair costs a few dozen flops in a
+vectorized loop: elevation and azimuth enter only through their sines and cosines. Satellites are
+split across up to num_threads threads (0 uses all hardware threads), only when each thread gets at
+least MIN_PAIRS_PER_THREAD receiver-satellite pairs, so small per-epoch batches stay on the calling
+thread.
+
+Delays are in meters of L1 code delay; the ionosphere advances the carrier phase by the same
+amount. Add them to ObservableBatch::pseudorange for delayed observables.
+*/
+class AtmosphereModel
+{
+public:
+  AtmosphereModel(const IonosphereData& iono, const unsigned int num_threads = 1);
+
+  // about 100 us of work at the SSE2 baseline, several times the cost of starting a thread
+  static constexpr std::size_t MIN_PAIRS_PER_THREAD = 2048;
+
+  void SetIonosphere(const IonosphereData& iono) { iono_ = iono; }
+  const IonosphereData& Ionosphere() const { return iono_; }
+
+  // Receivers are Size() x 3 ECEF
+  void SetReceivers(const SoaVector3& rx_pos);
+  std::size_t NumReceivers() const { return static_cast<std::size_t>(rx_pos_.rows()); }
+
+  // Outputs are resized to receivers x satellites
+  void Compute(const double gps_time, const std::vector<Eigen::Vector3d>& sat_pos, Eigen::MatrixXd& iono,
+    Eigen::MatrixXd& tropo) const;
+  // One satellite, outputs hold NumReceivers() values
+  void Compute(const double gps_time, const Eigen::Vector3d& sat_pos, double* iono, double* tropo) const;
+
+private:
+  IonosphereData iono_;
+  unsigned int num_threads_;
+
+  SoaVector3 rx_pos_;
+  SoaVector3 east_;
+  SoaVector3 north_;
+  SoaVector3 up_;
+  Eigen::VectorXd lat_; // semicircles
+  Eigen::VectorXd lon_; // semicircles
+  Eigen::VectorXd zenith_delay_; // meters
+};
+
+} // namespace Gps
+#endif
@@ -0,0 +1,153 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_CHECKPOINT
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_CHECKPOINT
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <istream>
+#include <ostream>
+
+#include "common_types.hpp"
+#include "gps_signal_gen.hpp"
+
+namespace Gps {
+namespace Lnav {
+
+/*
+Binary checkpoint of a generation run: the receive time, every signal State, every SatelliteInfo
+(data frame parameters, D29/D30 parity carry and both parity-encoded subframe buffers) and the
+library random engine. Restoring it and continuing produces the same samples, bit for bit, as
+continuing in-process with the same calls (floating-point generation re-derives its phase steps
+from the State at every call, so a run split at different points differs by rounding).
+Every value is written field by field, so no struct padding ends up in the file and the layout
+does not depend on the ABI; it is host byte order, so it only reads back on hosts of the same
+endianness.
+*/
+namespace internal
+{
+  template<typename RealType>
+  void WriteState(std::ostream& os, const State<RealType>& state)
+  {
+    WriteBinary(os, state.subframe);
+    WriteBinary(os, state.bit);
+    WriteBinary(os, state.code_cycle);
+    WriteBinary(os, state.chip);
+    WriteBinary(os, state.code_frequency);
+    WriteBinary(os, state.carrier_frequency);
+    WriteBinary(os, state.carrier_phase);
+    WriteBinary(os, state.code_frequency_rate);
+    WriteBinary(os, state.carrier_frequency_rate);
+    WriteBinary(os, state.visible);
+  }
+
+  template<typename RealType>
+  bool ReadState(std::istream& is, State<RealType>& state)
+  {
+    ReadBinary(is, state.subframe);
+    ReadBinary(is, state.bit);
+    ReadBinary(is, state.code_cycle);
+    ReadBinary(is, state.chip);
+    ReadBinary(is, state.code_frequency);
+    ReadBinary(is, state.carrier_frequency);
+    ReadBinary(is, state.carrier_phase);
+    ReadBinary(is, state.code_frequency_rate);
+    ReadBinary(is, state.carrier_frequency_rate);
+    return ReadBinary(is, state.visible);
+  }
+
+  void WriteCheckpointHeader(std::ostream& os, const double gps_time, const uint32_t num_signals,
+    const uint32_t real_size);
+  bool ReadCheckpointHeader(std::istream& is, double& gps_time, uint32_t& num_signals,
+    const uint32_t real_size);
+  void WriteRandomState(std::ostream& os);
+  bool ReadRandomState(std::istream& is);
+}
+
+
+template<typename RealType = double>
+void WriteCheckpoint(std::ostream& os, const double gps_time,
+  const std::vector<State<RealType>>& signal_states, const std::vector<SatelliteInfo>& sat_info)
+{
+  assert(signal_states.size() == sat_info.size());
+  internal::WriteCheckpointHeader(os, gps_time, static_cast<uint32_t>(signal_states.size()), sizeof(RealType));
+  for (std::size_t i = 0; i < signal_states.size(); i++) {
+    internal::WriteState(os, signal_states[i]);
+    sat_info[i].Save(os);
+  }
+  internal::WriteRandomState(os);
+}
+
+// sat_info is resized with placeholder PRNs that are overwritten by the checkpoint
+template<typename RealType = double>
+bool ReadCheckpoint(std::istream& is, double& gps_time,
+  std::vector<State<RealType>>& signal_states, std::vector<SatelliteInfo>& sat_info)
+{
+  uint32_t num_signals;
+  if (!internal::ReadCheckpointHeader(is, gps_time, num_signals, sizeof(RealType))) return false;
+
+  signal_states.resize(num_signals);
+  sat_info.assign(num_signals, SatelliteInfo(1));
+  for (std::size_t i = 0; i < num_signals; i++) {
+    if (!internal::ReadState(is, signal_states[i])) return false;
+    if (!sat_info[i].Load(is)) return false;
+  }
+  return internal::ReadRandomState(is);
+}
+
+bool WriteCheckpointFile(const std::string& path, const std::string& contents);
+
+
+// Writes a checkpoint whenever interval seconds of signal time have passed since the last one.
+// The file is written beside the target and renamed over it, so a crash never leaves a partial
+// checkpoint in place.
+class Checkpointer
+{
+public:
+  Checkpointer(const std::string& path, const double interval)
+    : path_{path}, interval_{interval}
+  {}
+
+  template<typename RealType = double>
+  bool Update(const double gps_time, const std::vector<State<RealType>>& signal_states,
+    const std::vector<SatelliteInfo>& sat_info)
+  {
+    if (has_written_ && ((gps_time - last_time_) < interval_)) {
+      return false;
+    }
+    std::ostringstream os(std::ios::binary);
+    WriteCheckpoint(os, gps_time, signal_states, sat_info);
+    if (!WriteCheckpointFile(path_, os.str())) {
+      return false;
+    }
+    last_time_ = gps_time;
+    has_written_ = true;
+    return true;
+  }
+
+  template<typename RealType = double>
+  bool Restore(double& gps_time, std::vector<State<RealType>>& signal_states,
+    std::vector<SatelliteInfo>& sat_info)
+  {
+    std::ifstream is(path_, std::ios::binary);
+    if (!is || !ReadCheckpoint(is, gps_time, signal_states, sat_info)) {
+      return false;
+    }
+    last_time_ = gps_time;
+    has_written_ = true;
+    return true;
+  }
+
+  const std::string& Path() const { return path_; }
+
+private:
+  std::string path_;
+  double interval_;
+  double last_time_ = 0.0;
+  bool has_written_ = false;
+};
+
+
+} // namespace Lnav
+} // namespace Gps
+#endif
@@ -0,0 +1,262 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_CNO_ESTIMATION
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_CNO_ESTIMATION
+
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <complex>
+#include <vector>
+#include <algorithm>
+
+namespace Gps
+{
+
+/*
+C/N0 estimation and lock detection from prompt correlator outputs, for banks of channels updated
+together each correlation period. State is structure-of-arrays with O(1) values per channel, the
+epoch counters are shared so the per-channel loops are branch-free and vectorize.
+
+All estimators assume prompt = A + n with complex noise of variance sigma^2 per arm and
+|A|^2 / (2 sigma^2) = C/N0 * T, the convention of the correlator models in gps_correlator_sim.hpp.
+Estimates are in dB-Hz and floored at 0 dB-Hz when the statistics are not meaningful.
+*/
+
+namespace internal
+{
+  template<typename FloatType>
+  FloatType RatioToDbHz(const FloatType snr, const FloatType corr_period)
+  {
+    return FloatType(10.0) * std::log10(std::max(snr / corr_period, FloatType(1.0)));
+  }
+}
+
+
+template<typename FloatType>
+class CnoEstimatorBank
+{
+public:
+  // Estimates are refreshed every window epochs. The narrowband-wideband power ratio uses blocks of
+  // nwpr_block epochs (keep within a data bit), window must be a multiple of it.
+  CnoEstimatorBank(const std::size_t num_channels, const FloatType corr_period, const std::size_t window = 100,
+      const std::size_t nwpr_block = 20)
+    : num_channels_{num_channels}, corr_period_{corr_period}, window_{window}, nwpr_block_{nwpr_block},
+      sum_i_(num_channels), sum_q_(num_channels), wide_power_(num_channels), power_ratio_(num_channels),
+      moment2_(num_channels), moment4_(num_channels), prev_i_(num_channels), beaulieu_(num_channels),
+      nwpr_cno_(num_channels), moments_cno_(num_channels), beaulieu_cno_(num_channels)
+  {
+    assert((window % nwpr_block) == 0);
+    assert(nwpr_block > 1);
+  }
+
+  // One correlation period of prompt outputs, one per channel
+  void Update(const std::complex<FloatType>* prompts)
+  {
+    const FloatType* p = reinterpret_cast<const FloatType*>(prompts);
+    FloatType* sum_i = sum_i_.data();
+    FloatType* sum_q = sum_q_.data();
+    FloatType* wide_power = wide_power_.data();
+    FloatType* moment2 = moment2_.data();
+    FloatType* moment4 = moment4_.data();
+    FloatType* prev_i = prev_i_.data();
+    FloatType* beaulieu = beaulieu_.data();
+    const bool has_prev = (epoch_ > 0) || (windows_ > 0);
+
+    for (std::size_t c = 0; c < num_channels_; c++) {
+      FloatType in_phase = p[2 * c];
+      FloatType quadrature = p[(2 * c) + 1];
+      FloatType power = (in_phase * in_phase) + (quadrature * quadrature);
+      sum_i[c] += in_phase;
+      sum_q[c] += quadrature;
+      wide_power[c] += power;
+      moment2[c] += power;
+      moment4[c] += power * power;
+
+      // Beaulieu: noise from successive in-phase magnitude differences
+      FloatType diff = std::abs(in_phase) - std::abs(prev_i[c]);
+      FloatType signal = FloatType(0.5) * ((in_phase * in_phase) + (prev_i[c] * prev_i[c]));
+      beaulieu[c] += has_prev ? ((diff * diff) / signal) : FloatType(0.0);
+      prev_i[c] = in_phase;
+    }
+    beaulieu_count_ += has_prev ? 1 : 0;
+    epoch_++;
+
+    if ((epoch_ % nwpr_block_) == 0) {
+      FloatType* power_ratio = power_ratio_.data();
+      for (std::size_t c = 0; c < num_channels_; c++) {
+        power_ratio[c] += ((sum_i[c] * sum_i[c]) + (sum_q[c] * sum_q[c])) / wide_power[c];
+        sum_i[c] = 0.0;
+        sum_q[c] = 0.0;
+        wide_power[c] = 0.0;
+      }
+    }
+    if (epoch_ == window_) {
+      Estimate();
+    }
+  }
+
+  bool Ready() const { return windows_ > 0; }
+  std::size_t NumChannels() const { return num_channels_; }
+
+  // Most recent estimates per channel, dB-Hz
+  const FloatType* Nwpr() const { return nwpr_cno_.data(); }
+  const FloatType* Moments() const { return moments_cno_.data(); }
+  const FloatType* Beaulieu() const { return beaulieu_cno_.data(); }
+
+  void Reset()
+  {
+    for (std::vector<FloatType>* values : {&sum_i_, &sum_q_, &wide_power_, &power_ratio_, &moment2_, &moment4_,
+                                           &prev_i_, &beaulieu_, &nwpr_cno_, &moments_cno_, &beaulieu_cno_}) {
+      std::fill(values->begin(), values->end(), FloatType(0.0));
+    }
+    epoch_ = 0;
+    windows_ = 0;
+    beaulieu_count_ = 0;
+  }
+
+private:
+  void Estimate()
+  {
+    const FloatType block = static_cast<FloatType>(nwpr_block_);
+    const FloatType inv_blocks = FloatType(1.0) / static_cast<FloatType>(window_ / nwpr_block_);
+    const FloatType inv_epochs = FloatType(1.0) / static_cast<FloatType>(window_);
+    const FloatType beaulieu_count = static_cast<FloatType>(beaulieu_count_);
+    for (std::size_t c = 0; c < num_channels_; c++) {
+      // (mu - 1) / (M - mu) for the mean power ratio mu over blocks of M
+      FloatType mu = power_ratio_[c] * inv_blocks;
+      nwpr_cno_[c] = internal::RatioToDbHz((mu - FloatType(1.0)) / (block - mu), corr_period_);
+
+      // second and fourth moments: Pd = sqrt(2 M2^2 - M4), Pn = M2 - Pd
+      FloatType m2 = moment2_[c] * inv_epochs;
+      FloatType m4 = moment4_[c] * inv_epochs;
+      FloatType signal = std::sqrt(std::max((FloatType(2.0) * m2 * m2) - m4, FloatType(0.0)));
+      moments_cno_[c] = internal::RatioToDbHz(signal / (m2 - signal), corr_period_);
+
+      beaulieu_cno_[c] = internal::RatioToDbHz(beaulieu_count / beaulieu_[c], corr_period_);
+
+      power_ratio_[c] = 0.0;
+      moment2_[c] = 0.0;
+      moment4_[c] = 0.0;
+      beaulieu_[c] = 0.0;
+    }
+    epoch_ = 0;
+    beaulieu_count_ = 0;
+    windows_++;
+  }
+
+  std::size_t num_channels_;
+  FloatType corr_period_;
+  std::size_t window_;
+  std::size_t nwpr_block_;
+  std::size_t epoch_ = 0; // epochs into the current window
+  std::size_t windows_ = 0; // completed windows
+  std::size_t beaulieu_count_ = 0;
+
+  std::vector<FloatType> sum_i_;
+  std::vector<FloatType> sum_q_;
+  std::vector<FloatType> wide_power_;
+  std::vector<FloatType> power_ratio_;
+  std::vector<FloatType> moment2_;
+  std::vector<FloatType> moment4_;
+  std::vector<FloatType> prev_i_;
+  std::vector<FloatType> beaulieu_;
+
+  std::vector<FloatType> nwpr_cno_;
+  std::vector<FloatType> moments_cno_;
+  std::vector<FloatType> beaulieu_cno_;
+};
+
+
+// Phase lock from the filtered cos(2*phase) estimate (I^2 - Q^2) / (I^2 + Q^2) of the summed
+// prompts over a window (keep within a data bit), code lock from a filtered moments C/N0 estimate.
+// Both metrics are low-pass filtered per window with the given gain.
+template<typename FloatType>
+class LockDetectorBank
+{
+public:
+  LockDetectorBank(const std::size_t num_channels, const FloatType corr_period, const std::size_t window = 20,
+      const FloatType phase_threshold = 0.8, const FloatType cno_threshold = 28.0,
+      const FloatType filter_gain = 0.1)
+    : num_channels_{num_channels}, corr_period_{corr_period}, window_{window}, phase_threshold_{phase_threshold},
+      cno_threshold_{cno_threshold}, filter_gain_{filter_gain},
+      sum_i_(num_channels), sum_q_(num_channels), moment2_(num_channels), moment4_(num_channels),
+      phase_metric_(num_channels), cno_metric_(num_channels), phase_lock_(num_channels), code_lock_(num_channels)
+  {}
+
+  void Update(const std::complex<FloatType>* prompts)
+  {
+    const FloatType* p = reinterpret_cast<const FloatType*>(prompts);
+    FloatType* sum_i = sum_i_.data();
+    FloatType* sum_q = sum_q_.data();
+    FloatType* moment2 = moment2_.data();
+    FloatType* moment4 = moment4_.data();
+    for (std::size_t c = 0; c < num_channels_; c++) {
+      FloatType in_phase = p[2 * c];
+      FloatType quadrature = p[(2 * c) + 1];
+      FloatType power = (in_phase * in_phase) + (quadrature * quadrature);
+      sum_i[c] += in_phase;
+      sum_q[c] += quadrature;
+      moment2[c] += power;
+      moment4[c] += power * power;
+    }
+    if (++epoch_ == window_) {
+      Detect();
+    }
+  }
+
+  std::size_t NumChannels() const { return num_channels_; }
+  const FloatType* PhaseMetric() const { return phase_metric_.data(); } // filtered cos(2*phase error)
+  const FloatType* CnoMetric() const { return cno_metric_.data(); } // filtered C/N0, dB-Hz
+  const uint8_t* PhaseLock() const { return phase_lock_.data(); }
+  const uint8_t* CodeLock() const { return code_lock_.data(); }
+
+private:
+  void Detect()
+  {
+    const FloatType inv_epochs = FloatType(1.0) / static_cast<FloatType>(window_);
+    // the first window initializes the filters
+    const FloatType gain = (windows_ == 0) ? FloatType(1.0) : filter_gain_;
+    for (std::size_t c = 0; c < num_channels_; c++) {
+      FloatType i2 = sum_i_[c] * sum_i_[c];
+      FloatType q2 = sum_q_[c] * sum_q_[c];
+      FloatType cos_2phase = (i2 - q2) / (i2 + q2);
+      phase_metric_[c] += gain * (cos_2phase - phase_metric_[c]);
+
+      FloatType m2 = moment2_[c] * inv_epochs;
+      FloatType m4 = moment4_[c] * inv_epochs;
+      FloatType signal = std::sqrt(std::max((FloatType(2.0) * m2 * m2) - m4, FloatType(0.0)));
+      FloatType cno = internal::RatioToDbHz(signal / (m2 - signal), corr_period_);
+      cno_metric_[c] += gain * (cno - cno_metric_[c]);
+
+      phase_lock_[c] = phase_metric_[c] > phase_threshold_;
+      code_lock_[c] = cno_metric_[c] > cno_threshold_;
+
+      sum_i_[c] = 0.0;
+      sum_q_[c] = 0.0;
+      moment2_[c] = 0.0;
+      moment4_[c] = 0.0;
+    }
+    epoch_ = 0;
+    windows_++;
+  }
+
+  std::size_t num_channels_;
+  FloatType corr_period_;
+  std::size_t window_;
+  FloatType phase_threshold_;
+  FloatType cno_threshold_;
+  FloatType filter_gain_;
+  std::size_t epoch_ = 0;
+  std::size_t windows_ = 0;
+
+  std::vector<FloatType> sum_i_;
+  std::vector<FloatType> sum_q_;
+  std::vector<FloatType> moment2_;
+  std::vector<FloatType> moment4_;
+  std::vector<FloatType> phase_metric_;
+  std::vector<FloatType> cno_metric_;
+  std::vector<uint8_t> phase_lock_;
+  std::vector<uint8_t> code_lock_;
+};
+
+} // namespace Gps
+#endif
@@ -15,9 +15,13 @@ namespace Gps
 
 namespace internal
 {
-  extern std::random_device random_gen;
+  // Seeded from std::random_device at startup; a deterministic engine so runs can be
+  // reproduced (SeedRandom) and checkpointed
+  extern std::mt19937_64 random_gen;
 }
 
+void SeedRandom(const uint64_t seed);
+
 // These are the exact precision as specified in the IS-GPS-200 documentation
 const double LIGHT_SPEED = 299792458.0;
 const double PI = 3.1415926535898; // used in ephemeris calculations
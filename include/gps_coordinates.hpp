@@ -0,0 +1,27 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_COORDINATES
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_COORDINATES
+
+#include <Eigen/Dense>
+
+namespace Gps
+{
+
+const double WGS84_SEMI_MAJOR_AXIS = 6378137.0;
+const double WGS84_FLATTENING = 1.0 / 298.257223563;
+const double WGS84_ECCENTRICITY_SQ = WGS84_FLATTENING * (2.0 - WGS84_FLATTENING);
+
+// Geodetic latitude and longitude in radians, altitude in meters above the ellipsoid
+Eigen::Vector3d LlaToEcef(const double lat, const double lon, const double alt);
+void EcefToLla(const Eigen::Vector3d& ecef, double& lat, double& lon, double& alt);
+
+// Rows are the east, north and up unit vectors expressed in ECEF
+Eigen::Matrix3d EcefToEnuRotation(const double lat, const double lon);
+Eigen::Matrix3d EcefToEnuRotation(const Eigen::Vector3d& ecef);
+
+// Elevation and azimuth (radians) of a satellite seen from a receiver, both in ECEF
+void ElevationAzimuth(const Eigen::Vector3d& rx_pos, const Eigen::Vector3d& sat_pos,
+  double& elevation, double& azimuth);
+double Elevation(const Eigen::Vector3d& rx_pos, const Eigen::Vector3d& sat_pos);
+
+} // namespace Gps
+#endif
@@ -0,0 +1,84 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_CORRELATOR_SCENARIO
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_CORRELATOR_SCENARIO
+
+#include <cstdint>
+#include <complex>
+#include <array>
+#include <vector>
+#include <random>
+
+#include <Eigen/Dense>
+
+#include "gps_ephemeris.hpp"
+#include "gps_signal_dynamics.hpp"
+#include "gps_correlator_sim.hpp"
+
+namespace Gps
+{
+
+// White Gaussian tracking errors per correlation period, and C/N0 interpolated
+// linearly in sin(elevation) between horizon and zenith values
+struct TrackingErrorModel
+{
+  double chip_sigma = 0.02; // chips
+  double frequency_sigma = 2.0; // Hz
+  double phase_sigma = 0.02; // cycles
+  double zenith_cno = 48.0; // dB-Hz
+  double horizon_cno = 38.0; // dB-Hz
+};
+
+struct CorrelatorChannel
+{
+  uint16_t satellite = 0; // index into the scenario's ephemerides
+  double elevation = 0.0; // radians
+  double cno = 0.0; // dB-Hz
+  std::array<std::complex<double>,3> taps; // early, prompt, late
+};
+
+
+// Correlator-level simulation of many receivers against one constellation. The geometry only
+// decides which satellites are above the mask and their C/N0 (elevation at the light-time
+// corrected, Sagnac rotated transmit position); the chip, frequency and phase errors are
+// independent white draws from the TrackingErrorModel, not the output of tracking loops.
+// Each Step evaluates every orbit once, then receivers are processed in parallel; receiver i
+// draws noise from its own engine seeded by (seed, i), so outputs do not depend on the thread count.
+class CorrelatorScenario
+{
+public:
+  // error_models holds one model per receiver, or a single model shared by all
+  CorrelatorScenario(const std::vector<Ephemeris>& ephemerides, const std::vector<ReceiverTrajectory>& receivers,
+    const std::vector<TrackingErrorModel>& error_models, const double corr_period = 0.02,
+    const double early_late_spacing = 1.0, const double elevation_mask = 0.0, const uint64_t seed = 0,
+    const unsigned int num_threads = 0);
+
+  // Channels of every receiver for the correlation period ending at gps_time
+  void Step(const double gps_time);
+
+  const std::vector<CorrelatorChannel>& Channels(const std::size_t receiver) const { return channels_[receiver]; }
+  std::size_t NumReceivers() const { return receivers_.size(); }
+  std::size_t NumSatellites() const { return ephemerides_.size(); }
+  double CorrPeriod() const { return corr_period_; }
+
+private:
+  void StepReceiver(const std::size_t receiver, const double gps_time);
+
+  std::vector<PreparedEphemeris> ephemerides_;
+  std::vector<ReceiverTrajectory> receivers_;
+  std::vector<TrackingErrorModel> error_models_;
+  double corr_period_;
+  double sin_elevation_mask_;
+  unsigned int num_threads_;
+  MultiTapCorrelatorSim<double,3> correlator_;
+
+  // satellite states at the shared reference time, refreshed each Step
+  double reference_time_ = 0.0;
+  std::vector<Eigen::Vector3d> sat_pos_;
+  std::vector<Eigen::Vector3d> sat_vel_;
+  std::vector<Eigen::Vector3d> sat_acc_;
+
+  std::vector<std::mt19937_64> generators_;
+  std::vector<std::vector<CorrelatorChannel>> channels_;
+};
+
+} // namespace Gps
+#endif
@@ -5,15 +5,116 @@
 #include <numbers>
 #include <random>
 #include <iostream>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <concepts>
+#include <limits>
+
+#include <Eigen/Dense>
 
 #include "common_types.hpp"
+#include "vector_math.hpp"
 #include "gps_common.hpp"
 
 namespace Gps {
 
 
-// Obtained from Scott Martin's dissertation, equation A.3
-template<typename FloatType>
+//--------------------------- Math Policies ---------------------------
+// Selects how the sinc and phasor terms of the scalar correlator model are evaluated.
+// Math::Sinc(x) returns sin(x)/x, Math::Phasor(cycles) returns exp(i*2*pi*cycles).
+
+struct ExactMath
+{
+  template<typename T>
+  static T Sinc(const T x)
+  {
+    if (x == T(0.0)) return T(1.0);
+    return std::sin(x) / x;
+  }
+
+  template<typename T>
+  static std::complex<T> Phasor(const T cycles)
+  {
+    return std::exp(ComplexI<T> * TwoPi<T> * cycles);
+  }
+};
+
+// Linearly interpolated tables, built on first use per FloatType.
+// Maximum absolute error (double): sinc 6.4e-7 for |x| < SINC_TABLE_RANGE, exact beyond;
+// phasor 1.2e-6 per component, exact for non-finite or |cycles| >= 2^40.
+struct TableMath
+{
+  static constexpr std::size_t SINC_TABLE_SIZE = 4096;
+  static constexpr double SINC_TABLE_RANGE = 16.0;
+  static constexpr std::size_t PHASOR_TABLE_SIZE = 2048; // entries per cycle
+  static constexpr double PHASOR_TABLE_LIMIT = 1099511627776.0; // 2^40 cycles
+
+  template<typename T>
+  static T Sinc(const T x)
+  {
+    T abs_x = std::abs(x);
+    if (!(abs_x < T(SINC_TABLE_RANGE))) return ExactMath::Sinc(x);
+    const std::vector<T>& table = SincTable<T>();
+    T position = abs_x * T(SINC_TABLE_SIZE / SINC_TABLE_RANGE);
+    std::size_t index = static_cast<std::size_t>(position);
+    T frac = position - static_cast<T>(index);
+    return table[index] + (frac * (table[index + 1] - table[index]));
+  }
+
+  template<typename T>
+  static std::complex<T> Phasor(const T cycles)
+  {
+    if (!(std::abs(cycles) < T(PHASOR_TABLE_LIMIT))) return ExactMath::Phasor(cycles);
+    const std::vector<T>& table = SineTable<T>();
+    T position = (cycles - std::floor(cycles)) * T(PHASOR_TABLE_SIZE);
+    std::size_t index = std::min(static_cast<std::size_t>(position), PHASOR_TABLE_SIZE - 1);
+    T frac = position - static_cast<T>(index);
+    // cosine is the same table a quarter cycle ahead
+    std::size_t cos_index = index + (PHASOR_TABLE_SIZE / 4);
+    return {table[cos_index] + (frac * (table[cos_index + 1] - table[cos_index])),
+            table[index] + (frac * (table[index + 1] - table[index]))};
+  }
+
+private:
+  template<typename T>
+  static const std::vector<T>& SincTable()
+  {
+    static const std::vector<T> table = []()
+    {
+      std::vector<T> values(SINC_TABLE_SIZE + 1);
+      for (std::size_t i = 0; i <= SINC_TABLE_SIZE; i++) {
+        double x = static_cast<double>(i) * (SINC_TABLE_RANGE / SINC_TABLE_SIZE);
+        values[i] = static_cast<T>(ExactMath::Sinc(x));
+      }
+      return values;
+    }();
+    return table;
+  }
+
+  // sin over 1.25 cycles plus one guard entry
+  template<typename T>
+  static const std::vector<T>& SineTable()
+  {
+    static const std::vector<T> table = []()
+    {
+      std::vector<T> values(PHASOR_TABLE_SIZE + (PHASOR_TABLE_SIZE / 4) + 1);
+      for (std::size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<T>(std::sin(TwoPi<double> * static_cast<double>(i) / PHASOR_TABLE_SIZE));
+      }
+      return values;
+    }();
+    return table;
+  }
+};
+
+
+// Obtained from Scott Martin's dissertation, equation A.3, except for the amplitude: A.3 scales by
+// 2*sqrt(C/N0 * T), which with unit noise per arm puts the signal 3 dB above the stated C/N0. The
+// amplitude here is sqrt(2 * C/N0 * T), the usual convention, so |A|^2 / (2 sigma^2) = C/N0 * T and
+// the C/N0 estimators and thermal jitter formulas read back the C/N0 that was simulated.
+// CalcCorrelatorOutputs and CalcCorrelatorTaps use the same amplitude.
+template<typename FloatType, typename Math = ExactMath>
 void CalcCorrelatorOutput(std::complex<FloatType>& output, const FloatType& chip_error, const FloatType& freq_error,
     const FloatType& phase_error, const FloatType& corr_period, const FloatType& cno)
 {
@@ -25,25 +126,24 @@ void CalcCorrelatorOutput(std::complex<FloatType>& output, const FloatType& chip
     output = (1.0 - std::abs(chip_error));
   }
 
-  // Amplitude
-  output *= 2.0 * std::sqrt(cno * corr_period);
+  // Amplitude, unit noise variance per arm: |A|^2 / 2 = C/N0 * T
+  output *= std::sqrt(2.0 * cno * corr_period);
 
   // Frequency Error
   if (freq_error != 0.0) {
-    FloatType in_sinc = std::numbers::pi_v<FloatType> * corr_period * freq_error;
-    output *= std::sin(in_sinc) / in_sinc;
+    output *= Math::Sinc(std::numbers::pi_v<FloatType> * corr_period * freq_error);
   }
 
   // Phase Error
-  output *= std::exp(ComplexI<FloatType> * TwoPi<FloatType> * phase_error);
+  output *= Math::Phasor(phase_error);
 }
 
-template<typename FloatType>
+template<typename FloatType, typename Math = ExactMath>
 std::complex<FloatType> CalcCorrelatorOutput(const FloatType chip_error, const FloatType freq_error, const FloatType phase_error,
     const FloatType corr_period, const FloatType cno)
 {
   std::complex<FloatType> result;
-  CalcCorrelatorOutput(result, chip_error, freq_error, phase_error, corr_period, cno);
+  CalcCorrelatorOutput<FloatType,Math>(result, chip_error, freq_error, phase_error, corr_period, cno);
   return result;
 }
 
@@ -68,41 +168,267 @@ std::complex<FloatType> CalcCorrelatorOutput(const FloatType chip_error, const F
 //   output /= static_cast<FloatType>(chip_errors.size());
 // }
 
-template<typename FloatType, BracketContainer Container>
+// Running sums of chip, frequency and phase errors over one correlation period. Samples can be
+// pushed as they arrive, the dump is O(1) in the number of samples (evenly spaced assumed). The sums
+// are double whatever FloatType is, a float sum over a period of samples loses the average.
+template<typename FloatType, typename Math = ExactMath>
+class CorrelatorAccumulator
+{
+public:
+  void Push(const FloatType chip_error, const FloatType freq_error, const FloatType phase_error)
+  {
+    chip_sum_ += chip_error;
+    freq_sum_ += freq_error;
+    phase_sum_ += phase_error;
+    count_++;
+  }
+
+  // Bulk push, reduced with Eigen's vectorized sum
+  void Push(const FloatType* chip_errors, const FloatType* freq_errors, const FloatType* phase_errors,
+      const std::size_t count)
+  {
+    using ConstMap = Eigen::Map<const Eigen::Array<FloatType,Eigen::Dynamic,1>>;
+    chip_sum_ += ConstMap(chip_errors, count).template cast<double>().sum();
+    freq_sum_ += ConstMap(freq_errors, count).template cast<double>().sum();
+    phase_sum_ += ConstMap(phase_errors, count).template cast<double>().sum();
+    count_ += count;
+  }
+
+  template<BracketContainer Container>
+  void Push(const Container& chip_errors, const Container& freq_errors, const Container& phase_errors)
+  {
+    assert(chip_errors.size() == freq_errors.size());
+    assert(freq_errors.size() == phase_errors.size());
+    if constexpr (requires { { chip_errors.data() } -> std::convertible_to<const FloatType*>; }) {
+      Push(chip_errors.data(), freq_errors.data(), phase_errors.data(), chip_errors.size());
+    } else {
+      for (std::size_t i = 0; i < chip_errors.size(); i++) {
+        Push(chip_errors[i], freq_errors[i], phase_errors[i]);
+      }
+    }
+  }
+
+  // Correlator output from the averaged errors, does not reset
+  void Output(std::complex<FloatType>& output, const FloatType corr_period, const FloatType cno) const
+  {
+    assert(count_ > 0);
+    CalcCorrelatorOutput<FloatType,Math>(output, ChipAverage(), FreqAverage(), PhaseAverage(), corr_period, cno);
+  }
+
+  // Output and reset for the next correlation period
+  std::complex<FloatType> Dump(const FloatType corr_period, const FloatType cno)
+  {
+    std::complex<FloatType> result;
+    Output(result, corr_period, cno);
+    Reset();
+    return result;
+  }
+
+  void Reset()
+  {
+    chip_sum_ = 0.0;
+    freq_sum_ = 0.0;
+    phase_sum_ = 0.0;
+    count_ = 0;
+  }
+
+  std::size_t Count() const { return count_; }
+  FloatType ChipAverage() const { return static_cast<FloatType>(chip_sum_ / static_cast<double>(count_)); }
+  FloatType FreqAverage() const { return static_cast<FloatType>(freq_sum_ / static_cast<double>(count_)); }
+  FloatType PhaseAverage() const { return static_cast<FloatType>(phase_sum_ / static_cast<double>(count_)); }
+
+private:
+  double chip_sum_ = 0.0;
+  double freq_sum_ = 0.0;
+  double phase_sum_ = 0.0;
+  std::size_t count_ = 0;
+};
+
+
+template<typename FloatType, BracketContainer Container, typename Math = ExactMath>
 void CalcCorrelatorOutput(std::complex<FloatType>& output, const Container& chip_errors, const Container& freq_errors,
     const Container& phase_errors, const FloatType& corr_period, const FloatType& cno)
 {
-  assert(chip_errors.size() == freq_errors.size());
-  assert(freq_errors.size() == phase_errors.size());
-
-  double chip_average = 0.0;
-  double freq_average = 0.0;
-  double phase_average = 0.0;
-  for (std::size_t i = 0; i < chip_errors.size(); i++) {
-    chip_average += chip_errors[i];
-    freq_average += freq_errors[i];
-    phase_average += phase_errors[i];
-    // std::cout << freq_errors[i] << ", ";
-  }
-  // std::cout << freq_average << std::endl;
-  chip_average /= static_cast<FloatType>(chip_errors.size());
-  freq_average /= static_cast<FloatType>(chip_errors.size());
-  phase_average /= static_cast<FloatType>(chip_errors.size());
-  CalcCorrelatorOutput(output, chip_average, freq_average, phase_average, corr_period, cno);
+  CorrelatorAccumulator<FloatType,Math> accumulator;
+  accumulator.Push(chip_errors, freq_errors, phase_errors);
+  accumulator.Output(output, corr_period, cno);
 }
 
 
-template<typename FloatType, BracketContainer Container>
+template<typename FloatType, BracketContainer Container, typename Math = ExactMath>
 std::complex<FloatType> CalcCorrelatorOutput(const Container& chip_errors, const Container& freq_errors,
     const Container& phase_errors, const FloatType corr_period, const FloatType cno)
 {
   std::complex<FloatType> result;
-  CalcCorrelatorOutput(result, chip_errors, freq_errors, phase_errors, corr_period, cno);
+  CalcCorrelatorOutput<FloatType,Container,Math>(result, chip_errors, freq_errors, phase_errors, corr_period, cno);
   return result;
 }
 
 
-template<typename FloatType, bool StoreParams=false>
+// Batched CalcCorrelatorOutput over structure-of-arrays inputs. The amplitude terms use Eigen
+// array expressions (vectorized sqrt), the sinc and phasor use FastSinCos so that loop vectorizes.
+template<typename FloatType>
+void CalcCorrelatorOutputs(std::complex<FloatType>* outputs, const FloatType* chip_errors,
+    const FloatType* freq_errors, const FloatType* phase_errors, const FloatType* corr_periods,
+    const FloatType* cnos, const std::size_t count)
+{
+  using Array = Eigen::Array<FloatType,Eigen::Dynamic,1>;
+  using ConstMap = Eigen::Map<const Array>;
+  Array amplitude = (FloatType(1.0) - ConstMap(chip_errors, count).abs()).max(FloatType(0.0))
+                  * (FloatType(2.0) * ConstMap(cnos, count) * ConstMap(corr_periods, count)).sqrt();
+
+  const FloatType* amp = amplitude.data();
+  FloatType* out = reinterpret_cast<FloatType*>(outputs);
+  for (std::size_t i = 0; i < count; i++) {
+    FloatType sinc = FastSinc(std::numbers::pi_v<FloatType> * corr_periods[i] * freq_errors[i]);
+    FloatType cycles = phase_errors[i] - FastRound(phase_errors[i]);
+    FloatType s, c;
+    FastSinCos(TwoPi<FloatType> * cycles, s, c);
+    out[2 * i] = amp[i] * sinc * c;
+    out[(2 * i) + 1] = amp[i] * sinc * s;
+  }
+}
+
+
+namespace internal
+{
+  // Bulk standard normal draws by Box-Muller. Only the uniform draws are serial, the log, sqrt
+  // and sincos are vectorized. Uniforms take the top 53 bits of each draw, so the generator must
+  // produce full 64-bit words (std::mt19937_64, not std::mt19937).
+  template<typename FloatType, typename Generator>
+  void FillNormal(FloatType* values, const std::size_t count, Generator& gen)
+  {
+    static_assert((Generator::min() == 0) && (Generator::max() == std::numeric_limits<uint64_t>::max()),
+                  "FillNormal requires a generator of uniform 64-bit words");
+    using Array = Eigen::Array<FloatType,Eigen::Dynamic,1>;
+    constexpr double scale = 1.0 / 9007199254740992.0; // 2^-53
+    std::size_t pairs = (count + 1) / 2;
+    Array u1(pairs), u2(pairs);
+    FloatType* p1 = u1.data();
+    FloatType* p2 = u2.data();
+    for (std::size_t i = 0; i < pairs; i++) {
+      p1[i] = static_cast<FloatType>(static_cast<double>((gen() >> 11) + 1) * scale); // (0,1]
+      p2[i] = static_cast<FloatType>(static_cast<double>(gen() >> 11) * scale);
+    }
+    for (std::size_t i = 0; i < pairs; i++) {
+      p1[i] = FloatType(-2.0) * FastLog(p1[i]);
+    }
+    Array radius = u1.sqrt();
+    const FloatType* r = radius.data();
+    for (std::size_t i = 0; i < count / 2; i++) {
+      FloatType s, c;
+      FastSinCos(TwoPi<FloatType> * p2[i], s, c);
+      values[2 * i] = r[i] * c;
+      values[(2 * i) + 1] = r[i] * s;
+    }
+    if (count % 2) {
+      FloatType s, c;
+      FastSinCos(TwoPi<FloatType> * p2[pairs - 1], s, c);
+      values[count - 1] = r[pairs - 1] * c;
+    }
+  }
+}
+
+// Adds unit variance noise to the in-phase and quadrature parts of every output; gen must produce
+// 64-bit words, such as std::mt19937_64
+template<typename FloatType, typename Generator>
+void AddCorrelatorNoise(std::complex<FloatType>* outputs, const std::size_t count, Generator& gen)
+{
+  FloatType* values = reinterpret_cast<FloatType*>(outputs);
+  std::vector<FloatType> noise(2 * count);
+  internal::FillNormal(noise.data(), noise.size(), gen);
+  for (std::size_t i = 0; i < 2 * count; i++) {
+    values[i] += noise[i];
+  }
+}
+
+
+// Outputs at several code offsets (e.g. early/prompt/late) from one evaluation of the terms they
+// share: only the chip error triangle differs between taps. Offsets are in chips, the chip error
+// seen by tap i is chip_error + tap_offsets[i].
+template<typename FloatType, std::size_t NumTaps, typename Math = ExactMath>
+void CalcCorrelatorTaps(std::array<std::complex<FloatType>,NumTaps>& outputs,
+    const std::array<FloatType,NumTaps>& tap_offsets, const FloatType chip_error, const FloatType freq_error,
+    const FloatType phase_error, const FloatType corr_period, const FloatType cno)
+{
+  std::complex<FloatType> shared = std::sqrt(FloatType(2.0) * cno * corr_period) * Math::Phasor(phase_error);
+  if (freq_error != 0.0) {
+    shared *= Math::Sinc(std::numbers::pi_v<FloatType> * corr_period * freq_error);
+  }
+  for (std::size_t i = 0; i < NumTaps; i++) {
+    FloatType triangle = FloatType(1.0) - std::abs(chip_error + tap_offsets[i]);
+    outputs[i] = (triangle > FloatType(0.0)) ? (triangle * shared) : std::complex<FloatType>(0.0);
+  }
+}
+
+
+// Multi-tap correlator simulation with correctly correlated noise between taps. Tap noise
+// correlation is the code autocorrelation at the tap separation, max(0, 1 - |d_i - d_j|);
+// its square root is computed once at construction. Math selects the sinc and phasor evaluation
+// as for CorrelatorSim.
+template<typename FloatType, std::size_t NumTaps, typename Math = ExactMath>
+class MultiTapCorrelatorSim
+{
+public:
+  using Matrix = Eigen::Matrix<FloatType,NumTaps,NumTaps>;
+  using Vector = Eigen::Matrix<FloatType,NumTaps,1>;
+
+  explicit MultiTapCorrelatorSim(const std::array<FloatType,NumTaps>& tap_offsets)
+    : tap_offsets_{tap_offsets}
+  {
+    for (std::size_t i = 0; i < NumTaps; i++) {
+      for (std::size_t j = 0; j < NumTaps; j++) {
+        noise_correlation_(i,j) = std::max(FloatType(0.0),
+                                           FloatType(1.0) - std::abs(tap_offsets[i] - tap_offsets[j]));
+      }
+    }
+    // symmetric square root tolerates coincident taps (singular correlation)
+    Eigen::SelfAdjointEigenSolver<Matrix> solver(noise_correlation_);
+    noise_shaping_ = solver.eigenvectors()
+                   * solver.eigenvalues().cwiseMax(FloatType(0.0)).cwiseSqrt().asDiagonal()
+                   * solver.eigenvectors().transpose();
+  }
+
+  template<typename Generator>
+  void Simulate(std::array<std::complex<FloatType>,NumTaps>& outputs, const FloatType chip_error,
+      const FloatType freq_error, const FloatType phase_error, const FloatType corr_period,
+      const FloatType cno, Generator& gen) const
+  {
+    CalcCorrelatorTaps<FloatType,NumTaps,Math>(outputs, tap_offsets_, chip_error, freq_error, phase_error,
+      corr_period, cno);
+    std::normal_distribution<FloatType> normal_dist;
+    Vector in_phase, quadrature;
+    for (std::size_t i = 0; i < NumTaps; i++) {
+      in_phase(i) = normal_dist(gen);
+      quadrature(i) = normal_dist(gen);
+    }
+    in_phase = noise_shaping_ * in_phase;
+    quadrature = noise_shaping_ * quadrature;
+    for (std::size_t i = 0; i < NumTaps; i++) {
+      outputs[i] += std::complex<FloatType>(in_phase(i), quadrature(i));
+    }
+  }
+
+  void Simulate(std::array<std::complex<FloatType>,NumTaps>& outputs, const FloatType chip_error,
+      const FloatType freq_error, const FloatType phase_error, const FloatType corr_period,
+      const FloatType cno) const
+  {
+    Simulate(outputs, chip_error, freq_error, phase_error, corr_period, cno, internal::random_gen);
+  }
+
+  const std::array<FloatType,NumTaps>& TapOffsets() const { return tap_offsets_; }
+  const Matrix& NoiseCorrelation() const { return noise_correlation_; }
+
+private:
+  std::array<FloatType,NumTaps> tap_offsets_;
+  Matrix noise_correlation_;
+  Matrix noise_shaping_;
+};
+
+
+// Math selects the scalar evaluation policy (ExactMath or TableMath), the batched
+// structure-of-arrays path always uses the vectorized FastSinCos
+template<typename FloatType, bool StoreParams=false, typename Math=ExactMath>
 class CorrelatorSim
 {
 public:
@@ -116,9 +442,8 @@ public:
       const FloatType corr_period, const FloatType cno) const
   {
     std::complex<FloatType> result;
-    CalcCorrelatorOutput(result, chip_error, freq_error, phase_error, corr_period, cno);
-    result.real += normal_dist_(internal::random_gen);
-    result.imag += normal_dist_(internal::random_gen);
+    CalcCorrelatorOutput<FloatType,Math>(result, chip_error, freq_error, phase_error, corr_period, cno);
+    AddNoise(result);
     return result;
   }
 
@@ -127,9 +452,8 @@ public:
     const Container& phase_errors, const FloatType corr_period, const FloatType cno) const
   {
     std::complex<FloatType> result;
-    CalcCorrelatorOutput<FloatType,Container>(result, chip_errors, freq_errors, phase_errors, corr_period, cno);
-    result.real += normal_dist_(internal::random_gen);
-    result.imag += normal_dist_(internal::random_gen);
+    CalcCorrelatorOutput<FloatType,Container,Math>(result, chip_errors, freq_errors, phase_errors, corr_period, cno);
+    AddNoise(result);
     return result;
   }
 
@@ -138,9 +462,8 @@ public:
   Simulate(const FloatType chip_error, const FloatType freq_error, const FloatType phase_error) const
   {
     std::complex<FloatType> result;
-    CalcCorrelatorOutput(result, chip_error, freq_error, phase_error, corr_period_, cn_ratio_);
-    result.real += normal_dist_(internal::random_gen);
-    result.imag += normal_dist_(internal::random_gen);
+    CalcCorrelatorOutput<FloatType,Math>(result, chip_error, freq_error, phase_error, corr_period_, cn_ratio_);
+    AddNoise(result);
     return result;
   }
 
@@ -149,9 +472,8 @@ public:
   Simulate(const Container& chip_errors, const Container& freq_errors, const Container& phase_errors) const
   {
     std::complex<FloatType> result;
-    CalcCorrelatorOutput<FloatType,Container>(result, chip_errors, freq_errors, phase_errors, corr_period_, cn_ratio_);
-    result.real += normal_dist_(internal::random_gen);
-    result.imag += normal_dist_(internal::random_gen);
+    CalcCorrelatorOutput<FloatType,Container,Math>(result, chip_errors, freq_errors, phase_errors, corr_period_, cn_ratio_);
+    AddNoise(result);
     return result;
   }
 
@@ -168,28 +490,56 @@ public:
   }
 
   template<bool Exists = StoreParams>
-  typename std::enable_if<Exists, void>::type GetPeriod() const
+  typename std::enable_if<Exists, FloatType>::type GetPeriod() const
   {
     return corr_period_;
   }
 
   template<bool Exists = StoreParams>
-  typename std::enable_if<Exists, void>::type GetCNO() const
+  typename std::enable_if<Exists, FloatType>::type GetCNO() const
   {
     return cn_ratio_;
   }
 
+  // Batched simulation over structure-of-arrays inputs, noise is drawn in bulk from a 64-bit generator
+  template<typename Generator>
+  void Simulate(std::complex<FloatType>* outputs, const FloatType* chip_errors, const FloatType* freq_errors,
+    const FloatType* phase_errors, const FloatType* corr_periods, const FloatType* cnos,
+    const std::size_t count, Generator& gen) const
+  {
+    CalcCorrelatorOutputs(outputs, chip_errors, freq_errors, phase_errors, corr_periods, cnos, count);
+    AddCorrelatorNoise(outputs, count, gen);
+  }
+
+  void Simulate(std::complex<FloatType>* outputs, const FloatType* chip_errors, const FloatType* freq_errors,
+    const FloatType* phase_errors, const FloatType* corr_periods, const FloatType* cnos,
+    const std::size_t count) const
+  {
+    Simulate(outputs, chip_errors, freq_errors, phase_errors, corr_periods, cnos, count, internal::random_gen);
+  }
+
+  template<bool Exists = StoreParams>
+  typename std::enable_if<Exists, void>::type
+  Simulate(std::complex<FloatType>* outputs, const FloatType* chip_errors, const FloatType* freq_errors,
+    const FloatType* phase_errors, const std::size_t count) const
+  {
+    std::vector<FloatType> periods(count, corr_period_);
+    std::vector<FloatType> cnos(count, cn_ratio_);
+    Simulate(outputs, chip_errors, freq_errors, phase_errors, periods.data(), cnos.data(), count);
+  }
+
   static void AddNoise(std::complex<FloatType>& output)
   {
-    output.real += normal_dist_(internal::random_gen);
-    output.imag += normal_dist_(internal::random_gen);
+    FloatType in_phase = normal_dist_(internal::random_gen);
+    output += std::complex<FloatType>(in_phase, normal_dist_(internal::random_gen));
   }
 
 private:
-  static std::normal_distribution<FloatType> normal_dist_;
+  static inline std::normal_distribution<FloatType> normal_dist_;
 
-  typename std::enable_if<StoreParams,FloatType>::type corr_period_;
-  typename std::enable_if<StoreParams,FloatType>::type cn_ratio_;
+  // only used when StoreParams is set
+  FloatType corr_period_ {0.0};
+  FloatType cn_ratio_ {0.0};
 };
 
 
@@ -0,0 +1,93 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_COVERAGE
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_COVERAGE
+
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "gps_ephemeris.hpp"
+
+namespace Gps
+{
+
+// Points x epochs, NaN where fewer than four satellites are above the mask
+struct DopMaps
+{
+  Eigen::MatrixXd gdop;
+  Eigen::MatrixXd pdop;
+  Eigen::MatrixXd hdop;
+  Eigen::MatrixXd vdop;
+  Eigen::Matrix<uint8_t,Eigen::Dynamic,Eigen::Dynamic> num_visible;
+};
+
+// Points x percentiles (nearest rank over epochs, epochs without a solution rank as +inf)
+struct DopSummary
+{
+  std::vector<double> percentiles; // in [0,100]
+  Eigen::MatrixXd gdop;
+  Eigen::MatrixXd pdop;
+  Eigen::MatrixXd hdop;
+  Eigen::MatrixXd vdop;
+  Eigen::VectorXd availability; // fraction of epochs with at least four satellites
+};
+
+
+// num_lat x num_lon points at a fixed altitude (inclusive ranges, radians), longitude varying fastest
+SoaVector3 LatLonGrid(const double lat_min, const double lat_max, const std::size_t num_lat,
+  const double lon_min, const double lon_max, const std::size_t num_lon, const double alt = 0.0);
+
+
+/*
+DOPs of a constellation over many points and epochs. Satellite positions are evaluated once per
+epoch (PreparedEphemeris::P). Points are processed in fixed blocks held in SoA form: for each
+satellite a vectorized pass over the block accumulates the ten distinct entries of the symmetric
+normal matrix, then the inverse terms needed for the DOPs (diagonal and the position block's
+off-diagonals, for VDOP in the local frame) are taken from closed-form cofactors in a second
+vectorized pass. No matrix library calls per point.
+
+Compute fills dense maps with epochs split across threads. Summarize keeps only percentiles per
+point; there each thread takes a block of points through every epoch so that the per-point
+distributions stay in a small buffer instead of a points x epochs array.
+*/
+class CoverageModel
+{
+public:
+  CoverageModel(const std::vector<Ephemeris>& ephemerides, const SoaVector3& points,
+    const double elevation_mask = 0.0, const unsigned int num_threads = 0);
+
+  void Compute(const std::vector<double>& gps_times, DopMaps& dops) const;
+  void Summarize(const std::vector<double>& gps_times, const std::vector<double>& percentiles,
+    DopSummary& summary) const;
+
+  std::size_t NumPoints() const { return num_points_; }
+  std::size_t NumSatellites() const { return orbits_.size(); }
+
+  static constexpr std::size_t BLOCK_SIZE = 64;
+
+private:
+  struct BlockDops
+  {
+    alignas(64) double gdop[BLOCK_SIZE];
+    alignas(64) double pdop[BLOCK_SIZE];
+    alignas(64) double hdop[BLOCK_SIZE];
+    alignas(64) double vdop[BLOCK_SIZE];
+    alignas(64) double num_visible[BLOCK_SIZE];
+  };
+
+  // satellite positions for every epoch, 3 x (satellites * epochs)
+  Eigen::Matrix3Xd SatellitePositions(const std::vector<double>& gps_times) const;
+  void ComputeBlock(const std::size_t block, const double* sat_pos, BlockDops& out) const;
+
+  std::vector<PreparedEphemeris> orbits_;
+  std::size_t num_points_;
+  double sin_mask_;
+  unsigned int num_threads_;
+
+  // padded to whole blocks by repeating the last point
+  SoaVector3 points_;
+  SoaVector3 up_;
+};
+
+} // namespace Gps
+#endif
@@ -1,11 +1,14 @@
 #ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_EPHEMERIS
 #define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_EPHEMERIS
 
+#include <array>
+#include <cmath>
 #include <random>
 
 #include <Eigen/Dense>
 
 #include "common_types.hpp"
+#include "gps_kepler.hpp"
 
 namespace Gps
 {
@@ -33,6 +36,28 @@ struct ClockData
 };
 
 
+// Klobuchar coefficients from subframe 4 page 18, in semicircle units as broadcast
+struct IonosphereData
+{
+  std::array<double,4> alpha {}; // seconds/semicircle^n
+  std::array<double,4> beta {}; // seconds/semicircle^n
+};
+
+
+// GPS to UTC conversion and leap second data from subframe 4 page 18
+struct UtcData
+{
+  double A_0 {0.0}; // seconds
+  double A_1 {0.0}; // seconds/sec
+  double t_ot {0.0}; // seconds
+  uint8_t WN_t {0}; // 8 LSBs of the week
+  int8_t del_t_LS {0}; // seconds
+  uint8_t WN_LSF {0};
+  uint8_t DN {0}; // days
+  int8_t del_t_LSF {0}; // seconds
+};
+
+
 struct Ephemeris
 {
   double M_0 {0.0};
@@ -55,8 +80,14 @@ struct Ephemeris
   double t_oe {0.0};
   uint8_t IODE {0};
   
-  inline double EfromAnomaly(const double M_k, const unsigned int iterations) const;
-  inline double EfromTime(const double gps_time, const unsigned int iterations) const;
+  // Fixed-cost Kepler solves, see SolveKepler for accuracy
+  double EfromAnomaly(const double M_k, const unsigned int iterations = KEPLER_ITERATIONS) const;
+  double EfromTime(const double gps_time, const unsigned int iterations = KEPLER_ITERATIONS) const;
+  void EfromTime(const double* gps_times, double* E, double* sin_E, double* cos_E, const std::size_t count) const;
+
+  // Time from ephemeris reference epoch, accounting for week crossover
+  double TimeFromEpoch(const double gps_time) const;
+  double MeanMotion() const;
 
   void P(const double gps_time, Eigen::Vector3d& pos) const;
   void PV(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d& vel) const;
@@ -66,6 +97,7 @@ struct Ephemeris
   double RelTime(const double gps_time) const;
   double RelTimeRate(const double gps_time) const;
   double RelTimeRateRate(const double gps_time) const;
+  void RelTime(const double* gps_times, double* rel_times, const std::size_t count) const;
 
   void Randomize();
 
@@ -82,115 +114,219 @@ struct Ephemeris
   
   template<bool CalcVel, bool CalcAccel>
   void CalcPVA(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d& vel,
-    Eigen::Vector3d& accel) const
+    Eigen::Vector3d& accel) const;
+};
+
+
+// N x 3 column-major: x, y and z are each contiguous
+using SoaVector3 = Eigen::Matrix<double,Eigen::Dynamic,3>;
+
+
+// Satellite position, velocity and acceleration (ECEF) with the relativistic clock correction
+// and its first two derivatives, all from one orbit evaluation
+struct OrbitState
+{
+  Eigen::Vector3d pos;
+  Eigen::Vector3d vel;
+  Eigen::Vector3d accel;
+  double rel_time = 0.0; // seconds
+  double rel_time_rate = 0.0;
+  double rel_time_rate_rate = 0.0; // 1/seconds
+};
+
+
+namespace internal
+{
+  // Scalar inputs of EvaluateOrbit: the broadcast elements it reads and the per-epoch constants
+  // derived from them. EphemerisSet keeps each field as an array and builds one per satellite.
+  struct OrbitConstants
   {
-    double A = std::pow(sqrtA,2.0);
-    
-    double n_0 = std::sqrt(WGS84_MU / std::pow(A,3.0));
-    double t_k = gps_time - t_oe;
-    if (t_k > 302400.0) {
-      t_k -= 604800.0;
-    } else if (t_k < -302400) {
-      t_k += 604800.0;
-    }
-    // std::cout << "t_k: " << t_k << '\n';
-    
-    double n = n_0 + del_n;
-    // std::cout << "n: " << n << '\n';
-    double M_k = M_0 + (n * t_k);
-    M_k = std::fmod(M_k + TwoPi<double>, TwoPi<double>);
-    // std::cout << "M: " << M_k << '\n';
-
-    double E_k = EfromAnomaly(M_k,5);
-    E_k = std::fmod(E_k + TwoPi<double>, TwoPi<double>);
-    // std::cout << "E_k: " << E_k << '\n';
-
-    // double v_k = std::sqrt((1.0+e)/(1.0-e)) * std::tan(E_k / 2.0);
-    // v_k = 2.0 * std::atan(v_k);
-    double cv_k = (std::cos(E_k) - e) / (1.0 - (e * std::cos(E_k)));
-    double sv_k = (std::sqrt(1.0 - (e*e)) * std::sin(E_k)) / (1.0 - (e * std::cos(E_k)));
-    double v_k = std::atan2(sv_k,cv_k);
-    // std::cout << "v_k: " << v_k << '\n';
-
-    double Phi_k = v_k + omega;
-    circular_fmod(Phi_k,TwoPi<double>);
-    // std::cout << "Phi_k: " << Phi_k << '\n';
-
-    double Phi2 = 2.0 * Phi_k;
-    double du_k = (C_us * std::sin(Phi2)) + (C_uc * std::cos(Phi2));
-    double dr_k = (C_rs * std::sin(Phi2)) + (C_rc * std::cos(Phi2));
-    double di_k = (C_is * std::sin(Phi2)) + (C_ic * std::cos(Phi2));
-    // std::cout << "du_k: " << du_k << '\n';
-    // std::cout << "dr_k: " << dr_k << '\n';
-    // std::cout << "di_k: " << di_k << '\n';
-    
-    double u_k = Phi_k + du_k;
-    double r_k = A * (1.0 - (e * std::cos(E_k))) + dr_k;
-    double i_k = i_0 + di_k + (IDOT * t_k);
-    // std::cout << "u_k: " << u_k << '\n';
-    // std::cout << "r_k: " << r_k << '\n';
-    // std::cout << "i_k: " << i_k << '\n';
-
-    double x_orb = r_k * std::cos(u_k);
-    double y_orb = r_k * std::sin(u_k);
-
-    double Omega_k = Omega_0 + ((Omega_dot - WGS84_EARTH_RATE) * t_k) - (WGS84_EARTH_RATE * t_oe);
-    circular_fmod(Omega_k, TwoPi<double>);
-    // std::cout << "Omega_k: " << Omega_k << '\n';
-
-    pos(0) = (x_orb * std::cos(Omega_k)) - (y_orb * std::cos(i_k) * std::sin(Omega_k));
-    pos(1) = (x_orb * std::sin(Omega_k)) + (y_orb * std::cos(i_k) * std::cos(Omega_k));
-    pos(2) = y_orb * std::sin(i_k);
-
-    // Velocity Terms
+    double t_oe = 0.0;
+    double M_0 = 0.0;
+    double e = 0.0;
+    double i_0 = 0.0;
+    double IDOT = 0.0;
+    double C_uc = 0.0;
+    double C_us = 0.0;
+    double C_rc = 0.0;
+    double C_rs = 0.0;
+    double C_ic = 0.0;
+    double C_is = 0.0;
+    double A = 0.0;
+    double n = 0.0; // corrected mean motion
+    double sqrt_1me2 = 1.0;
+    double sin_omega = 0.0;
+    double cos_omega = 1.0;
+    double Omega_ref = 0.0; // Omega_0 - earth rate * t_oe
+    double Omega_rate = 0.0; // Omega_dot - earth rate
+    double rel_scale = 0.0; // F e sqrt(A)
+  };
+
+  inline OrbitConstants PrepareOrbit(const Ephemeris& eph)
+  {
+    OrbitConstants orbit;
+    orbit.t_oe = eph.t_oe;
+    orbit.M_0 = eph.M_0;
+    orbit.e = eph.e;
+    orbit.i_0 = eph.i_0;
+    orbit.IDOT = eph.IDOT;
+    orbit.C_uc = eph.C_uc;
+    orbit.C_us = eph.C_us;
+    orbit.C_rc = eph.C_rc;
+    orbit.C_rs = eph.C_rs;
+    orbit.C_ic = eph.C_ic;
+    orbit.C_is = eph.C_is;
+    orbit.A = eph.sqrtA * eph.sqrtA;
+    orbit.n = std::sqrt(Ephemeris::WGS84_MU / (orbit.A * orbit.A * orbit.A)) + eph.del_n;
+    orbit.sqrt_1me2 = std::sqrt(1.0 - (eph.e * eph.e));
+    FastSinCos(eph.omega, orbit.sin_omega, orbit.cos_omega);
+    orbit.Omega_ref = eph.Omega_0 - (Ephemeris::WGS84_EARTH_RATE * eph.t_oe);
+    orbit.Omega_rate = eph.Omega_dot - Ephemeris::WGS84_EARTH_RATE;
+    orbit.rel_scale = Ephemeris::RELETIVISTIC_F * eph.e * eph.sqrtA;
+    return orbit;
+  }
+
+  // One orbit evaluation: the sin/cos of each angle once, E from SolveKepler, the argument of
+  // latitude by angle addition, inclination and node by FastSinCos
+  template<bool CalcVel, bool CalcAccel, bool CalcRel>
+  inline void EvaluateOrbit(const OrbitConstants& orbit, const double gps_time, OrbitState& state)
+  {
+    double t_k = gps_time - orbit.t_oe;
+    t_k -= (t_k > 302400.0) ? 604800.0 : 0.0;
+    t_k += (t_k < -302400.0) ? 604800.0 : 0.0;
+
+    double sin_E, cos_E;
+    SolveKepler(orbit.M_0 + (orbit.n * t_k), orbit.e, sin_E, cos_E);
+    double denom = 1.0 - (orbit.e * cos_E);
+    double inv_denom = 1.0 / denom;
+
+    double cos_v = (cos_E - orbit.e) * inv_denom;
+    double sin_v = orbit.sqrt_1me2 * sin_E * inv_denom;
+    double sin_Phi = (sin_v * orbit.cos_omega) + (cos_v * orbit.sin_omega);
+    double cos_Phi = (cos_v * orbit.cos_omega) - (sin_v * orbit.sin_omega);
+    double sin_2Phi = 2.0 * sin_Phi * cos_Phi;
+    double cos_2Phi = (cos_Phi * cos_Phi) - (sin_Phi * sin_Phi);
+
+    double du_k = (orbit.C_us * sin_2Phi) + (orbit.C_uc * cos_2Phi);
+    double dr_k = (orbit.C_rs * sin_2Phi) + (orbit.C_rc * cos_2Phi);
+    double di_k = (orbit.C_is * sin_2Phi) + (orbit.C_ic * cos_2Phi);
+
+    double sin_du, cos_du;
+    internal::SmallSinCos(du_k, sin_du, cos_du);
+    double sin_u = (sin_Phi * cos_du) + (cos_Phi * sin_du);
+    double cos_u = (cos_Phi * cos_du) - (sin_Phi * sin_du);
+    double r_k = (orbit.A * denom) + dr_k;
+    double sin_i, cos_i;
+    FastSinCos(orbit.i_0 + di_k + (orbit.IDOT * t_k), sin_i, cos_i);
+
+    double x_orb = r_k * cos_u;
+    double y_orb = r_k * sin_u;
+
+    double sin_O, cos_O;
+    FastSinCos(orbit.Omega_ref + (orbit.Omega_rate * t_k), sin_O, cos_O);
+
+    Eigen::Vector3d& pos = state.pos;
+    pos(0) = (x_orb * cos_O) - (y_orb * cos_i * sin_O);
+    pos(1) = (x_orb * sin_O) + (y_orb * cos_i * cos_O);
+    pos(2) = y_orb * sin_i;
+
+    double Ed_k = orbit.n * inv_denom;
     if constexpr (CalcVel) {
-      double Ed_k = n / (1.0 - (e * std::cos(E_k)));
-      double vd_k = Ed_k * std::sqrt(1.0 - (e*e)) / (1.0 - (e * std::cos(E_k)));
-      double id_k = IDOT + ( 2.0 * vd_k * ((C_is * std::cos(Phi2)) - (C_ic * std::sin(Phi2))) );
-      double ud_k = vd_k + ( 2.0 * vd_k * ((C_us * std::cos(Phi2)) - (C_uc * std::sin(Phi2))) );
-      double rd_k = (e * A * Ed_k * std::sin(E_k))
-                    + ( 2.0 * vd_k * ((C_rs * std::cos(Phi2)) - (C_rc * std::sin(Phi2))) );
-      double Omega_dot_k = Omega_dot - WGS84_EARTH_RATE;
-      
-      double xd_orb = (rd_k * std::cos(u_k)) - (r_k * ud_k * std::sin(u_k));
-      double yd_orb = (rd_k * std::sin(u_k)) + (r_k * ud_k * std::cos(u_k));
-      
-      vel(0) = (-x_orb * Omega_dot_k * std::sin(Omega_k))
-              + (xd_orb * std::cos(Omega_k))
-              - (yd_orb * std::sin(Omega_k) * std::cos(i_k))
-              - ( y_orb * ((Omega_dot_k * std::cos(Omega_k) * std::cos(i_k)) 
-                        - (id_k * std::sin(Omega_k * std::sin(i_k)))) ); 
-    
-      vel(1) = (x_orb * Omega_dot_k * std::cos(Omega_k))
-              + (xd_orb * std::sin(Omega_k))
-              + (yd_orb * std::cos(Omega_k) * std::cos(i_k))
-              - ( y_orb * ((Omega_dot_k * std::sin(Omega_k) * std::cos(i_k)) 
-                        + (id_k * std::cos(Omega_k) * std::sin(i_k))) ); 
-    
-      vel(2) = (yd_orb * std::sin(i_k)) + (y_orb * id_k * std::cos(i_k));
-      
+      double vd_k = Ed_k * orbit.sqrt_1me2 * inv_denom;
+      double id_k = orbit.IDOT + (2.0 * vd_k * ((orbit.C_is * cos_2Phi) - (orbit.C_ic * sin_2Phi)));
+      double ud_k = vd_k + (2.0 * vd_k * ((orbit.C_us * cos_2Phi) - (orbit.C_uc * sin_2Phi)));
+      double rd_k = (orbit.e * orbit.A * Ed_k * sin_E) + (2.0 * vd_k * ((orbit.C_rs * cos_2Phi) - (orbit.C_rc * sin_2Phi)));
+
+      double xd_orb = (rd_k * cos_u) - (r_k * ud_k * sin_u);
+      double yd_orb = (rd_k * sin_u) + (r_k * ud_k * cos_u);
+
+      Eigen::Vector3d& vel = state.vel;
+      vel(0) = (-x_orb * orbit.Omega_rate * sin_O) + (xd_orb * cos_O) - (yd_orb * sin_O * cos_i)
+             - (y_orb * ((orbit.Omega_rate * cos_O * cos_i) - (id_k * sin_O * sin_i)));
+      vel(1) = (x_orb * orbit.Omega_rate * cos_O) + (xd_orb * sin_O) + (yd_orb * cos_O * cos_i)
+             - (y_orb * ((orbit.Omega_rate * sin_O * cos_i) + (id_k * cos_O * sin_i)));
+      vel(2) = (yd_orb * sin_i) + (y_orb * id_k * cos_i);
     }
 
-    // Acceleration Terms
-    if constexpr (CalcAccel) {  
-      double r2 = r_k * r_k;
-      double r3 = r2 * r_k;
-      double F = -1.5 * J2 * (WGS84_MU / r2) * std::pow(WGS84_EQUAT_RADIUS / r_k, 2.0);
-      double F_term = F * ( 1.0 - (5.0 * std::pow(pos(2) / r_k, 2.0)) );  
-      double omega_e2 = std::pow(WGS84_EARTH_RATE, 2.0);
-
-      accel(0) = (-WGS84_MU * pos(0) / r3) + (F_term * pos(0) / r_k)
-                + (2.0 * vel(1) * WGS84_EARTH_RATE) + (pos(0) * omega_e2);
-    
-      accel(1) = (-WGS84_MU * pos(1) / r3) + (F_term * pos(1) / r_k)
-                - (2.0 * vel(0) * WGS84_EARTH_RATE) + (pos(1) * omega_e2);
-    
-      accel(2) = (-WGS84_MU * pos(2) / r3)
-                + ( F * (3.0 - (5.0 * std::pow(pos(2) / r_k, 2.0))) * pos(2) / r_k );  
+    if constexpr (CalcAccel) {
+      constexpr double mu = Ephemeris::WGS84_MU;
+      constexpr double omega_e = Ephemeris::WGS84_EARTH_RATE;
+      constexpr double re2 = Ephemeris::WGS84_EQUAT_RADIUS * Ephemeris::WGS84_EQUAT_RADIUS;
+      double inv_r = 1.0 / r_k;
+      double inv_r2 = inv_r * inv_r;
+      double mu_r3 = mu * inv_r2 * inv_r;
+      double F = -1.5 * Ephemeris::J2 * mu * inv_r2 * re2 * inv_r2;
+      double z_r2 = pos(2) * pos(2) * inv_r2;
+      double F_term = F * (1.0 - (5.0 * z_r2)) * inv_r;
+
+      const Eigen::Vector3d& vel = state.vel;
+      Eigen::Vector3d& accel = state.accel;
+      accel(0) = (-mu_r3 * pos(0)) + (F_term * pos(0)) + (2.0 * vel(1) * omega_e) + (pos(0) * omega_e * omega_e);
+      accel(1) = (-mu_r3 * pos(1)) + (F_term * pos(1)) - (2.0 * vel(0) * omega_e) + (pos(1) * omega_e * omega_e);
+      accel(2) = (-mu_r3 * pos(2)) + (F * (3.0 - (5.0 * z_r2)) * pos(2) * inv_r);
     }
+
+    // F e sqrt(A) sin(E) and its derivatives, with dE/dt = n / (1 - e cos(E))
+    if constexpr (CalcRel) {
+      state.rel_time = orbit.rel_scale * sin_E;
+      state.rel_time_rate = orbit.rel_scale * cos_E * Ed_k;
+      state.rel_time_rate_rate = -orbit.rel_scale * sin_E * Ed_k * Ed_k * inv_denom;
+    }
+  }
+}
+
+
+// Ephemeris with the derived per-epoch constants (A, n, sqrt(1-e^2), sin/cos omega, node terms)
+// computed once in Prepare rather than on every evaluation as Ephemeris::P/PV/PVA do.
+class PreparedEphemeris
+{
+public:
+  PreparedEphemeris() = default;
+  explicit PreparedEphemeris(const Ephemeris& ephemeris) { Prepare(ephemeris); }
+
+  // Must be called whenever the parameters change
+  void Prepare(const Ephemeris& ephemeris);
+  const Ephemeris& Parameters() const { return ephemeris_; }
+
+  void P(const double gps_time, Eigen::Vector3d& pos) const;
+  void PV(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d& vel) const;
+  void PVA(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d& vel, Eigen::Vector3d& accel) const;
+  void Evaluate(const double gps_time, OrbitState& state) const;
+  double RelTime(const double gps_time) const;
+
+  // Track at count times, vectorized over time (times need not be sorted). Outputs are resized.
+  void Trajectory(const double* gps_times, const std::size_t count, Eigen::Matrix3Xd& pos) const;
+  void Trajectory(const double* gps_times, const std::size_t count, Eigen::Matrix3Xd& pos,
+    Eigen::Matrix3Xd& vel) const;
+  void Trajectory(const double* gps_times, const std::size_t count, SoaVector3& pos) const;
+  void Trajectory(const double* gps_times, const std::size_t count, SoaVector3& pos, SoaVector3& vel) const;
+
+  template<bool CalcVel, bool CalcAccel, bool CalcRel>
+  void Evaluate(const double gps_time, OrbitState& state) const
+  {
+    internal::EvaluateOrbit<CalcVel,CalcAccel,CalcRel>(orbit_, gps_time, state);
   }
+
+private:
+  template<bool CalcVel>
+  void CalcTrajectory(const double* gps_times, const std::size_t count, SoaVector3& pos, SoaVector3& vel) const;
+
+  Ephemeris ephemeris_;
+  internal::OrbitConstants orbit_;
 };
 
+
+template<bool CalcVel, bool CalcAccel>
+void Ephemeris::CalcPVA(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d& vel,
+  Eigen::Vector3d& accel) const
+{
+  OrbitState state;
+  internal::EvaluateOrbit<CalcVel,CalcAccel,false>(internal::PrepareOrbit(*this), gps_time, state);
+  pos = state.pos;
+  if constexpr (CalcVel) vel = state.vel;
+  if constexpr (CalcAccel) accel = state.accel;
+}
+
 constexpr ClockData ClockDataScaleFactors =
 {
   std::pow(2.0,-31),
@@ -221,6 +357,20 @@ constexpr ClockData ClockDataUpperLimits =
   1023
 };
 
+constexpr IonosphereData IonosphereDataScaleFactors =
+{
+  {std::pow(2.0,-30), std::pow(2.0,-27), std::pow(2.0,-24), std::pow(2.0,-24)},
+  {std::pow(2.0,11), std::pow(2.0,14), std::pow(2.0,16), std::pow(2.0,16)}
+};
+
+constexpr UtcData UtcDataScaleFactors =
+{
+  std::pow(2.0,-30),
+  std::pow(2.0,-50),
+  std::pow(2.0,12),
+  1, 1, 1, 1, 1
+};
+
 constexpr Ephemeris EphemerisScaleFactors =
 {
   std::pow(2.0,-31),
@@ -0,0 +1,135 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_EPHEMERIS_SET
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_EPHEMERIS_SET
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "gps_ephemeris.hpp"
+
+namespace Gps
+{
+
+// Structure-of-arrays ephemerides evaluated for every satellite at once. Per-satellite constants
+// (A, n, sqrt(1-e^2), sin/cos omega, ...) are computed on insertion by internal::PrepareOrbit; the
+// per-time loop runs the branch-free internal::EvaluateOrbit kernel, so it is auto-vectorized.
+class EphemerisSet
+{
+public:
+  EphemerisSet() = default;
+  explicit EphemerisSet(const std::vector<Ephemeris>& ephemerides);
+
+  void Add(const Ephemeris& ephemeris);
+  void Set(const std::size_t index, const Ephemeris& ephemeris);
+  void Clear();
+  std::size_t Size() const { return t_oe_.size(); }
+
+  void P(const double gps_time, SoaVector3& pos) const;
+  void PV(const double gps_time, SoaVector3& pos, SoaVector3& vel) const;
+  void PVA(const double gps_time, SoaVector3& pos, SoaVector3& vel, SoaVector3& accel) const;
+
+  // Outputs are resized to Size() rows if needed, unused outputs are not touched
+  template<bool CalcVel, bool CalcAccel>
+  void CalcPVA(const double gps_time, SoaVector3& pos, SoaVector3& vel, SoaVector3& accel) const
+  {
+    static_assert(!CalcAccel || CalcVel, "the acceleration's Coriolis terms need the velocity");
+    const std::size_t count = Size();
+    pos.resize(count, 3);
+    if constexpr (CalcVel) vel.resize(count, 3);
+    if constexpr (CalcAccel) accel.resize(count, 3);
+
+    double* px = pos.col(0).data();
+    double* py = pos.col(1).data();
+    double* pz = pos.col(2).data();
+    double* vx = CalcVel ? vel.col(0).data() : nullptr;
+    double* vy = CalcVel ? vel.col(1).data() : nullptr;
+    double* vz = CalcVel ? vel.col(2).data() : nullptr;
+    double* ax = CalcAccel ? accel.col(0).data() : nullptr;
+    double* ay = CalcAccel ? accel.col(1).data() : nullptr;
+    double* az = CalcAccel ? accel.col(2).data() : nullptr;
+
+    const double* M_0 = M_0_.data();
+    const double* n = n_.data();
+    const double* e = e_.data();
+    const double* A = A_.data();
+    const double* sqrt_1me2 = sqrt_1me2_.data();
+    const double* sin_omega = sin_omega_.data();
+    const double* cos_omega = cos_omega_.data();
+    const double* Omega_ref = Omega_ref_.data();
+    const double* Omega_rate = Omega_rate_.data();
+    const double* i_0 = i_0_.data();
+    const double* IDOT = IDOT_.data();
+    const double* C_uc = C_uc_.data();
+    const double* C_us = C_us_.data();
+    const double* C_rc = C_rc_.data();
+    const double* C_rs = C_rs_.data();
+    const double* C_ic = C_ic_.data();
+    const double* C_is = C_is_.data();
+    const double* t_oe = t_oe_.data();
+
+    // outputs never alias the constants; too many arrays for GCC's runtime alias checks
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC ivdep
+#endif
+    for (std::size_t k = 0; k < count; k++) {
+      internal::OrbitConstants orbit;
+      orbit.t_oe = t_oe[k];
+      orbit.M_0 = M_0[k];
+      orbit.e = e[k];
+      orbit.i_0 = i_0[k];
+      orbit.IDOT = IDOT[k];
+      orbit.C_uc = C_uc[k];
+      orbit.C_us = C_us[k];
+      orbit.C_rc = C_rc[k];
+      orbit.C_rs = C_rs[k];
+      orbit.C_ic = C_ic[k];
+      orbit.C_is = C_is[k];
+      orbit.A = A[k];
+      orbit.n = n[k];
+      orbit.sqrt_1me2 = sqrt_1me2[k];
+      orbit.sin_omega = sin_omega[k];
+      orbit.cos_omega = cos_omega[k];
+      orbit.Omega_ref = Omega_ref[k];
+      orbit.Omega_rate = Omega_rate[k];
+
+      OrbitState state;
+      internal::EvaluateOrbit<CalcVel,CalcAccel,false>(orbit, gps_time, state);
+      px[k] = state.pos(0);
+      py[k] = state.pos(1);
+      pz[k] = state.pos(2);
+      if constexpr (CalcVel) {
+        vx[k] = state.vel(0);
+        vy[k] = state.vel(1);
+        vz[k] = state.vel(2);
+      }
+      if constexpr (CalcAccel) {
+        ax[k] = state.accel(0);
+        ay[k] = state.accel(1);
+        az[k] = state.accel(2);
+      }
+    }
+  }
+
+private:
+  std::vector<double> M_0_;
+  std::vector<double> n_; // corrected mean motion
+  std::vector<double> e_;
+  std::vector<double> A_;
+  std::vector<double> sqrt_1me2_;
+  std::vector<double> sin_omega_;
+  std::vector<double> cos_omega_;
+  std::vector<double> Omega_ref_; // Omega_0 - earth rate * t_oe
+  std::vector<double> Omega_rate_; // Omega_dot - earth rate
+  std::vector<double> i_0_;
+  std::vector<double> IDOT_;
+  std::vector<double> C_uc_;
+  std::vector<double> C_us_;
+  std::vector<double> C_rc_;
+  std::vector<double> C_rs_;
+  std::vector<double> C_ic_;
+  std::vector<double> C_is_;
+  std::vector<double> t_oe_;
+};
+
+} // namespace Gps
+#endif
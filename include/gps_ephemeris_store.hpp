@@ -0,0 +1,76 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_EPHEMERIS_STORE
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_EPHEMERIS_STORE
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "gps_ephemeris.hpp"
+
+namespace Gps
+{
+
+// One broadcast ephemeris/clock upload of a satellite
+struct NavigationSet
+{
+  uint8_t prn = 0;
+  uint16_t week = 0; // continuous GPS week of t_oe
+  Ephemeris ephemeris;
+  ClockData clock_data;
+  PreparedEphemeris orbit;
+  double fit_interval = 14400.0; // seconds, centered on t_oe
+
+  // Continuous GPS time of t_oe, orders sets across week rollovers
+  double Epoch() const { return (604800.0 * week) + ephemeris.t_oe; }
+};
+
+
+/*
+Ephemeris/clock sets of every PRN, several uploads each. Each PRN's sets are an immutable vector
+published through an atomic shared_ptr: writers copy, modify and swap under a writer-only mutex,
+readers only load the current pointer and never wait for a writer's copy and sort. The load is not
+lock-free with libstdc++ (the atomic shared_ptr guards its control block with a short internal
+lock), so a reader can still briefly contend with a concurrent swap. A selected set stays valid for
+as long as the caller holds the returned pointer, even if it is evicted meanwhile.
+
+For hot loops, select once per block (or hold Sets(prn)) rather than per sample.
+*/
+class EphemerisStore
+{
+public:
+  static constexpr uint8_t MAX_PRN = 32;
+
+  using SetList = std::vector<NavigationSet>;
+
+  explicit EphemerisStore(const std::size_t max_sets_per_prn = 4);
+
+  // Adds a set, evicting the oldest epoch (week and t_oe) beyond max_sets_per_prn. A set with the
+  // same IODE and epoch as a stored one replaces it. Returns false for an invalid PRN.
+  bool Insert(const uint8_t prn, const uint16_t week, const Ephemeris& ephemeris, const ClockData& clock_data,
+    const double fit_interval = 14400.0);
+  void Remove(const uint8_t prn);
+  void Clear();
+
+  // Set whose fit interval contains gps_time (seconds of week) with t_oe closest to it, nullptr if
+  // there is none. Distances wrap at the week, so the stored sets should span less than half a week.
+  std::shared_ptr<const NavigationSet> Select(const uint8_t prn, const double gps_time) const;
+
+  // Current snapshot of a PRN's sets, ordered by epoch, never nullptr
+  std::shared_ptr<const SetList> Sets(const uint8_t prn) const;
+
+  // Selects from a snapshot without touching the store
+  static const NavigationSet* Select(const SetList& sets, const double gps_time);
+
+private:
+  void Publish(const uint8_t prn, std::shared_ptr<const SetList> sets);
+
+  std::size_t max_sets_per_prn_;
+  std::array<std::atomic<std::shared_ptr<const SetList>>,MAX_PRN> sets_;
+  std::mutex writer_mutex_;
+};
+
+} // namespace Gps
+#endif
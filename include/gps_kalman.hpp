@@ -0,0 +1,110 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_KALMAN
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_KALMAN
+
+#include <cmath>
+#include <cstddef>
+
+#include <Eigen/Dense>
+
+namespace Gps
+{
+
+/*
+Extended Kalman filter on fixed-size Eigen types. The model (transition, measurement functions and
+their Jacobians) stays with the caller, which linearizes about State() and passes innovations
+(measured - predicted) with the Jacobian rows.
+
+Measurements are applied one scalar at a time, so R must be diagonal and no matrix is inverted.
+A block of MeasurementSize measurements linearized at the same state is equivalent to the joint
+update: each later innovation is corrected by the state change of the earlier ones. Measurements
+whose normalized innovation exceeds gate (in sigmas, 0 disables) are skipped.
+*/
+template<int StateSize>
+class KalmanFilter
+{
+public:
+  using StateVector = Eigen::Matrix<double,StateSize,1>;
+  using StateMatrix = Eigen::Matrix<double,StateSize,StateSize>;
+  using MeasurementRow = Eigen::Matrix<double,1,StateSize>;
+  template<int MeasurementSize>
+  using MeasurementVector = Eigen::Matrix<double,MeasurementSize,1>;
+  template<int MeasurementSize>
+  using MeasurementMatrix = Eigen::Matrix<double,MeasurementSize,StateSize>;
+
+  KalmanFilter() : state_(StateVector::Zero()), covariance_(StateMatrix::Identity()) {}
+
+  void Initialize(const StateVector& state, const StateMatrix& covariance)
+  {
+    state_ = state;
+    covariance_ = covariance;
+  }
+
+  // Linear transition x = F x
+  void Predict(const StateMatrix& transition, const StateMatrix& process_noise)
+  {
+    state_ = transition * state_;
+    PropagateCovariance(transition, process_noise);
+  }
+
+  // Nonlinear transition already applied by the caller, transition is its Jacobian
+  void Predict(const StateVector& predicted_state, const StateMatrix& transition, const StateMatrix& process_noise)
+  {
+    state_ = predicted_state;
+    PropagateCovariance(transition, process_noise);
+  }
+
+  // Returns false if the measurement was gated out
+  bool Update(const double innovation, const MeasurementRow& jacobian, const double variance, const double gate = 0.0)
+  {
+    StateVector cross = covariance_ * jacobian.transpose();
+    double innovation_variance = jacobian.dot(cross) + variance;
+    if ((gate > 0.0) && ((innovation * innovation) > (gate * gate * innovation_variance))) return false;
+    double inv_variance = 1.0 / innovation_variance;
+    state_.noalias() += (innovation * inv_variance) * cross;
+    covariance_.noalias() -= (inv_variance * cross) * cross.transpose();
+    return true;
+  }
+
+  // Returns the number of measurements applied
+  template<int MeasurementSize>
+  int Update(const MeasurementVector<MeasurementSize>& innovations, const MeasurementMatrix<MeasurementSize>& jacobian,
+    const MeasurementVector<MeasurementSize>& variances, const double gate = 0.0)
+  {
+    const StateVector prior = state_;
+    int applied = 0;
+    for (int i = 0; i < MeasurementSize; i++) {
+      double innovation = innovations(i) - jacobian.row(i).dot(state_ - prior);
+      applied += Update(innovation, jacobian.row(i), variances(i), gate);
+    }
+    Symmetrize();
+    return applied;
+  }
+
+  // Scalar updates leave round-off asymmetry, call after a group of them
+  void Symmetrize()
+  {
+    covariance_ = 0.5 * (covariance_ + covariance_.transpose()).eval();
+  }
+
+  const StateVector& State() const { return state_; }
+  const StateMatrix& Covariance() const { return covariance_; }
+  double Sigma(const int index) const { return std::sqrt(covariance_(index,index)); }
+
+  // Direct adjustment, e.g. resets after a clock jump
+  StateVector& MutableState() { return state_; }
+  StateMatrix& MutableCovariance() { return covariance_; }
+
+private:
+  void PropagateCovariance(const StateMatrix& transition, const StateMatrix& process_noise)
+  {
+    StateMatrix propagated = transition * covariance_;
+    covariance_.noalias() = propagated * transition.transpose();
+    covariance_ += process_noise;
+  }
+
+  StateVector state_;
+  StateMatrix covariance_;
+};
+
+} // namespace Gps
+#endif
@@ -1,6 +1,9 @@
 #ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_LNAV_DATA
 #define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_LNAV_DATA
 
+#include <istream>
+#include <ostream>
+
 #include "binary_ops.hpp"
 #include "gps_ephemeris.hpp"
 
@@ -150,6 +153,8 @@ public:
 
   void SetTOW(uint32_t tow) { tow_ = tow; }
   void SetWeek(uint16_t week) { week_ = week; }
+  void SetPage(uint8_t page) { page_ = page % 25; } // zero-indexed page of subframes 4 and 5
+  uint8_t Page() const { return page_; }
 
   // Loading data that has already been parity-wiped
   void LoadSubframe(uint8_t sf_i, Subframe& sf);
@@ -172,6 +177,8 @@ public:
 
   ClockData& ClockParams() { return clock_data_; }
   Ephemeris& Ephemerides() { return ephemeris_; }
+  IonosphereData& IonosphereParams() { return iono_data_; }
+  UtcData& UtcParams() { return utc_data_; }
 
   int8_t T_GD();
   uint16_t t_oc();
@@ -200,6 +207,10 @@ public:
 
   void Print(uint8_t sf) const { subframes_[sf].Print(); }
 
+  // Binary checkpoint of all parameters, subframe bits and the D29/D30 parity carry
+  void Save(std::ostream& os) const;
+  bool Load(std::istream& is);
+
 private:
   void Preamble(const uint8_t sf_i);
 
@@ -207,6 +218,8 @@ private:
   
   ClockData clock_data_;
   Ephemeris ephemeris_;
+  IonosphereData iono_data_;
+  UtcData utc_data_;
 
   uint16_t tlm_message_ {0};
 
@@ -0,0 +1,131 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_NAVIGATION
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_NAVIGATION
+
+#include <array>
+#include <cstddef>
+
+#include <Eigen/Dense>
+
+#include "gps_ephemeris.hpp"
+#include "gps_kalman.hpp"
+
+namespace Gps
+{
+
+constexpr std::size_t MAX_PVT_SATELLITES = 32;
+
+// Satellite position (ECEF at transmit time, Earth rotation is applied by the solver) and clock
+// correction, so that pseudorange + c * sat_clock = range + receiver clock bias. The rate terms
+// are only used by NavigationFilter, and only when rate_weight is nonzero.
+struct PvtMeasurement
+{
+  Eigen::Vector3d sat_pos = Eigen::Vector3d::Zero();
+  double sat_clock = 0.0; // seconds
+  double pseudorange = 0.0; // meters
+  double weight = 1.0; // 1 / variance
+  Eigen::Vector3d sat_vel = Eigen::Vector3d::Zero();
+  double sat_clock_rate = 0.0; // seconds/sec
+  double pseudorange_rate = 0.0; // meters/sec
+  double rate_weight = 0.0; // 1 / variance
+};
+
+// One epoch, fixed capacity so batches need no per-epoch allocation
+struct PvtEpoch
+{
+  std::array<PvtMeasurement,MAX_PVT_SATELLITES> measurements;
+  std::size_t count = 0;
+};
+
+struct PvtSolution
+{
+  Eigen::Vector3d pos = Eigen::Vector3d::Zero(); // ECEF, meters
+  double clock_bias = 0.0; // meters
+  double gdop = 0.0;
+  double pdop = 0.0;
+  double hdop = 0.0;
+  double vdop = 0.0;
+  double tdop = 0.0;
+  double residual_rms = 0.0; // meters, weighted
+  unsigned int iterations = 0;
+  std::size_t num_satellites = 0;
+  bool valid = false;
+};
+
+
+// Satellite state for a measured pseudorange: transmit time from the receive time and
+// pseudorange, clock as Offset - T_GD plus the relativistic correction
+void MakePvtMeasurement(const PreparedEphemeris& orbit, const ClockData& clock_data, const double receive_time,
+  const double pseudorange, PvtMeasurement& measurement);
+// Also fills the satellite velocity and clock rate for a measured pseudorange rate (rate_weight
+// is left for the caller)
+void MakePvtMeasurement(const PreparedEphemeris& orbit, const ClockData& clock_data, const double receive_time,
+  const double pseudorange, const double pseudorange_rate, PvtMeasurement& measurement);
+
+// Weighted Gauss-Newton on position and clock bias from initial (the Earth's center works for
+// GPS), with Sagnac rotation of each satellite by its light time. DOPs are from the unweighted
+// geometry, horizontal/vertical in the local frame of the solution. Returns solution.valid, which
+// requires four satellites and convergence to max_step within max_iterations.
+bool SolvePvt(const PvtMeasurement* measurements, const std::size_t count, PvtSolution& solution,
+  const Eigen::Vector4d& initial = Eigen::Vector4d::Zero(), const unsigned int max_iterations = 10,
+  const double max_step = 1e-4);
+bool SolvePvt(const PvtEpoch& epoch, PvtSolution& solution);
+
+// Independent epochs split across threads, solutions has one entry per epoch
+void SolvePvt(const PvtEpoch* epochs, const std::size_t count, PvtSolution* solutions,
+  const unsigned int num_threads = 0);
+
+
+struct NavigationFilterConfig
+{
+  double accel_psd = 1.0; // receiver acceleration, (m/s^2)^2/Hz per axis
+  double clock_bias_psd = 0.1; // m^2/s
+  double clock_drift_psd = 0.1; // (m/s)^2/s
+  double gate = 0.0; // innovation gate in sigmas, 0 disables
+};
+
+/*
+Filtered PVT on position, velocity, clock bias and clock drift (ECEF, meters, clock terms in
+meters and meters/sec) with a constant velocity model driven by white acceleration and clock
+noise. Pseudoranges, and pseudorange rates where rate_weight is set, are applied as sequential
+scalar updates with the same measurement model as SolvePvt (Sagnac rotation of the satellite by
+its light time). Updates take a few microseconds for a dozen satellites.
+*/
+class NavigationFilter
+{
+public:
+  static constexpr int STATE_SIZE = 8;
+  using Filter = KalmanFilter<STATE_SIZE>;
+
+  NavigationFilter(const NavigationFilterConfig& config = NavigationFilterConfig()) : config_(config) {}
+
+  void Initialize(const double gps_time, const Filter::StateVector& state, const Filter::StateMatrix& covariance);
+  // From a snapshot solution, velocity and drift start at zero
+  void Initialize(const double gps_time, const PvtSolution& solution, const double position_sigma = 10.0,
+    const double velocity_sigma = 10.0, const double clock_drift_sigma = 300.0);
+
+  void Predict(const double gps_time);
+  // Predicts to gps_time and applies the measurements, returns the number applied (not gated)
+  std::size_t Update(const double gps_time, const PvtMeasurement* measurements, const std::size_t count);
+  std::size_t Update(const double gps_time, const PvtEpoch& epoch);
+
+  double Time() const { return time_; }
+  Eigen::Vector3d Position() const { return filter_.State().head<3>(); }
+  Eigen::Vector3d Velocity() const { return filter_.State().segment<3>(3); }
+  double ClockBias() const { return filter_.State()(6); }
+  double ClockDrift() const { return filter_.State()(7); }
+  const Filter& Kalman() const { return filter_; }
+  const NavigationFilterConfig& Config() const { return config_; }
+
+private:
+  NavigationFilterConfig config_;
+  Filter filter_;
+  double time_ = 0.0;
+};
+
+// Monte Carlo style batch: filters[r] consumes epochs[(k * count) + r] at times[k] for each of
+// num_epochs steps, with receivers split across threads
+void UpdateNavigationFilters(NavigationFilter* filters, const std::size_t count, const double* times,
+  const PvtEpoch* epochs, const std::size_t num_epochs, const unsigned int num_threads = 0);
+
+} // namespace Gps
+#endif
@@ -0,0 +1,77 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_OBSERVABLES
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_OBSERVABLES
+
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "gps_ephemeris.hpp"
+
+namespace Gps
+{
+
+// Receivers x satellites, column-major so each satellite's column is contiguous
+struct ObservableBatch
+{
+  Eigen::MatrixXd pseudorange; // meters
+  Eigen::MatrixXd pseudorange_rate; // meters/sec
+  Eigen::MatrixXd pseudorange_accel; // meters/sec^2
+  Eigen::MatrixXd transmit_time; // satellite time of transmission, seconds of week
+};
+
+
+/*
+Pseudorange and its first two derivatives for many receivers and satellites at once, with light
+time, Earth rotation during the light time, satellite clock (ClockData::Offset - T_GD, L1 C/A) and
+the relativistic correction. Receiver clocks are not modeled.
+
+Satellite states (orbit to jerk, clock and relativistic term with their rates) are evaluated at a
+shared reference time and reused by every receiver and by later epochs within reference_interval.
+Each receiver expands them in time to its own transmit time, accurate to about 1e-5 m for
+intervals up to a second. Range rate includes the light-time factor 1 / (1 - u.w / c), the range
+acceleration does not. Per receiver, light time takes two fixed iterations and the Earth
+rotation is applied to second order in the (~1e-5 rad) angle, so the loop over receivers is
+branch-free and vectorized. Satellites are split across up to num_threads threads (0 uses all
+hardware threads), only when each thread gets at least MIN_PAIRS_PER_THREAD receiver-satellite
+pairs; a small epoch (24 x 4 takes a few microseconds) always runs on the calling thread.
+*/
+class ObservableModel
+{
+public:
+  ObservableModel(const std::vector<Ephemeris>& ephemerides, const std::vector<ClockData>& clock_data,
+    const double reference_interval = 1.0, const unsigned int num_threads = 1);
+
+  // about 150 us of work, several times the cost of starting a thread
+  static constexpr std::size_t MIN_PAIRS_PER_THREAD = 4096;
+
+  // Receiver states are Size() x 3 ECEF, outputs are resized to receivers x satellites
+  void Compute(const double gps_time, const SoaVector3& rx_pos, const SoaVector3& rx_vel,
+    const SoaVector3& rx_acc, ObservableBatch& obs);
+  void Compute(const double gps_time, const SoaVector3& rx_pos, ObservableBatch& obs); // static receivers
+
+  std::size_t NumSatellites() const { return orbits_.size(); }
+  const PreparedEphemeris& Orbit(const std::size_t sat) const { return orbits_[sat]; }
+  const ClockData& ClockParams(const std::size_t sat) const { return clock_data_[sat]; }
+
+private:
+  void Refresh(const double reference_time);
+  void ComputeSatellite(const std::size_t sat, const double gps_time, const SoaVector3& rx_pos,
+    const SoaVector3& rx_vel, const SoaVector3& rx_acc, ObservableBatch& obs) const;
+
+  std::vector<PreparedEphemeris> orbits_;
+  std::vector<ClockData> clock_data_;
+  double reference_interval_;
+  unsigned int num_threads_;
+
+  // satellite states at the reference time, clock terms in seconds (rel + Offset - T_GD)
+  bool has_reference_ = false;
+  double reference_time_ = 0.0;
+  std::vector<OrbitState> reference_states_;
+  std::vector<Eigen::Vector3d> jerk_;
+  std::vector<double> clock_;
+  std::vector<double> clock_rate_;
+  std::vector<double> clock_rate_rate_;
+};
+
+} // namespace Gps
+#endif
@@ -0,0 +1,120 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_ORBIT_INTERPOLATOR
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_ORBIT_INTERPOLATOR
+
+#include <array>
+#include <cstddef>
+
+#include <Eigen/Dense>
+
+#include "gps_ephemeris.hpp"
+
+namespace Gps
+{
+
+/*
+Chebyshev approximation of one satellite's position and clock correction over fixed windows of
+time from t_oe, for high-rate queries (per block or per sample). Windows are refit lazily when a
+query falls outside the current one, so results do not depend on the order of queries.
+
+The clock term is ClockData::Offset plus the relativistic correction (T_GD is not included).
+Each window is interpolated at Chebyshev nodes and the series converted to powers of the
+normalized time, which is well conditioned here as the coefficients fall off quickly. The converted
+polynomial is checked against the ephemeris midway between the nodes; the degree is raised until
+the position error is within tolerance, up to MAX_DEGREE. A window that does not reach the
+tolerance at MAX_DEGREE is kept at that degree with WithinTolerance() false. A query costs one
+Horner evaluation over x, y, z and clock together (degree multiply-adds per component); Positions
+evaluates blocks of times in one window with the degree fixed at compile time, so it is vectorized
+over time.
+
+Queries are not thread-safe since they may refit, use one interpolator per thread.
+*/
+class OrbitInterpolator
+{
+public:
+  static constexpr unsigned int MIN_DEGREE = 4;
+  static constexpr unsigned int MAX_DEGREE = 16;
+
+  OrbitInterpolator(const Ephemeris& ephemeris, const ClockData& clock_data, const double window = 300.0,
+    const double position_tolerance = 1e-4);
+
+  // Position (m, ECEF) and clock correction (s)
+  void Position(const double gps_time, Eigen::Vector3d& pos)
+  {
+    pos = Horner(coeffs_, degree_, Normalize(gps_time)).head<3>();
+  }
+
+  void Position(const double gps_time, Eigen::Vector3d& pos, double& clock)
+  {
+    Eigen::Array4d state = Horner(coeffs_, degree_, Normalize(gps_time));
+    pos = state.head<3>();
+    clock = state(3);
+  }
+
+  double Clock(const double gps_time) { return Horner(coeffs_, degree_, Normalize(gps_time))(3); }
+
+  void PositionVelocity(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d& vel);
+
+  // Dense queries, outputs hold count values (pos is 3 x count)
+  void Positions(const double* gps_times, const std::size_t count, Eigen::Matrix3Xd& pos, double* clock = nullptr);
+
+  // Degree and checked errors of the current window, max norm in m and max abs in s
+  unsigned int Degree() const { return degree_; }
+  bool WithinTolerance() const { return position_error_ <= position_tolerance_; }
+  double PositionFitError() const { return position_error_; }
+  double ClockFitError() const { return clock_error_; }
+  double Window() const { return window_; }
+  const PreparedEphemeris& Orbit() const { return orbit_; }
+
+private:
+  static constexpr std::size_t BLOCK_SIZE = 64; // times per vectorized pass in Positions
+  using Coefficients = std::array<Eigen::Array4d,MAX_DEGREE + 1>; // [k] = {x, y, z, clock} of x^k or T_k(x)
+
+  // Normalized time in [-1,1] within the current window, refitting if needed
+  double Normalize(const double gps_time)
+  {
+    double t_k = gps_time - t_oe_;
+    t_k -= (t_k > 302400.0) ? 604800.0 : 0.0;
+    t_k += (t_k < -302400.0) ? 604800.0 : 0.0;
+    if (!(t_k >= window_start_ && t_k < window_start_ + window_)) {
+      Fit(t_k);
+    }
+    return ((t_k - window_start_) * inv_half_window_) - 1.0;
+  }
+
+  // sum_k c_k x^k for the 4 components
+  static Eigen::Array4d Horner(const Coefficients& coeffs, const unsigned int degree, const double x)
+  {
+    Eigen::Array4d sum = coeffs[degree];
+    for (unsigned int k = degree; k > 0; k--) {
+      sum = (sum * x) + coeffs[k - 1];
+    }
+    return sum;
+  }
+
+  // Horner sums at BLOCK_SIZE normalized times of the current window, dispatched on degree_
+  template<unsigned int Degree>
+  void EvaluateBlock(const double* x, double* pos, double* clock) const;
+  // one Normalize and Horner per time, pos is 3 x count
+  void PositionsSingle(const double* gps_times, const std::size_t count, double* pos, double* clock);
+
+  void Fit(const double t_k);
+  void FitDegree(const double* node_states, const unsigned int degree);
+  void TrueState(const double t_k, double* state) const;
+
+  PreparedEphemeris orbit_;
+  ClockData clock_data_;
+  double t_oe_;
+  double window_;
+  double inv_half_window_;
+  double position_tolerance_;
+
+  double window_start_; // seconds from t_oe
+  unsigned int degree_ = MAX_DEGREE;
+  double position_error_ = 0.0;
+  double clock_error_ = 0.0;
+  Coefficients coeffs_ {}; // powers of the normalized time
+  Coefficients deriv_coeffs_ {}; // of d/dt, 1/s
+};
+
+} // namespace Gps
+#endif
@@ -0,0 +1,48 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_RINEX
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_RINEX
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gps_ephemeris.hpp"
+
+namespace Gps
+{
+
+// One GPS broadcast record. Angles are in radians as used by the orbit model (RINEX units), not
+// the semicircles of the LNAV encoding.
+struct NavigationRecord
+{
+  uint8_t prn = 0;
+  uint16_t week = 0; // continuous GPS week of t_oe
+  Ephemeris ephemeris;
+  ClockData clock_data;
+  double fit_interval = 14400.0; // seconds
+  double transmit_time = 0.0; // seconds of week
+  double accuracy = 0.0; // meters
+  uint8_t health = 0;
+};
+
+
+/*
+RINEX 2.x and 3.x navigation files (GPS-only or mixed, non-GPS records are skipped). The file is
+memory-mapped and split at record boundaries into chunks parsed in parallel; records keep file
+order. Numbers are parsed in place from the fixed-width fields (Fortran D exponents accepted,
+blank fields read as zero) without allocating.
+
+Returns false if the file cannot be read or the header is not a navigation header, records are
+appended otherwise. Records with unparseable epochs are skipped.
+*/
+bool ReadRinexNavigation(const std::string& path, std::vector<NavigationRecord>& records,
+  const unsigned int num_threads = 0);
+
+// Same, on a file already in memory
+bool ParseRinexNavigation(const char* data, const std::size_t size, std::vector<NavigationRecord>& records,
+  const unsigned int num_threads = 0);
+
+// Fixed-width RINEX number in [begin,end), true if it parsed (a blank field parses as zero)
+bool ParseRinexNumber(const char* begin, const char* end, double& value);
+
+} // namespace Gps
+#endif
@@ -0,0 +1,86 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_SIGNAL_DYNAMICS
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_SIGNAL_DYNAMICS
+
+#include <functional>
+
+#include <Eigen/Dense>
+
+#include "gps_common.hpp"
+#include "gps_ephemeris.hpp"
+
+namespace Gps
+{
+
+// Receiver position, velocity and acceleration (ECEF) at a GPS time
+using ReceiverTrajectory = std::function<void(const double gps_time, Eigen::Vector3d& pos,
+  Eigen::Vector3d& vel, Eigen::Vector3d& acc)>;
+
+ReceiverTrajectory StaticReceiver(const Eigen::Vector3d& pos);
+
+
+struct SignalObservables
+{
+  double pseudorange = 0.0; // meters
+  double pseudorange_rate = 0.0; // meters/sec
+  double pseudorange_accel = 0.0; // meters/sec^2
+  double transmit_time = 0.0; // satellite time of transmission, seconds of week
+  double elevation = 0.0; // radians
+  double ionosphere_delay = 0.0; // meters, included in pseudorange
+  double troposphere_delay = 0.0; // meters, included in pseudorange
+};
+
+
+// Code and carrier phase of one satellite over one block, as quadratics in time since block start.
+// The generator re-syncs code phase to transmit_time every block so that it cannot drift. The
+// carrier phase is only used to (re)initialize a signal, otherwise the frequency terms are
+// integrated so that the carrier is continuous between blocks.
+struct PhasePolynomial
+{
+  double transmit_time = 0.0; // seconds of week, defines code phase and data indices
+  double code_frequency = CA_RATE; // chips/sec
+  double code_frequency_rate = 0.0; // chips/sec^2
+  double carrier_phase = 0.0; // radians
+  double carrier_frequency = 0.0; // Hz, intermediate + doppler
+  double carrier_frequency_rate = 0.0; // Hz/sec
+  bool visible = false;
+};
+
+
+class SatelliteDynamics
+{
+public:
+  SatelliteDynamics(const Ephemeris& ephemeris, const ClockData& clock_data,
+    const double elevation_mask = 0.0);
+
+  // One orbit evaluation; light time and Earth rotation are handled with the returned
+  // satellite velocity and acceleration rather than re-evaluating the orbit
+  void Observe(const double gps_time, const Eigen::Vector3d& rx_pos, const Eigen::Vector3d& rx_vel,
+    const Eigen::Vector3d& rx_acc, SignalObservables& obs) const;
+
+  // Returns visibility (elevation above the mask)
+  bool Block(const double gps_time, const Eigen::Vector3d& rx_pos, const Eigen::Vector3d& rx_vel,
+    const Eigen::Vector3d& rx_acc, const double intermediate_frequency, PhasePolynomial& poly) const;
+
+  const Ephemeris& Ephemerides() const { return ephemeris_; }
+  const ClockData& ClockParams() const { return clock_data_; }
+  double ElevationMask() const { return elevation_mask_; }
+  void SetElevationMask(const double mask) { elevation_mask_ = mask; }
+
+  // Optional atmospheric delays (see gps_atmosphere.hpp), off by default. They are evaluated once per
+  // Observe call and held over a block: their rates (cm/s) are not added to the frequencies.
+  void SetIonosphere(const IonosphereData& iono) { iono_ = iono; use_ionosphere_ = true; }
+  void ClearIonosphere() { use_ionosphere_ = false; }
+  void SetTroposphere(const bool enabled) { use_troposphere_ = enabled; }
+
+private:
+  Ephemeris ephemeris_;
+  ClockData clock_data_;
+  double elevation_mask_; // radians
+  IonosphereData iono_;
+  bool use_ionosphere_ = false;
+  bool use_troposphere_ = false;
+};
+
+
+} // namespace Gps
+#endif
@@ -3,9 +3,13 @@
 
 #include <array>
 #include <vector>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
 
 #include "gps_common.hpp"
 #include "gps_lnav_data.hpp"
+#include "gps_signal_dynamics.hpp"
 
 
 namespace Gps {
@@ -21,6 +25,21 @@ struct State
   RealType code_frequency = CA_RATE;
   RealType carrier_frequency = 0.0; // intermediate + doppler
   RealType carrier_phase = 0.0; // radians
+  RealType code_frequency_rate = 0.0; // chips/sec^2
+  RealType carrier_frequency_rate = 0.0; // Hz/sec
+  bool visible = false;
+};
+
+
+// Delayed, scaled copy of a satellite's signal (multipath reflection or the direct path itself),
+// optionally seen by several antenna elements with an extra phase per element
+template<typename RealType = double>
+struct SignalTap
+{
+  RealType delay = 0.0; // seconds relative to the signal state, [0, 1 ms)
+  RealType amplitude = 1.0; // relative to the generator amplitude
+  RealType phase = 0.0; // radians, includes the carrier phase shift due to the delay
+  std::vector<RealType> steering_phases; // radians per antenna element, empty if all zero
 };
 
 
@@ -37,6 +56,10 @@ public:
   bool Information(const uint8_t subframe_i, const uint16_t bit_i, const uint16_t chip_i);
 
   void Initialize(uint8_t first_subframe);
+
+  // Binary checkpoint of the frame and the parity-encoded subframe buffers
+  void Save(std::ostream& os) const;
+  bool Load(std::istream& is);
 private:
   uint8_t GetSubframeIndex(const uint8_t subframe_num);
 
@@ -53,7 +76,7 @@ private:
 
 
 // function that takes two-buffer set of subframes
-//! this function assumes constant carrier frequency and code frequency
+//! this function assumes constant carrier frequency and code frequency, see GenSignalsWithDynamics
 template<typename QuantizedType, typename RealType = double>
 bool GenSignalWithData(
               uint8_t& subframe,    // 0-4
@@ -211,6 +234,527 @@ std::vector<bool> GenBasebandSignalsWithData(
 }
 
 
+namespace internal
+{
+  // Returns true when the data bit changes
+  inline bool IncrementCodeCycle(uint8_t& subframe, uint16_t& bit, uint8_t& code_cycle)
+  {
+    code_cycle++;
+    if (code_cycle < 20) {
+      return false;
+    }
+    code_cycle = 0;
+    bit++;
+    if (bit == 300) {
+      bit = 0;
+      subframe++;
+      if (subframe == 5) {
+        subframe = 0;
+      }
+    }
+    return true;
+  }
+
+  // Q15 sine over one cycle, cosine is read a quarter cycle ahead
+  constexpr uint8_t SINE_TABLE_BITS = 10;
+  constexpr uint32_t SINE_TABLE_SIZE = 1 << SINE_TABLE_BITS;
+  extern const std::array<int16_t,SINE_TABLE_SIZE> sine_table;
+
+  // Code NCO is Q42 chips: a chip count below 1023 stays under 2^52, so it converts to and from
+  // double exactly, and the step resolution (2^-42 chips/sample) keeps code phase error far below
+  // a sample over long calls. Carrier NCO wraps at 2^32 per cycle.
+  constexpr uint8_t CODE_NCO_BITS = 42;
+  constexpr double CODE_NCO_SCALE = 4398046511104.0;
+  constexpr uint64_t FIXED_CODE_LENGTH = static_cast<uint64_t>(1023) << CODE_NCO_BITS;
+  constexpr double NCO_SCALE = 4294967296.0;
+
+  template<typename RealType>
+  inline uint32_t ToCarrierNco(const RealType cycles)
+  {
+    return static_cast<uint32_t>(static_cast<int64_t>(std::llround(cycles * NCO_SCALE)));
+  }
+
+  // Complex oscillator by recurrence: a table of the first ROTATOR_BLOCK phasors is rotated by
+  // one block step per block, so the per-sample work is a table multiply that vectorizes.
+  constexpr std::size_t ROTATOR_BLOCK = 64;
+
+  template<typename RealType>
+  class BlockRotator
+  {
+  public:
+    BlockRotator(const RealType phase_step, const RealType start_phase)
+      : block_step_{std::polar(RealType(1.0), phase_step * static_cast<RealType>(ROTATOR_BLOCK))},
+        current_{std::polar(RealType(1.0), start_phase)}
+    {
+      for (std::size_t k = 0; k < ROTATOR_BLOCK; k++) {
+        table_real_[k] = std::cos(phase_step * static_cast<RealType>(k));
+        table_imag_[k] = std::sin(phase_step * static_cast<RealType>(k));
+      }
+    }
+
+    // Writes the next count (<= ROTATOR_BLOCK) phasors
+    void Next(RealType* real, RealType* imag, const std::size_t count)
+    {
+      const RealType cr = current_.real();
+      const RealType ci = current_.imag();
+      for (std::size_t k = 0; k < count; k++) {
+        real[k] = (cr * table_real_[k]) - (ci * table_imag_[k]);
+        imag[k] = (cr * table_imag_[k]) + (ci * table_real_[k]);
+      }
+      current_ *= block_step_;
+      current_ /= std::abs(current_);
+    }
+
+  private:
+    std::array<RealType,ROTATOR_BLOCK> table_real_;
+    std::array<RealType,ROTATOR_BLOCK> table_imag_;
+    std::complex<RealType> block_step_;
+    std::complex<RealType> current_;
+  };
+
+  template<typename QuantizedType>
+  inline QuantizedType Saturate(const int32_t value)
+  {
+    constexpr int32_t lower = std::numeric_limits<QuantizedType>::min();
+    constexpr int32_t upper = std::numeric_limits<QuantizedType>::max();
+    return static_cast<QuantizedType>(std::clamp(value, lower, upper));
+  }
+}
+
+
+// Sets code phase and data indices from the satellite time of transmission.
+// Assumes the satellite's frame is aligned such that subframe 0 starts on a 30 second boundary.
+template<typename RealType = double>
+void SetStateFromTransmitTime(State<RealType>& signal_state, const double transmit_time)
+{
+  double t = circular_fmod2(transmit_time, 30.0);
+  double subframe_time = std::fmod(t, 6.0);
+  double bit_time = std::fmod(subframe_time, DATA_BIT_PERIOD);
+  signal_state.subframe = std::min(static_cast<int>(t / 6.0), 4);
+  signal_state.bit = std::min(static_cast<int>(subframe_time / DATA_BIT_PERIOD), 299);
+  signal_state.code_cycle = std::min(static_cast<int>(bit_time * 1000.0), 19);
+  signal_state.chip = std::fmod(std::fmod(bit_time, 1.0e-3) * CA_RATE, 1023.0);
+}
+
+template<typename RealType = double>
+void ApplyPhasePolynomial(State<RealType>& signal_state, const PhasePolynomial& poly)
+{
+  signal_state.code_frequency = poly.code_frequency;
+  signal_state.code_frequency_rate = poly.code_frequency_rate;
+  signal_state.carrier_frequency = poly.carrier_frequency;
+  signal_state.carrier_frequency_rate = poly.carrier_frequency_rate;
+}
+
+
+// Adds one satellite to sample_array, with code and carrier phase quadratic in time.
+// Phases are integrated with second differences so no polynomial is evaluated per sample.
+template<typename RealType = double>
+void AccumulateSignalWithData(
+              State<RealType>& signal_state,
+              SatelliteInfo& sat_info,
+              std::complex<RealType>* sample_array,
+              const std::size_t array_size,
+              const RealType sample_frequency,
+              const RealType amplitude)
+{
+  assert(signal_state.subframe < 5);
+  assert(signal_state.bit < 300);
+  assert(signal_state.code_cycle < 20);
+
+  RealType T = 1.0 / sample_frequency;
+  RealType chip_step_rate = signal_state.code_frequency_rate * T * T;
+  RealType chip_step = (signal_state.code_frequency * T) + (0.5 * chip_step_rate);
+  RealType phase_step_rate = TwoPi<RealType> * signal_state.carrier_frequency_rate * T * T;
+  RealType phase_step = (TwoPi<RealType> * signal_state.carrier_frequency * T) + (0.5 * phase_step_rate);
+
+  RealType chip = signal_state.chip;
+  RealType phase = signal_state.carrier_phase;
+  bool nav_data = sat_info.GetMessageBit(signal_state.subframe, signal_state.bit);
+  for (std::size_t i = 0; i < array_size; i++) {
+    RealType value = (sat_info.Code(static_cast<uint16_t>(chip)) ^ nav_data) ? amplitude : -amplitude;
+    sample_array[i] += std::polar(value, phase);
+
+    chip += chip_step;
+    chip_step += chip_step_rate;
+    phase += phase_step;
+    phase_step += phase_step_rate;
+    if (phase >= TwoPi<RealType>) phase -= TwoPi<RealType>;
+    else if (phase < 0.0) phase += TwoPi<RealType>;
+
+    if (chip >= 1023.0) {
+      chip -= 1023.0;
+      if (internal::IncrementCodeCycle(signal_state.subframe, signal_state.bit, signal_state.code_cycle)) {
+        nav_data = sat_info.GetMessageBit(signal_state.subframe, signal_state.bit);
+      }
+    }
+  }
+
+  signal_state.chip = chip;
+  signal_state.carrier_phase = circular_fmod2(phase, TwoPi<RealType>);
+  signal_state.code_frequency = (chip_step - (0.5 * chip_step_rate)) * sample_frequency;
+  signal_state.carrier_frequency = (phase_step - (0.5 * phase_step_rate)) * sample_frequency / TwoPi<RealType>;
+}
+
+
+// Integer version of AccumulateSignalWithData for constant code and carrier frequency; the
+// frequency rates must be zero (their per-sample step change is far below one NCO LSB, use the
+// floating path for dynamics). State is converted to NCO words on entry and back on exit;
+// both conversions are exact, so consecutive calls continue the same integer phase sequence.
+template<typename RealType = double>
+void AccumulateSignalWithDataFixed(
+              State<RealType>& signal_state,
+              SatelliteInfo& sat_info,
+              int32_t* in_phase,
+              int32_t* quadrature,
+              const std::size_t array_size,
+              const RealType sample_frequency,
+              const int16_t amplitude)
+{
+  assert(signal_state.subframe < 5);
+  assert(signal_state.bit < 300);
+  assert(signal_state.code_cycle < 20);
+  assert((signal_state.code_frequency_rate == 0.0) && (signal_state.carrier_frequency_rate == 0.0));
+
+  using internal::sine_table;
+  constexpr uint8_t index_shift = 32 - internal::SINE_TABLE_BITS;
+  constexpr uint32_t index_mask = internal::SINE_TABLE_SIZE - 1;
+  constexpr uint32_t quarter_cycle = internal::SINE_TABLE_SIZE / 4;
+  constexpr uint32_t index_rounding = 1u << (index_shift - 1);
+  constexpr int32_t product_rounding = 1 << 14;
+
+  uint64_t chip = static_cast<uint64_t>(std::llround(signal_state.chip * internal::CODE_NCO_SCALE));
+  const uint64_t chip_step = static_cast<uint64_t>(
+    std::llround(signal_state.code_frequency / sample_frequency * internal::CODE_NCO_SCALE));
+  uint32_t phase = internal::ToCarrierNco(signal_state.carrier_phase / TwoPi<RealType>);
+  const uint32_t phase_step = internal::ToCarrierNco(signal_state.carrier_frequency / sample_frequency);
+
+  bool nav_data = sat_info.GetMessageBit(signal_state.subframe, signal_state.bit);
+  for (std::size_t i = 0; i < array_size; i++) {
+    int32_t value = (sat_info.Code(static_cast<uint16_t>(chip >> internal::CODE_NCO_BITS)) ^ nav_data)
+                  ? amplitude : -amplitude;
+    // nearest table entry and rounded products, so neither error is biased
+    uint32_t index = (phase + index_rounding) >> index_shift;
+    in_phase[i] += ((value * sine_table[(index + quarter_cycle) & index_mask]) + product_rounding) >> 15;
+    quadrature[i] += ((value * sine_table[index & index_mask]) + product_rounding) >> 15;
+
+    phase += phase_step;
+    chip += chip_step;
+    if (chip >= internal::FIXED_CODE_LENGTH) {
+      chip -= internal::FIXED_CODE_LENGTH;
+      if (internal::IncrementCodeCycle(signal_state.subframe, signal_state.bit, signal_state.code_cycle)) {
+        nav_data = sat_info.GetMessageBit(signal_state.subframe, signal_state.bit);
+      }
+    }
+  }
+
+  signal_state.chip = static_cast<RealType>(chip) / internal::CODE_NCO_SCALE;
+  signal_state.carrier_phase = TwoPi<RealType> * static_cast<RealType>(phase) / internal::NCO_SCALE;
+}
+
+
+// Sum of all satellites with carrier, constant code and carrier frequency over the call.
+// FixedPoint selects integer NCOs, a Q15 sine table and int32 accumulation across satellites,
+// writing sc16/sc8 directly with saturation. QuantizedType must then be an integer type and the
+// states' frequency rates zero.
+template<typename QuantizedType, typename RealType = double, bool FixedPoint = false>
+void GenSignalsWithData(
+              std::vector<State<RealType>>& signal_states,
+              std::vector<SatelliteInfo>& sat_info,
+              std::complex<QuantizedType>* sample_array,
+              const std::size_t array_size,
+              const RealType sample_frequency,
+              const RealType amplitude)
+{
+  assert(signal_states.size() == sat_info.size());
+
+  if constexpr (FixedPoint) {
+    static_assert(std::is_integral_v<QuantizedType>, "fixed-point generation requires integer samples");
+    assert(std::abs(amplitude) <= std::numeric_limits<int16_t>::max());
+
+    std::vector<int32_t> in_phase(array_size, 0);
+    std::vector<int32_t> quadrature(array_size, 0);
+    int16_t fixed_amplitude = static_cast<int16_t>(std::lround(amplitude));
+    for (std::size_t i = 0; i < signal_states.size(); i++) {
+      AccumulateSignalWithDataFixed(signal_states[i], sat_info[i], in_phase.data(), quadrature.data(),
+        array_size, sample_frequency, fixed_amplitude);
+    }
+    for (std::size_t k = 0; k < array_size; k++) {
+      sample_array[k] = std::complex<QuantizedType>(internal::Saturate<QuantizedType>(in_phase[k]),
+                                                    internal::Saturate<QuantizedType>(quadrature[k]));
+    }
+  }
+  else {
+    std::vector<std::complex<RealType>> samples(array_size, std::complex<RealType>(0.0));
+    for (std::size_t i = 0; i < signal_states.size(); i++) {
+      AccumulateSignalWithData(signal_states[i], sat_info[i], samples.data(), array_size,
+        sample_frequency, amplitude);
+    }
+    for (std::size_t k = 0; k < array_size; k++) {
+      sample_array[k] = static_cast<std::complex<QuantizedType>>(samples[k]);
+    }
+  }
+}
+
+
+// Sum of all satellites as real samples at an intermediate frequency, with constant code and
+// carrier frequency over the call (the states' frequency rates must be zero). Each satellite's
+// Doppler (carrier_frequency minus IF) is applied at complex baseband with a recurrence oscillator
+// and the sum is mixed up once.
+// At IF = fs/4 the mixing sequence is {1,j,-1,-j}, so no oscillator is needed for the IF at all.
+template<typename QuantizedType, typename RealType = double>
+void GenRealSignalsWithData(
+              std::vector<State<RealType>>& signal_states,
+              std::vector<SatelliteInfo>& sat_info,
+              QuantizedType* sample_array,
+              const std::size_t array_size,
+              const RealType sample_frequency,
+              const RealType intermediate_frequency,
+              const RealType amplitude)
+{
+  assert(signal_states.size() == sat_info.size());
+  using internal::ROTATOR_BLOCK;
+
+  std::vector<RealType> real(array_size, 0.0);
+  std::vector<RealType> imag(array_size, 0.0);
+  std::vector<RealType> signs(array_size);
+  std::array<RealType,ROTATOR_BLOCK> rot_real, rot_imag;
+  const RealType duration = static_cast<RealType>(array_size) / sample_frequency;
+
+  for (std::size_t i = 0; i < signal_states.size(); i++) {
+    State<RealType>& state = signal_states[i];
+    assert(state.subframe < 5);
+    assert(state.bit < 300);
+    assert(state.code_cycle < 20);
+    assert((state.code_frequency_rate == 0.0) && (state.carrier_frequency_rate == 0.0));
+
+    // Code and data, with the same step as AccumulateSignalWithData so chip edges fall on the same samples
+    RealType chip_step = state.code_frequency * (1.0 / sample_frequency);
+    RealType chip = state.chip;
+    bool nav_data = sat_info[i].GetMessageBit(state.subframe, state.bit);
+    for (std::size_t k = 0; k < array_size; k++) {
+      signs[k] = (sat_info[i].Code(static_cast<uint16_t>(chip)) ^ nav_data) ? amplitude : -amplitude;
+      chip += chip_step;
+      if (chip >= 1023.0) {
+        chip -= 1023.0;
+        if (internal::IncrementCodeCycle(state.subframe, state.bit, state.code_cycle)) {
+          nav_data = sat_info[i].GetMessageBit(state.subframe, state.bit);
+        }
+      }
+    }
+    state.chip = chip;
+
+    // Doppler at baseband, starting from the full carrier phase so the IF mix needs no phase offset
+    RealType doppler = state.carrier_frequency - intermediate_frequency;
+    internal::BlockRotator<RealType> rotator(TwoPi<RealType> * doppler / sample_frequency, state.carrier_phase);
+    for (std::size_t start = 0; start < array_size; start += ROTATOR_BLOCK) {
+      std::size_t count = std::min(ROTATOR_BLOCK, array_size - start);
+      rotator.Next(rot_real.data(), rot_imag.data(), count);
+      for (std::size_t k = 0; k < count; k++) {
+        real[start + k] += signs[start + k] * rot_real[k];
+        imag[start + k] += signs[start + k] * rot_imag[k];
+      }
+    }
+    state.carrier_phase = circular_fmod2(state.carrier_phase
+                          + (TwoPi<RealType> * state.carrier_frequency * duration), TwoPi<RealType>);
+  }
+
+  // Mix to IF, keeping the real part
+  if (std::abs((4.0 * intermediate_frequency) - sample_frequency) < 1.0e-9 * sample_frequency) {
+    const std::size_t tail = array_size & 3;
+    const std::size_t body = array_size - tail;
+    for (std::size_t k = 0; k < body; k += 4) {
+      sample_array[k]     = static_cast<QuantizedType>(real[k]);
+      sample_array[k + 1] = static_cast<QuantizedType>(-imag[k + 1]);
+      sample_array[k + 2] = static_cast<QuantizedType>(-real[k + 2]);
+      sample_array[k + 3] = static_cast<QuantizedType>(imag[k + 3]);
+    }
+    // 0 to 3 remaining samples continue the same sequence
+    if (tail > 0) sample_array[body] = static_cast<QuantizedType>(real[body]);
+    if (tail > 1) sample_array[body + 1] = static_cast<QuantizedType>(-imag[body + 1]);
+    if (tail > 2) sample_array[body + 2] = static_cast<QuantizedType>(-real[body + 2]);
+  }
+  else {
+    internal::BlockRotator<RealType> mixer(TwoPi<RealType> * intermediate_frequency / sample_frequency, 0.0);
+    for (std::size_t start = 0; start < array_size; start += ROTATOR_BLOCK) {
+      std::size_t count = std::min(ROTATOR_BLOCK, array_size - start);
+      mixer.Next(rot_real.data(), rot_imag.data(), count);
+      for (std::size_t k = 0; k < count; k++) {
+        sample_array[start + k] = static_cast<QuantizedType>(
+          (real[start + k] * rot_real[k]) - (imag[start + k] * rot_imag[k]));
+      }
+    }
+  }
+}
+
+
+// Renders every tap of every satellite into num_elements outputs in one pass, with constant code
+// and carrier frequency over the call (the states' frequency rates must be zero).
+// Code, data and carrier are computed once per sample for the undelayed signal; each tap only
+// costs a code lookup at its delayed chip and a complex multiply-add per element.
+// A delayed tap that reaches back into the previous data bit uses that bit. With zero frequency
+// rates, a single zero-delay tap of unit amplitude on one element reproduces GenSignalsWithData:
+// the same states, and the same samples up to FMA contraction of the carrier product.
+template<typename QuantizedType, typename RealType = double>
+void GenSignalsWithTaps(
+              std::vector<State<RealType>>& signal_states,
+              std::vector<SatelliteInfo>& sat_info,
+              const std::vector<std::vector<SignalTap<RealType>>>& taps,
+              std::complex<QuantizedType>* const* sample_arrays,
+              const std::size_t num_elements,
+              const std::size_t array_size,
+              const RealType sample_frequency,
+              const RealType amplitude)
+{
+  assert(signal_states.size() == sat_info.size());
+  assert(signal_states.size() == taps.size());
+  assert(num_elements > 0);
+
+  std::vector<std::vector<std::complex<RealType>>> outputs(num_elements,
+    std::vector<std::complex<RealType>>(array_size, std::complex<RealType>(0.0)));
+  std::vector<std::complex<RealType>> tap_phasors;
+  std::vector<RealType> tap_delays;
+  std::vector<std::complex<RealType>> element_sums(num_elements);
+
+  for (std::size_t i = 0; i < signal_states.size(); i++) {
+    State<RealType>& state = signal_states[i];
+    const std::vector<SignalTap<RealType>>& sat_taps = taps[i];
+    const std::size_t num_taps = sat_taps.size();
+    if (num_taps == 0) continue;
+    assert(state.subframe < 5);
+    assert(state.bit < 300);
+    assert(state.code_cycle < 20);
+    assert((state.code_frequency_rate == 0.0) && (state.carrier_frequency_rate == 0.0));
+
+    // tap_phasors[t * num_elements + e]
+    tap_phasors.resize(num_taps * num_elements);
+    tap_delays.resize(num_taps);
+    for (std::size_t t = 0; t < num_taps; t++) {
+      assert((sat_taps[t].delay >= 0.0) && (sat_taps[t].delay < 1.0e-3));
+      assert(sat_taps[t].steering_phases.empty() || (sat_taps[t].steering_phases.size() == num_elements));
+      tap_delays[t] = sat_taps[t].delay * state.code_frequency;
+      for (std::size_t e = 0; e < num_elements; e++) {
+        RealType steering = sat_taps[t].steering_phases.empty() ? 0.0 : sat_taps[t].steering_phases[e];
+        tap_phasors[(t * num_elements) + e] = std::polar(amplitude * sat_taps[t].amplitude,
+                                                         sat_taps[t].phase + steering);
+      }
+    }
+
+    // same steps as AccumulateSignalWithData
+    RealType T = 1.0 / sample_frequency;
+    RealType chip_step = state.code_frequency * T;
+    RealType phase_step = TwoPi<RealType> * state.carrier_frequency * T;
+    RealType chip = state.chip;
+    RealType phase = state.carrier_phase;
+    bool nav_data = sat_info[i].GetMessageBit(state.subframe, state.bit);
+    // the last bit of every subframe is zero (word 10 bits 23-24 are solved for D29 = D30 = 0),
+    // so the previous subframe need not be buffered
+    bool prev_nav_data = (state.bit > 0) ? sat_info[i].GetMessageBit(state.subframe, state.bit - 1) : false;
+
+    for (std::size_t k = 0; k < array_size; k++) {
+      std::fill(element_sums.begin(), element_sums.end(), std::complex<RealType>(0.0));
+      for (std::size_t t = 0; t < num_taps; t++) {
+        RealType tap_chip = chip - tap_delays[t];
+        bool tap_data = nav_data;
+        if (tap_chip < 0.0) {
+          tap_chip += 1023.0;
+          if (state.code_cycle == 0) tap_data = prev_nav_data;
+        }
+        RealType sign = (sat_info[i].Code(static_cast<uint16_t>(tap_chip)) ^ tap_data) ? 1.0 : -1.0;
+        const std::complex<RealType>* phasors = &tap_phasors[t * num_elements];
+        for (std::size_t e = 0; e < num_elements; e++) {
+          element_sums[e] += sign * phasors[e];
+        }
+      }
+
+      std::complex<RealType> carrier = std::polar(RealType(1.0), phase);
+      for (std::size_t e = 0; e < num_elements; e++) {
+        outputs[e][k] += carrier * element_sums[e];
+      }
+
+      chip += chip_step;
+      phase += phase_step;
+      if (phase >= TwoPi<RealType>) phase -= TwoPi<RealType>;
+      else if (phase < 0.0) phase += TwoPi<RealType>;
+      if (chip >= 1023.0) {
+        chip -= 1023.0;
+        if (internal::IncrementCodeCycle(state.subframe, state.bit, state.code_cycle)) {
+          prev_nav_data = nav_data;
+          nav_data = sat_info[i].GetMessageBit(state.subframe, state.bit);
+        }
+      }
+    }
+    state.chip = chip;
+    state.carrier_phase = circular_fmod2(phase, TwoPi<RealType>);
+  }
+
+  for (std::size_t e = 0; e < num_elements; e++) {
+    for (std::size_t k = 0; k < array_size; k++) {
+      sample_arrays[e][k] = static_cast<std::complex<QuantizedType>>(outputs[e][k]);
+    }
+  }
+}
+
+
+// Generates the sum of all visible satellites, with code and carrier dynamics from the orbit,
+// satellite clock and receiver trajectory. The orbit is evaluated once per block of block_size
+// samples (1 ms is a reasonable choice). Code phase and data indices are set from the transmit
+// time at every block, the carrier phase only when a satellite rises; satellites that set are
+// skipped.
+// gps_time is the receive time of the first sample and is advanced past the last sample.
+template<typename QuantizedType, typename RealType = double>
+void GenSignalsWithDynamics(
+              std::vector<State<RealType>>& signal_states,
+              std::vector<SatelliteInfo>& sat_info,
+              const std::vector<SatelliteDynamics>& dynamics,
+              const ReceiverTrajectory& receiver,
+              double& gps_time,
+              std::complex<QuantizedType>* sample_array,
+              const std::size_t array_size,
+              const RealType sample_frequency,
+              const RealType intermediate_frequency,
+              const RealType amplitude,
+              const std::size_t block_size)
+{
+  assert(signal_states.size() == sat_info.size());
+  assert(signal_states.size() == dynamics.size());
+  assert(block_size > 0);
+
+  std::vector<std::complex<RealType>> block(block_size);
+  Eigen::Vector3d rx_pos, rx_vel, rx_acc;
+  PhasePolynomial poly;
+
+  // block times are computed from the sample index, accumulating them drifts by ~1e-11 s per block
+  const double start_time = gps_time;
+  for (std::size_t start = 0; start < array_size; start += block_size) {
+    std::size_t block_samples = std::min(block_size, array_size - start);
+    std::fill(block.begin(), block.begin() + block_samples, std::complex<RealType>(0.0));
+    double block_time = start_time + (static_cast<double>(start) / sample_frequency);
+    receiver(block_time, rx_pos, rx_vel, rx_acc);
+
+    for (std::size_t i = 0; i < signal_states.size(); i++) {
+      if (!dynamics[i].Block(block_time, rx_pos, rx_vel, rx_acc, intermediate_frequency, poly)) {
+        signal_states[i].visible = false;
+        continue;
+      }
+      SetStateFromTransmitTime(signal_states[i], poly.transmit_time);
+      if (!signal_states[i].visible) {
+        signal_states[i].carrier_phase = poly.carrier_phase;
+        signal_states[i].visible = true;
+        sat_info[i].Initialize(signal_states[i].subframe);
+      }
+      ApplyPhasePolynomial(signal_states[i], poly);
+      AccumulateSignalWithData(signal_states[i], sat_info[i], block.data(), block_samples,
+        sample_frequency, amplitude);
+    }
+
+    for (std::size_t k = 0; k < block_samples; k++) {
+      sample_array[start + k] = static_cast<std::complex<QuantizedType>>(block[k]);
+    }
+  }
+  gps_time = start_time + (static_cast<double>(array_size) / sample_frequency);
+}
+
+
 } // namespace Lnav
 } // namespace Gps
 
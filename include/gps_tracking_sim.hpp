@@ -0,0 +1,102 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_TRACKING_SIM
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_TRACKING_SIM
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "gps_common.hpp"
+
+namespace Gps
+{
+
+enum class DllDiscriminator
+{
+  EarlyMinusLatePower, // normalized noncoherent power
+  EarlyMinusLateEnvelope, // normalized noncoherent envelope
+  DotProduct // quasi-coherent, normalized by prompt power
+};
+
+enum class PllDiscriminator
+{
+  Costas, // atan(Q/I), insensitive to data bits
+  Atan2 // four-quadrant, pilot/dataless signals only
+};
+
+// Kaplan-style loop filter, bandwidth in Hz (noise bandwidth), order 1 to 3
+struct LoopFilterConfig
+{
+  uint8_t order = 2;
+  double bandwidth = 0.0;
+};
+
+struct TrackingLoopConfig
+{
+  double integration_time = 0.001; // seconds
+  double early_late_spacing = 1.0; // chips between early and late taps
+  LoopFilterConfig dll {1, 1.0}; // order 1 or 2
+  LoopFilterConfig pll {3, 15.0}; // order 1 to 3
+  LoopFilterConfig fll {2, 0.0}; // order 1 or 2, assists the PLL, disabled when bandwidth is 0
+  DllDiscriminator dll_discriminator = DllDiscriminator::EarlyMinusLateEnvelope;
+  PllDiscriminator pll_discriminator = PllDiscriminator::Costas;
+  bool carrier_aiding = true; // drive the code NCO with the scaled carrier frequency
+
+  // Lock is declared lost the first epoch either bound is exceeded
+  double max_chip_error = 0.75; // chips
+  double max_frequency_error = 50.0; // Hz
+};
+
+// Truth line-of-sight range as a cubic in time, plus the loop's initial errors (truth - estimate)
+struct TruthProfile
+{
+  double duration = 1.0; // seconds
+  double cno = 45.0; // dB-Hz
+  double range_rate = 0.0; // meters/sec
+  double range_accel = 0.0; // meters/sec^2
+  double range_jerk = 0.0; // meters/sec^3
+  double initial_chip_error = 0.0; // chips
+  double initial_frequency_error = 0.0; // Hz
+  double initial_phase_error = 0.0; // cycles
+};
+
+struct TrialResult
+{
+  double sum_sq_chip_error = 0.0;
+  double sum_sq_phase_error = 0.0;
+  double sum_sq_frequency_error = 0.0;
+  std::size_t epochs = 0; // epochs spent in lock
+  bool lost_lock = false;
+  double loss_of_lock_time = 0.0; // seconds, only meaningful if lost_lock
+};
+
+struct TrackingStatistics
+{
+  std::size_t num_trials = 0;
+  std::size_t num_lost = 0;
+  double rms_chip_error = 0.0; // chips, over in-lock epochs of all trials
+  double rms_phase_error = 0.0; // cycles, wrapped to the discriminator's ambiguity
+  double rms_frequency_error = 0.0; // Hz
+  double mean_loss_of_lock_time = 0.0; // seconds, mean over trials that lost lock
+  double lock_probability = 1.0; // fraction of trials that held lock for the full duration
+};
+
+
+// A single closed-loop run, correlator outputs (early, prompt, late) are simulated at the loop's
+// mid-interval errors from the truth profile
+TrialResult RunTrackingTrial(const TrackingLoopConfig& config, const TruthProfile& truth,
+  std::mt19937_64& gen);
+
+TrackingStatistics SummarizeTrials(const TrialResult* trials, const std::size_t count);
+
+// Runs independent trials across num_threads threads (0 uses all hardware threads). Trial i draws
+// from its own engine seeded by (seed, i), so results do not depend on the thread count.
+TrackingStatistics RunTrackingMonteCarlo(const TrackingLoopConfig& config, const TruthProfile& truth,
+  const std::size_t num_trials, const uint64_t seed, const unsigned int num_threads = 0);
+
+// Monte Carlo over every configuration, parallel over all (configuration, trial) pairs
+std::vector<TrackingStatistics> RunTrackingSweep(const std::vector<TrackingLoopConfig>& configs,
+  const TruthProfile& truth, const std::size_t num_trials, const uint64_t seed,
+  const unsigned int num_threads = 0);
+
+} // namespace Gps
+#endif
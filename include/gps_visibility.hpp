@@ -0,0 +1,41 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_GPS_VISIBILITY
+#define SATELLITE_CONSTELLATIONS_INCLUDE_GPS_VISIBILITY
+
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "gps_ephemeris_set.hpp"
+
+namespace Gps
+{
+
+struct SatellitePass
+{
+  uint16_t satellite = 0; // index into the ephemeris set
+  double rise_time = 0.0; // clipped to the span
+  double set_time = 0.0;
+  double peak_time = 0.0;
+  double peak_elevation = 0.0; // radians
+  double peak_azimuth = 0.0; // radians, clockwise from north
+};
+
+
+/*
+Passes above elevation_mask of every satellite over [start_time, end_time] for each static ECEF
+receiver, ordered by rise time.
+
+Satellite positions and velocities are evaluated once for all receivers on a grid of coarse_step
+seconds and interpolated between grid points with cubic Hermite polynomials (sub-mm at 60 s).
+Each receiver scans the grid for mask crossings, refines them by regula falsi to 1 ms and finds
+the peak by golden-section search, or at the span edge for passes clipped to it. Passes that rise
+and set between two grid points are missed, so coarse_step should stay well below the shortest pass
+of interest. Receivers are split across num_threads threads (0 uses all hardware threads).
+*/
+std::vector<std::vector<SatellitePass>> PredictPasses(const EphemerisSet& satellites,
+  const std::vector<Eigen::Vector3d>& receivers, const double start_time, const double end_time,
+  const double elevation_mask = 0.0, const double coarse_step = 60.0, const unsigned int num_threads = 0);
+
+} // namespace Gps
+#endif
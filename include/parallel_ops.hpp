@@ -0,0 +1,65 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_PARALLEL_OPS
+#define SATELLITE_CONSTELLATIONS_INCLUDE_PARALLEL_OPS
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+
+inline unsigned int ResolveThreadCount(const unsigned int num_threads)
+{
+  if (num_threads > 0) return num_threads;
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Thread count for work items of similar cost: at most num_threads (0 uses all hardware threads),
+// and only as many as give each thread min_work items. ParallelFor starts its threads on every
+// call (tens of microseconds each), so engines called per epoch stay serial for small batches.
+inline unsigned int ThreadsForWork(const unsigned int num_threads, const std::size_t work,
+  const std::size_t min_work)
+{
+  return static_cast<unsigned int>(std::clamp<std::size_t>(work / min_work, 1, ResolveThreadCount(num_threads)));
+}
+
+// Calls func(i) for every i in [0,count) from num_threads threads (0 uses all hardware threads).
+// Indices are handed out in small chunks from a shared counter so uneven work balances out.
+// func must be safe to call concurrently for different indices.
+template<typename Function>
+void ParallelFor(const std::size_t count, Function&& func, const unsigned int num_threads = 0)
+{
+  unsigned int threads = static_cast<unsigned int>(
+    std::min<std::size_t>(ResolveThreadCount(num_threads), count));
+  if (threads <= 1) {
+    for (std::size_t i = 0; i < count; i++) {
+      func(i);
+    }
+    return;
+  }
+
+  const std::size_t chunk = std::max<std::size_t>(1, count / (static_cast<std::size_t>(threads) * 16));
+  std::atomic<std::size_t> next {0};
+  auto worker = [&]()
+  {
+    std::size_t start;
+    while ((start = next.fetch_add(chunk)) < count) {
+      std::size_t end = std::min(start + chunk, count);
+      for (std::size_t i = start; i < end; i++) {
+        func(i);
+      }
+    }
+  };
+
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (unsigned int t = 1; t < threads; t++) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : pool) {
+    thread.join();
+  }
+}
+
+#endif
@@ -0,0 +1,180 @@
+#ifndef SATELLITE_CONSTELLATIONS_INCLUDE_VECTOR_MATH
+#define SATELLITE_CONSTELLATIONS_INCLUDE_VECTOR_MATH
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <type_traits>
+
+/*
+Branch-free elementary functions. Written so that loops calling them are auto-vectorized
+(no libm calls, no data-dependent branches), unlike std::sin/std::cos for double.
+*/
+
+namespace internal
+{
+  template<typename T>
+  using RoundingBits = std::conditional_t<sizeof(T) == 8, uint64_t, uint32_t>;
+
+  // 1.5 * 2^(mantissa bits): adding it rounds to an integer held in the low mantissa bits
+  template<typename T>
+  constexpr T ROUNDING_MAGIC = (sizeof(T) == 8) ? T(6755399441055744.0) : T(12582912.0);
+}
+
+// Round to nearest integer for |x| < 2^51 (2^22 for float). std::round/std::floor are not
+// vectorized by GCC unless trapping math is disabled. Must not be compiled with -ffast-math.
+template<typename T>
+inline T FastRound(const T x)
+{
+  return (x + internal::ROUNDING_MAGIC<T>) - internal::ROUNDING_MAGIC<T>;
+}
+
+/*
+Branch-free selects. GCC jump-threads std::clamp and std::max against constants into branches, and
+at the SSE2 baseline it does not if-convert a select between computed values (the mask of a double
+comparison is not vectorized as 64-bit integers). Weights of 0 and 1 from copysign keep such loops
+vectorizable. Limited results are the limit exactly when x is within a factor of two of it (the
+difference is exact), within an ulp of it otherwise. Arguments must be finite.
+*/
+
+// 1 for x >= +0, 0 for x < 0 (and for -0)
+template<typename T>
+inline T StepWeight(const T x)
+{
+  return T(0.5) + (T(0.5) * std::copysign(T(1.0), x));
+}
+
+// x if x >= lo, otherwise lo
+template<typename T>
+inline T FastMax(const T x, const T lo)
+{
+  return x + (StepWeight(lo - x) * (lo - x));
+}
+
+// x if x <= hi, otherwise hi
+template<typename T>
+inline T FastMin(const T x, const T hi)
+{
+  return x - (StepWeight(x - hi) * (x - hi));
+}
+
+// x limited to [lo,hi]
+template<typename T>
+inline T FastClamp(const T x, const T lo, const T hi)
+{
+  return FastMin(FastMax(x, lo), hi);
+}
+
+// Sine and cosine with quadrant reduction and Cephes minimax polynomials on [-pi/4,pi/4].
+// Error is within a few ulp of std::sin/std::cos for |x| < 1e6.
+template<typename T>
+inline void FastSinCos(const T x, T& sin_x, T& cos_x)
+{
+  constexpr T two_over_pi = 0.636619772367581343076;
+  constexpr T pio2_1 = 1.57079632673412561417e+00;
+  constexpr T pio2_2 = 6.07710050630396597660e-11;
+  constexpr T pio2_3 = 2.02226624879595063154e-21;
+
+  // quadrant from the low bits of the rounded multiple of pi/2
+  T shifted = (x * two_over_pi) + internal::ROUNDING_MAGIC<T>;
+  T k = shifted - internal::ROUNDING_MAGIC<T>;
+  internal::RoundingBits<T> quadrant = std::bit_cast<internal::RoundingBits<T>>(shifted);
+  T r = ((x - (k * pio2_1)) - (k * pio2_2)) - (k * pio2_3);
+
+  T z = r * r;
+  T s = T(1.58962301576546568060e-10);
+  s = (s * z) - T(2.50507477628578072866e-8);
+  s = (s * z) + T(2.75573136213857245213e-6);
+  s = (s * z) - T(1.98412698295895385996e-4);
+  s = (s * z) + T(8.33333333332211858878e-3);
+  s = (s * z) - T(1.66666666666666307295e-1);
+  s = r + (r * z * s);
+
+  T c = T(-1.13585365213876817300e-11);
+  c = (c * z) + T(2.08757008419747316778e-9);
+  c = (c * z) - T(2.75573141792967388112e-7);
+  c = (c * z) + T(2.48015872888517045348e-5);
+  c = (c * z) - T(1.38888888888730564116e-3);
+  c = (c * z) + T(4.16666666666665929218e-2);
+  c = T(1.0) - (T(0.5) * z) + (z * z * c);
+
+  // odd quadrants swap sin and cos, bit 1 of quadrant (of quadrant + 1 for cos) flips the sign;
+  // done as bit masks rather than selects (see the branch-free selects above)
+  using Bits = internal::RoundingBits<T>;
+  constexpr int sign_shift = (8 * sizeof(T)) - 2;
+  Bits swap = Bits(0) - (quadrant & 1);
+  Bits s_bits = std::bit_cast<Bits>(s);
+  Bits c_bits = std::bit_cast<Bits>(c);
+  sin_x = std::bit_cast<T>(((s_bits & ~swap) | (c_bits & swap)) ^ ((quadrant & 2) << sign_shift));
+  cos_x = std::bit_cast<T>(((c_bits & ~swap) | (s_bits & swap)) ^ (((quadrant + 1) & 2) << sign_shift));
+}
+
+// sin(x)/x, equal to 1 at x = 0
+template<typename T>
+inline T FastSinc(const T x)
+{
+  T s, c;
+  FastSinCos(x, s, c);
+  // at x = 0, s = 0: divide by 1 and add 1 (constant selects if-convert, selects of results do not)
+  bool is_zero = (x == T(0.0));
+  return (s / (x + (is_zero ? T(1.0) : T(0.0)))) + (is_zero ? T(1.0) : T(0.0));
+}
+
+// Natural log for positive normal x, fdlibm polynomial (< 1 ulp in double).
+// Evaluated in double for any T.
+template<typename T>
+inline T FastLog(const T x)
+{
+  constexpr double sqrt2 = 1.41421356237309504880;
+  constexpr double ln2 = 0.693147180559945309417;
+  constexpr double two52 = 4503599627370496.0;
+
+  uint64_t bits = std::bit_cast<uint64_t>(static_cast<double>(x));
+  // exponent field converted to double without an integer-to-float instruction
+  double exponent = std::bit_cast<double>((bits >> 52) | 0x4330000000000000ull) - two52 - 1023.0;
+  double m = std::bit_cast<double>((bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull); // [1,2)
+  // 1 above sqrt(2), 0 below (m == sqrt2 takes either branch correctly)
+  double high = StepWeight(m - sqrt2);
+  m *= 1.0 - (0.5 * high);
+  exponent += high;
+
+  double f = m - 1.0;
+  double s = f / (2.0 + f);
+  double z = s * s;
+  double w = z * z;
+  double t1 = w * (3.999999999940941908e-01 + (w * (2.222219843214978396e-01 + (w * 1.531383769920937332e-01))));
+  double t2 = z * (6.666666666666735130e-01 + (w * (2.857142874366239149e-01
+            + (w * (1.818357216161805012e-01 + (w * 1.479819860511658591e-01))))));
+  double R = t1 + t2;
+  double hfsq = 0.5 * f * f;
+  return static_cast<T>((exponent * ln2) + (f - (hfsq - (s * (hfsq + R)))));
+}
+
+// Arcsine on [-1,1], Abramowitz and Stegun 4.4.46 (error below 2e-8 rad)
+template<typename T>
+inline T FastAsin(const T x)
+{
+  T a = std::abs(x);
+  T p = T(-0.0012624911);
+  p = (p * a) + T(0.0066700901);
+  p = (p * a) - T(0.0170881256);
+  p = (p * a) + T(0.0308918810);
+  p = (p * a) - T(0.0501743046);
+  p = (p * a) + T(0.0889789874);
+  p = (p * a) - T(0.2145988016);
+  p = (p * a) + T(1.5707963050);
+  T result = T(1.57079632679489661923) - (std::sqrt(T(1.0) - a) * p);
+  // sign restored with copysign rather than a select
+  return std::copysign(result, x);
+}
+
+template<typename T>
+void SinCos(const T* x, T* sin_x, T* cos_x, const std::size_t count)
+{
+  for (std::size_t i = 0; i < count; i++) {
+    FastSinCos(x[i], sin_x[i], cos_x[i]);
+  }
+}
+
+#endif
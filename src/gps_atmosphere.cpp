@@ -0,0 +1,181 @@
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+
+#include <Eigen/Dense>
+
+#include "gps_atmosphere.hpp"
+#include "gps_common.hpp"
+#include "gps_coordinates.hpp"
+#include "parallel_ops.hpp"
+#include "vector_math.hpp"
+
+namespace Gps
+{
+
+namespace
+{
+  // Klobuchar in the units of the specification: latitude/longitude in semicircles, elevation as its
+  // sine and azimuth as its cosine and sine. Branch-free so the batched loop vectorizes (limits and
+  // selects are step weights, see vector_math.hpp); only called from that loop so that it is always
+  // inlined.
+  inline double Klobuchar(const IonosphereData& iono, const double gps_time, const double lat, const double lon,
+    const double sin_el, const double cos_az, const double sin_az)
+  {
+    constexpr double pi = std::numbers::pi;
+    double E = FastAsin(FastClamp(sin_el, 0.0, 1.0)) / pi;
+    double psi = (0.0137 / (E + 0.11)) - 0.022;
+    double phi_i = FastClamp(lat + (psi * cos_az), -0.416, 0.416);
+    double sin_phi, cos_phi;
+    FastSinCos(phi_i * pi, sin_phi, cos_phi);
+    double lambda_i = lon + (psi * sin_az / cos_phi);
+    double sin_m, cos_m;
+    FastSinCos((lambda_i - 1.617) * pi, sin_m, cos_m);
+    double phi_m = phi_i + (0.064 * cos_m);
+
+    // local time at the pierce point in [0,86400)
+    double t = (4.32e4 * lambda_i) + gps_time;
+    t -= 86400.0 * FastRound(t / 86400.0);
+    t += 86400.0 * (1.0 - StepWeight(t));
+
+    double amplitude = iono.alpha[0] + (phi_m * (iono.alpha[1] + (phi_m * (iono.alpha[2] + (phi_m * iono.alpha[3])))));
+    double period = iono.beta[0] + (phi_m * (iono.beta[1] + (phi_m * (iono.beta[2] + (phi_m * iono.beta[3])))));
+    amplitude = FastMax(amplitude, 0.0);
+    period = FastMax(period, 72000.0);
+
+    double x = 2.0 * pi * (t - 50400.0) / period;
+    double x2 = x * x;
+    double slant = 1.0 + (16.0 * (0.53 - E) * (0.53 - E) * (0.53 - E));
+    // 1 by day (|x| < 1.57), 0 by night
+    double daytime = 1.0 - StepWeight(std::abs(x) - 1.57);
+    return slant * (5.0e-9 + (daytime * amplitude * (1.0 - (0.5 * x2) + (x2 * x2 / 24.0))));
+  }
+
+  inline double TroposphereMapping(const double sin_el)
+  {
+    double s = FastClamp(sin_el, 0.0, 1.0);
+    return 1.001 / std::sqrt(0.002001 + (s * s));
+  }
+}
+
+
+double KlobucharDelay(const IonosphereData& iono, const double gps_time, const double lat, const double lon,
+  const double elevation, const double azimuth)
+{
+  constexpr double pi = std::numbers::pi;
+  double E = std::max(elevation, 0.0) / pi;
+  double psi = (0.0137 / (E + 0.11)) - 0.022;
+  double phi_i = std::clamp((lat / pi) + (psi * std::cos(azimuth)), -0.416, 0.416);
+  double lambda_i = (lon / pi) + (psi * std::sin(azimuth) / std::cos(phi_i * pi));
+  double phi_m = phi_i + (0.064 * std::cos((lambda_i - 1.617) * pi));
+  double t = std::fmod((4.32e4 * lambda_i) + gps_time, 86400.0);
+  if (t < 0.0) t += 86400.0;
+
+  double amplitude = iono.alpha[0] + (phi_m * (iono.alpha[1] + (phi_m * (iono.alpha[2] + (phi_m * iono.alpha[3])))));
+  double period = iono.beta[0] + (phi_m * (iono.beta[1] + (phi_m * (iono.beta[2] + (phi_m * iono.beta[3])))));
+  amplitude = std::max(amplitude, 0.0);
+  period = std::max(period, 72000.0);
+
+  double slant = 1.0 + (16.0 * std::pow(0.53 - E, 3));
+  double x = 2.0 * pi * (t - 50400.0) / period;
+  if (std::abs(x) >= 1.57) {
+    return slant * 5.0e-9;
+  }
+  return slant * (5.0e-9 + (amplitude * (1.0 - (x * x / 2.0) + (x * x * x * x / 24.0))));
+}
+
+double TroposphereZenithDelay(const double lat, const double height)
+{
+  double h = std::clamp(height, 0.0, 1.0e4);
+  double pressure = 1013.25 * std::pow(1.0 - (2.2557e-5 * h), 5.2568); // hPa
+  double temperature = 15.0 - (6.5e-3 * h) + 273.16; // K
+  double vapor = 6.108 * 0.5 * std::exp(((17.15 * temperature) - 4684.0) / (temperature - 38.45)); // hPa
+  double hydrostatic = 0.0022768 * pressure / (1.0 - (0.00266 * std::cos(2.0 * lat)) - (0.00028e-3 * h));
+  double wet = 0.002277 * ((1255.0 / temperature) + 0.05) * vapor;
+  return hydrostatic + wet;
+}
+
+double TroposphereDelay(const double lat, const double height, const double elevation)
+{
+  return TroposphereZenithDelay(lat, height) * TroposphereMapping(std::sin(elevation));
+}
+
+
+AtmosphereModel::AtmosphereModel(const IonosphereData& iono, const unsigned int num_threads)
+  : iono_{iono}, num_threads_{num_threads}
+{}
+
+void AtmosphereModel::SetReceivers(const SoaVector3& rx_pos)
+{
+  const Eigen::Index count = rx_pos.rows();
+  rx_pos_ = rx_pos;
+  east_.resize(count, 3);
+  north_.resize(count, 3);
+  up_.resize(count, 3);
+  lat_.resize(count);
+  lon_.resize(count);
+  zenith_delay_.resize(count);
+  for (Eigen::Index r = 0; r < count; r++) {
+    double lat, lon, alt;
+    EcefToLla(rx_pos.row(r).transpose(), lat, lon, alt);
+    Eigen::Matrix3d rotation = EcefToEnuRotation(lat, lon);
+    east_.row(r) = rotation.row(0);
+    north_.row(r) = rotation.row(1);
+    up_.row(r) = rotation.row(2);
+    lat_(r) = lat / std::numbers::pi;
+    lon_(r) = lon / std::numbers::pi;
+    zenith_delay_(r) = TroposphereZenithDelay(lat, alt);
+  }
+}
+
+void AtmosphereModel::Compute(const double gps_time, const std::vector<Eigen::Vector3d>& sat_pos,
+  Eigen::MatrixXd& iono, Eigen::MatrixXd& tropo) const
+{
+  iono.resize(rx_pos_.rows(), sat_pos.size());
+  tropo.resize(rx_pos_.rows(), sat_pos.size());
+  const std::size_t num_pairs = static_cast<std::size_t>(rx_pos_.rows()) * sat_pos.size();
+  ParallelFor(sat_pos.size(), [&](const std::size_t sat)
+  {
+    Compute(gps_time, sat_pos[sat], iono.col(sat).data(), tropo.col(sat).data());
+  }, ThreadsForWork(num_threads_, num_pairs, MIN_PAIRS_PER_THREAD));
+}
+
+void AtmosphereModel::Compute(const double gps_time, const Eigen::Vector3d& sat_pos, double* iono,
+  double* tropo) const
+{
+  const IonosphereData params = iono_;
+  const Eigen::Index count = rx_pos_.rows();
+  const double sx = sat_pos(0), sy = sat_pos(1), sz = sat_pos(2);
+  const double* rx = rx_pos_.col(0).data();
+  const double* ry = rx_pos_.col(1).data();
+  const double* rz = rx_pos_.col(2).data();
+  const double* ex = east_.col(0).data();
+  const double* ey = east_.col(1).data();
+  const double* ez = east_.col(2).data();
+  const double* nx = north_.col(0).data();
+  const double* ny = north_.col(1).data();
+  const double* nz = north_.col(2).data();
+  const double* ux = up_.col(0).data();
+  const double* uy = up_.col(1).data();
+  const double* uz = up_.col(2).data();
+  const double* lat = lat_.data();
+  const double* lon = lon_.data();
+  const double* zenith_delay = zenith_delay_.data();
+
+  // outputs never alias the receiver terms; too many arrays for GCC's runtime alias checks
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC ivdep
+#endif
+  for (Eigen::Index r = 0; r < count; r++) {
+    double dx = sx - rx[r], dy = sy - ry[r], dz = sz - rz[r];
+    double east = (ex[r] * dx) + (ey[r] * dy) + (ez[r] * dz);
+    double north = (nx[r] * dx) + (ny[r] * dy) + (nz[r] * dz);
+    double up = (ux[r] * dx) + (uy[r] * dy) + (uz[r] * dz);
+    double horizontal = std::sqrt((east * east) + (north * north)) + 1.0e-9;
+    double sin_el = up / std::sqrt((horizontal * horizontal) + (up * up));
+    iono[r] = LIGHT_SPEED * Klobuchar(params, gps_time, lat[r], lon[r], sin_el, north / horizontal, east / horizontal);
+    tropo[r] = zenith_delay[r] * TroposphereMapping(sin_el);
+  }
+}
+
+} // namespace Gps
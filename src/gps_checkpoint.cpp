@@ -0,0 +1,77 @@
+#include <cstdio>
+#include <string>
+#include <sstream>
+#include <fstream>
+
+#include "gps_common.hpp"
+#include "gps_checkpoint.hpp"
+
+namespace Gps {
+namespace Lnav {
+
+namespace internal
+{
+  constexpr uint32_t CHECKPOINT_MAGIC = 0x4B434753; // "SGCK"
+  constexpr uint32_t CHECKPOINT_VERSION = 3;
+
+  void WriteCheckpointHeader(std::ostream& os, const double gps_time, const uint32_t num_signals,
+    const uint32_t real_size)
+  {
+    WriteBinary(os, CHECKPOINT_MAGIC);
+    WriteBinary(os, CHECKPOINT_VERSION);
+    WriteBinary(os, real_size);
+    WriteBinary(os, gps_time);
+    WriteBinary(os, num_signals);
+  }
+
+  bool ReadCheckpointHeader(std::istream& is, double& gps_time, uint32_t& num_signals,
+    const uint32_t real_size)
+  {
+    uint32_t magic, version, stored_real_size;
+    ReadBinary(is, magic);
+    ReadBinary(is, version);
+    ReadBinary(is, stored_real_size);
+    ReadBinary(is, gps_time);
+    if (!ReadBinary(is, num_signals)) return false;
+    return (magic == CHECKPOINT_MAGIC) && (version == CHECKPOINT_VERSION)
+        && (stored_real_size == real_size);
+  }
+
+  // The standard only defines a text representation of engine state
+  void WriteRandomState(std::ostream& os)
+  {
+    std::ostringstream engine;
+    engine << Gps::internal::random_gen;
+    std::string state = engine.str();
+    WriteBinary(os, static_cast<uint32_t>(state.size()));
+    os.write(state.data(), state.size());
+  }
+
+  bool ReadRandomState(std::istream& is)
+  {
+    uint32_t size;
+    if (!ReadBinary(is, size)) return false;
+    std::string state(size, '\0');
+    if (!is.read(state.data(), size)) return false;
+    std::istringstream engine(state);
+    engine >> Gps::internal::random_gen;
+    return !engine.fail();
+  }
+}
+
+
+bool WriteCheckpointFile(const std::string& path, const std::string& contents)
+{
+  std::string temp_path = path + ".tmp";
+  {
+    std::ofstream os(temp_path, std::ios::binary | std::ios::trunc);
+    if (!os.write(contents.data(), contents.size())) return false;
+    os.flush();
+    if (!os) return false;
+  }
+  return std::rename(temp_path.c_str(), path.c_str()) == 0;
+}
+
+
+} // namespace Lnav
+} // namespace Gps
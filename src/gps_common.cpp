@@ -10,7 +10,19 @@ namespace Gps
 
 namespace internal
 {
-  std::random_device random_gen;
+  static uint64_t InitialSeed()
+  {
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) | device();
+  }
+
+  std::mt19937_64 random_gen(InitialSeed());
+}
+
+
+void SeedRandom(const uint64_t seed)
+{
+  internal::random_gen.seed(seed);
 }
 
 
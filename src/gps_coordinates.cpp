@@ -0,0 +1,70 @@
+#include <cmath>
+
+#include <Eigen/Dense>
+
+#include "gps_coordinates.hpp"
+
+namespace Gps
+{
+
+Eigen::Vector3d LlaToEcef(const double lat, const double lon, const double alt)
+{
+  double sin_lat = std::sin(lat);
+  double cos_lat = std::cos(lat);
+  double N = WGS84_SEMI_MAJOR_AXIS / std::sqrt(1.0 - (WGS84_ECCENTRICITY_SQ * sin_lat * sin_lat));
+  return Eigen::Vector3d( (N + alt) * cos_lat * std::cos(lon),
+                          (N + alt) * cos_lat * std::sin(lon),
+                          ((N * (1.0 - WGS84_ECCENTRICITY_SQ)) + alt) * sin_lat );
+}
+
+// Iterative solution, converges to sub-millimeter in a few passes for terrestrial positions
+void EcefToLla(const Eigen::Vector3d& ecef, double& lat, double& lon, double& alt)
+{
+  double p = std::hypot(ecef(0), ecef(1));
+  lon = std::atan2(ecef(1), ecef(0));
+  lat = std::atan2(ecef(2), p * (1.0 - WGS84_ECCENTRICITY_SQ));
+  alt = 0.0;
+  for (int i = 0; i < 5; i++) {
+    double sin_lat = std::sin(lat);
+    double N = WGS84_SEMI_MAJOR_AXIS / std::sqrt(1.0 - (WGS84_ECCENTRICITY_SQ * sin_lat * sin_lat));
+    alt = (p / std::cos(lat)) - N;
+    lat = std::atan2(ecef(2), p * (1.0 - (WGS84_ECCENTRICITY_SQ * N / (N + alt))));
+  }
+}
+
+Eigen::Matrix3d EcefToEnuRotation(const double lat, const double lon)
+{
+  double sin_lat = std::sin(lat);
+  double cos_lat = std::cos(lat);
+  double sin_lon = std::sin(lon);
+  double cos_lon = std::cos(lon);
+  Eigen::Matrix3d C;
+  C << -sin_lon,           cos_lon,           0.0,
+       -sin_lat * cos_lon, -sin_lat * sin_lon, cos_lat,
+        cos_lat * cos_lon,  cos_lat * sin_lon, sin_lat;
+  return C;
+}
+
+Eigen::Matrix3d EcefToEnuRotation(const Eigen::Vector3d& ecef)
+{
+  double lat, lon, alt;
+  EcefToLla(ecef, lat, lon, alt);
+  return EcefToEnuRotation(lat, lon);
+}
+
+void ElevationAzimuth(const Eigen::Vector3d& rx_pos, const Eigen::Vector3d& sat_pos,
+  double& elevation, double& azimuth)
+{
+  Eigen::Vector3d enu = EcefToEnuRotation(rx_pos) * (sat_pos - rx_pos);
+  elevation = std::atan2(enu(2), std::hypot(enu(0), enu(1)));
+  azimuth = std::atan2(enu(0), enu(1));
+}
+
+double Elevation(const Eigen::Vector3d& rx_pos, const Eigen::Vector3d& sat_pos)
+{
+  double elevation, azimuth;
+  ElevationAzimuth(rx_pos, sat_pos, elevation, azimuth);
+  return elevation;
+}
+
+} // namespace Gps
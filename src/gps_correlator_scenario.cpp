@@ -0,0 +1,88 @@
+#include <cmath>
+
+#include <Eigen/Dense>
+
+#include "gps_common.hpp"
+#include "gps_coordinates.hpp"
+#include "gps_correlator_scenario.hpp"
+#include "parallel_ops.hpp"
+
+namespace Gps
+{
+
+CorrelatorScenario::CorrelatorScenario(const std::vector<Ephemeris>& ephemerides,
+  const std::vector<ReceiverTrajectory>& receivers, const std::vector<TrackingErrorModel>& error_models,
+  const double corr_period, const double early_late_spacing, const double elevation_mask, const uint64_t seed,
+  const unsigned int num_threads)
+  : ephemerides_(ephemerides.begin(), ephemerides.end()), receivers_{receivers}, error_models_{error_models}, corr_period_{corr_period},
+    sin_elevation_mask_{std::sin(elevation_mask)}, num_threads_{num_threads},
+    correlator_({-0.5 * early_late_spacing, 0.0, 0.5 * early_late_spacing}),
+    sat_pos_(ephemerides.size()), sat_vel_(ephemerides.size()), sat_acc_(ephemerides.size()),
+    channels_(receivers.size())
+{
+  assert(error_models.size() == 1 || error_models.size() == receivers.size());
+  generators_.reserve(receivers.size());
+  for (std::size_t i = 0; i < receivers.size(); i++) {
+    std::seed_seq seq {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                       static_cast<uint32_t>(i), static_cast<uint32_t>(uint64_t(i) >> 32)};
+    generators_.emplace_back(seq);
+  }
+}
+
+void CorrelatorScenario::Step(const double gps_time)
+{
+  // One orbit evaluation per satellite, receivers expand about it in light time
+  constexpr double nominal_light_time = 0.075;
+  reference_time_ = gps_time - nominal_light_time;
+  for (std::size_t s = 0; s < ephemerides_.size(); s++) {
+    ephemerides_[s].PVA(reference_time_, sat_pos_[s], sat_vel_[s], sat_acc_[s]);
+  }
+
+  ParallelFor(receivers_.size(), [this, gps_time](const std::size_t receiver)
+  {
+    StepReceiver(receiver, gps_time);
+  }, num_threads_);
+}
+
+void CorrelatorScenario::StepReceiver(const std::size_t receiver, const double gps_time)
+{
+  Eigen::Vector3d rx_pos, rx_vel, rx_acc;
+  receivers_[receiver](gps_time, rx_pos, rx_vel, rx_acc);
+  Eigen::Vector3d up = EcefToEnuRotation(rx_pos).row(2).transpose();
+
+  const TrackingErrorModel& model = error_models_[(error_models_.size() == 1) ? 0 : receiver];
+  std::mt19937_64& gen = generators_[receiver];
+  std::normal_distribution<double> normal_dist;
+  std::vector<CorrelatorChannel>& channels = channels_[receiver];
+  channels.clear();
+
+  for (std::size_t s = 0; s < ephemerides_.size(); s++) {
+    // light time from the shared reference state, Sagnac as a small rotation about z
+    double light_time = (sat_pos_[s] - rx_pos).norm() / LIGHT_SPEED;
+    Eigen::Vector3d tx_pos;
+    for (int i = 0; i < 2; i++) {
+      double dt = (gps_time - light_time) - reference_time_;
+      tx_pos = sat_pos_[s] + (sat_vel_[s] * dt) + (0.5 * sat_acc_[s] * dt * dt);
+      double theta = Ephemeris::WGS84_EARTH_RATE * light_time;
+      tx_pos = Eigen::Vector3d(tx_pos(0) + (theta * tx_pos(1)), tx_pos(1) - (theta * tx_pos(0)), tx_pos(2));
+      light_time = (tx_pos - rx_pos).norm() / LIGHT_SPEED;
+    }
+
+    Eigen::Vector3d los = tx_pos - rx_pos;
+    double sin_elevation = up.dot(los) / los.norm();
+    if (sin_elevation < sin_elevation_mask_) continue;
+
+    CorrelatorChannel& channel = channels.emplace_back();
+    channel.satellite = static_cast<uint16_t>(s);
+    channel.elevation = std::asin(sin_elevation);
+    channel.cno = model.horizon_cno + ((model.zenith_cno - model.horizon_cno) * std::max(sin_elevation, 0.0));
+
+    double chip_error = model.chip_sigma * normal_dist(gen);
+    double frequency_error = model.frequency_sigma * normal_dist(gen);
+    double phase_error = model.phase_sigma * normal_dist(gen);
+    correlator_.Simulate(channel.taps, chip_error, frequency_error, phase_error, corr_period_,
+                         std::pow(10.0, 0.1 * channel.cno), gen);
+  }
+}
+
+} // namespace Gps
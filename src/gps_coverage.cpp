@@ -0,0 +1,278 @@
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <Eigen/Dense>
+
+#include "gps_coverage.hpp"
+#include "gps_coordinates.hpp"
+#include "parallel_ops.hpp"
+#include "vector_math.hpp"
+
+namespace Gps
+{
+
+namespace
+{
+  // Nearest rank, so a percentile is always one of the samples
+  std::size_t PercentileRank(const double percentile, const std::size_t count)
+  {
+    double rank = std::ceil(std::clamp(percentile, 0.0, 100.0) * count / 100.0);
+    return std::min(static_cast<std::size_t>(std::max(rank, 1.0)), count) - 1;
+  }
+}
+
+
+SoaVector3 LatLonGrid(const double lat_min, const double lat_max, const std::size_t num_lat,
+  const double lon_min, const double lon_max, const std::size_t num_lon, const double alt)
+{
+  const double lat_step = (num_lat > 1) ? (lat_max - lat_min) / (num_lat - 1) : 0.0;
+  const double lon_step = (num_lon > 1) ? (lon_max - lon_min) / (num_lon - 1) : 0.0;
+  SoaVector3 points(num_lat * num_lon, 3);
+  for (std::size_t i = 0; i < num_lat; i++) {
+    for (std::size_t j = 0; j < num_lon; j++) {
+      points.row((i * num_lon) + j) = LlaToEcef(lat_min + (i * lat_step), lon_min + (j * lon_step), alt);
+    }
+  }
+  return points;
+}
+
+
+CoverageModel::CoverageModel(const std::vector<Ephemeris>& ephemerides, const SoaVector3& points,
+  const double elevation_mask, const unsigned int num_threads)
+  : num_points_{static_cast<std::size_t>(points.rows())},
+    sin_mask_{std::sin(elevation_mask)},
+    num_threads_{num_threads}
+{
+  orbits_.reserve(ephemerides.size());
+  for (const Ephemeris& eph : ephemerides) {
+    orbits_.emplace_back(eph);
+  }
+
+  const std::size_t padded = BLOCK_SIZE * ((num_points_ + BLOCK_SIZE - 1) / BLOCK_SIZE);
+  points_.resize(padded, 3);
+  up_.resize(padded, 3);
+  for (std::size_t p = 0; p < padded; p++) {
+    Eigen::Vector3d pos = points.row(std::min(p, num_points_ - 1)).transpose();
+    double lat, lon, alt;
+    EcefToLla(pos, lat, lon, alt);
+    points_.row(p) = pos.transpose();
+    up_.row(p) = EcefToEnuRotation(lat, lon).row(2);
+  }
+}
+
+Eigen::Matrix3Xd CoverageModel::SatellitePositions(const std::vector<double>& gps_times) const
+{
+  const std::size_t num_sats = orbits_.size();
+  Eigen::Matrix3Xd sat_pos(3, num_sats * gps_times.size());
+  ParallelFor(gps_times.size(), [&](const std::size_t epoch)
+  {
+    for (std::size_t s = 0; s < num_sats; s++) {
+      Eigen::Vector3d pos;
+      orbits_[s].P(gps_times[epoch], pos);
+      sat_pos.col((epoch * num_sats) + s) = pos;
+    }
+  }, num_threads_);
+  return sat_pos;
+}
+
+void CoverageModel::ComputeBlock(const std::size_t block, const double* sat_pos, BlockDops& out) const
+{
+  const std::size_t base = block * BLOCK_SIZE;
+  const std::size_t num_sats = orbits_.size();
+  const double sin_mask = sin_mask_;
+  const double* px = points_.col(0).data() + base;
+  const double* py = points_.col(1).data() + base;
+  const double* pz = points_.col(2).data() + base;
+  const double* ux = up_.col(0).data() + base;
+  const double* uy = up_.col(1).data() + base;
+  const double* uz = up_.col(2).data() + base;
+
+  // distinct entries of the normal matrix, geometry rows are [-los, 1]. Zeroed in a loop: with
+  // aggregate initialization GCC's PRE carries the first entries into the cofactor loop and leaves
+  // it unvectorizable.
+  alignas(64) double a00[BLOCK_SIZE], a01[BLOCK_SIZE], a02[BLOCK_SIZE], a03[BLOCK_SIZE];
+  alignas(64) double a11[BLOCK_SIZE], a12[BLOCK_SIZE], a13[BLOCK_SIZE];
+  alignas(64) double a22[BLOCK_SIZE], a23[BLOCK_SIZE];
+  alignas(64) double a33[BLOCK_SIZE];
+  for (std::size_t i = 0; i < BLOCK_SIZE; i++) {
+    a00[i] = a01[i] = a02[i] = a03[i] = 0.0;
+    a11[i] = a12[i] = a13[i] = 0.0;
+    a22[i] = a23[i] = 0.0;
+    a33[i] = 0.0;
+  }
+
+  for (std::size_t s = 0; s < num_sats; s++) {
+    const double sx = sat_pos[3 * s], sy = sat_pos[(3 * s) + 1], sz = sat_pos[(3 * s) + 2];
+    for (std::size_t i = 0; i < BLOCK_SIZE; i++) {
+      double dx = sx - px[i], dy = sy - py[i], dz = sz - pz[i];
+      double inv_range = 1.0 / std::sqrt((dx * dx) + (dy * dy) + (dz * dz));
+      double ex = dx * inv_range, ey = dy * inv_range, ez = dz * inv_range;
+      double sin_el = (ux[i] * ex) + (uy[i] * ey) + (uz[i] * ez);
+      // 1 at or above the mask, 0 below
+      double w = StepWeight(sin_el - sin_mask);
+      double wx = w * ex, wy = w * ey, wz = w * ez;
+      a00[i] += wx * ex;
+      a01[i] += wx * ey;
+      a02[i] += wx * ez;
+      a03[i] -= wx;
+      a11[i] += wy * ey;
+      a12[i] += wy * ez;
+      a13[i] -= wy;
+      a22[i] += wz * ez;
+      a23[i] -= wz;
+      a33[i] += w;
+    }
+  }
+
+  // Cofactor inverse from the 2x2 minors of the top and bottom row pairs; only the diagonal and the
+  // position block's off-diagonals are needed. Branch-free (see vector_math.hpp): validity is a 0/1
+  // weight and invalid points get NaN from 0/0.
+  // the outputs are never the point arrays
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC ivdep
+#endif
+  for (std::size_t i = 0; i < BLOCK_SIZE; i++) {
+    double s0 = (a00[i] * a11[i]) - (a01[i] * a01[i]);
+    double s1 = (a00[i] * a12[i]) - (a01[i] * a02[i]);
+    double s2 = (a00[i] * a13[i]) - (a01[i] * a03[i]);
+    double s3 = (a01[i] * a12[i]) - (a11[i] * a02[i]);
+    double s4 = (a01[i] * a13[i]) - (a11[i] * a03[i]);
+    double s5 = (a02[i] * a13[i]) - (a12[i] * a03[i]);
+    double c0 = (a02[i] * a13[i]) - (a03[i] * a12[i]);
+    double c1 = (a02[i] * a23[i]) - (a03[i] * a22[i]);
+    double c2 = (a02[i] * a33[i]) - (a03[i] * a23[i]);
+    double c3 = (a12[i] * a23[i]) - (a13[i] * a22[i]);
+    double c4 = (a12[i] * a33[i]) - (a13[i] * a23[i]);
+    double c5 = (a22[i] * a33[i]) - (a23[i] * a23[i]);
+    double det = (s0 * c5) - (s1 * c4) + (s2 * c3) + (s3 * c2) - (s4 * c1) + (s5 * c0);
+    // fewer than four satellites leaves the matrix singular up to rounding
+    double valid = (1.0 - StepWeight(3.5 - a33[i])) * (1.0 - StepWeight(1.0e-12 - det));
+    double invalid = 0.0 / valid;
+    double inv_det = 1.0 / (det + ((1.0 - valid) * (1.0 - det)));
+
+    double q00 = ((a11[i] * c5) - (a12[i] * c4) + (a13[i] * c3)) * inv_det;
+    double q01 = ((a02[i] * c4) - (a01[i] * c5) - (a03[i] * c3)) * inv_det;
+    double q02 = ((a13[i] * s5) - (a23[i] * s4) + (a33[i] * s3)) * inv_det;
+    double q11 = ((a00[i] * c5) - (a02[i] * c2) + (a03[i] * c1)) * inv_det;
+    double q12 = ((a23[i] * s2) - (a03[i] * s5) - (a33[i] * s1)) * inv_det;
+    double q22 = ((a03[i] * s4) - (a13[i] * s2) + (a33[i] * s0)) * inv_det;
+    double q33 = ((a02[i] * s3) - (a12[i] * s1) + (a22[i] * s0)) * inv_det;
+
+    double position = q00 + q11 + q22;
+    double vertical = (ux[i] * ux[i] * q00) + (uy[i] * uy[i] * q11) + (uz[i] * uz[i] * q22)
+                    + (2.0 * ((ux[i] * uy[i] * q01) + (ux[i] * uz[i] * q02) + (uy[i] * uz[i] * q12)));
+    // rounding can leave the horizontal or vertical part slightly negative
+    double horizontal = FastMax(position - vertical, 0.0);
+    vertical = FastMax(vertical, 0.0);
+    out.gdop[i] = std::sqrt(position + q33) + invalid;
+    out.pdop[i] = std::sqrt(position) + invalid;
+    out.hdop[i] = std::sqrt(horizontal) + invalid;
+    out.vdop[i] = std::sqrt(vertical) + invalid;
+    out.num_visible[i] = a33[i];
+  }
+}
+
+void CoverageModel::Compute(const std::vector<double>& gps_times, DopMaps& dops) const
+{
+  const std::size_t num_epochs = gps_times.size();
+  const std::size_t num_blocks = points_.rows() / BLOCK_SIZE;
+  const std::size_t num_sats = orbits_.size();
+  dops.gdop.resize(num_points_, num_epochs);
+  dops.pdop.resize(num_points_, num_epochs);
+  dops.hdop.resize(num_points_, num_epochs);
+  dops.vdop.resize(num_points_, num_epochs);
+  dops.num_visible.resize(num_points_, num_epochs);
+  const Eigen::Matrix3Xd sat_pos = SatellitePositions(gps_times);
+
+  ParallelFor(num_epochs, [&](const std::size_t epoch)
+  {
+    BlockDops block_dops;
+    for (std::size_t block = 0; block < num_blocks; block++) {
+      ComputeBlock(block, sat_pos.col(epoch * num_sats).data(), block_dops);
+      const std::size_t base = block * BLOCK_SIZE;
+      const std::size_t count = std::min(BLOCK_SIZE, num_points_ - base);
+      for (std::size_t i = 0; i < count; i++) {
+        dops.gdop(base + i, epoch) = block_dops.gdop[i];
+        dops.pdop(base + i, epoch) = block_dops.pdop[i];
+        dops.hdop(base + i, epoch) = block_dops.hdop[i];
+        dops.vdop(base + i, epoch) = block_dops.vdop[i];
+        dops.num_visible(base + i, epoch) = static_cast<uint8_t>(block_dops.num_visible[i]);
+      }
+    }
+  }, num_threads_);
+}
+
+void CoverageModel::Summarize(const std::vector<double>& gps_times, const std::vector<double>& percentiles,
+  DopSummary& summary) const
+{
+  const std::size_t num_epochs = gps_times.size();
+  const std::size_t num_blocks = points_.rows() / BLOCK_SIZE;
+  const std::size_t num_sats = orbits_.size();
+  const std::size_t num_percentiles = percentiles.size();
+  summary.percentiles = percentiles;
+  summary.gdop.resize(num_points_, num_percentiles);
+  summary.pdop.resize(num_points_, num_percentiles);
+  summary.hdop.resize(num_points_, num_percentiles);
+  summary.vdop.resize(num_points_, num_percentiles);
+  summary.availability.resize(num_points_);
+  if (num_epochs == 0) {
+    summary.gdop.setConstant(std::numeric_limits<double>::quiet_NaN());
+    summary.pdop.setConstant(std::numeric_limits<double>::quiet_NaN());
+    summary.hdop.setConstant(std::numeric_limits<double>::quiet_NaN());
+    summary.vdop.setConstant(std::numeric_limits<double>::quiet_NaN());
+    summary.availability.setZero();
+    return;
+  }
+  const Eigen::Matrix3Xd sat_pos = SatellitePositions(gps_times);
+
+  // visit percentiles in increasing rank so each selection only partitions what is left
+  std::vector<std::size_t> order(num_percentiles);
+  for (std::size_t k = 0; k < num_percentiles; k++) {
+    order[k] = k;
+  }
+  std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return percentiles[a] < percentiles[b]; });
+
+  ParallelFor(num_blocks, [&](const std::size_t block)
+  {
+    // per point distributions over epochs for the four DOPs, unavailable epochs as +inf
+    Eigen::MatrixXd samples(num_epochs, 4 * BLOCK_SIZE);
+    Eigen::VectorXd available = Eigen::VectorXd::Zero(BLOCK_SIZE);
+    BlockDops block_dops;
+    for (std::size_t epoch = 0; epoch < num_epochs; epoch++) {
+      ComputeBlock(block, sat_pos.col(epoch * num_sats).data(), block_dops);
+      for (std::size_t i = 0; i < BLOCK_SIZE; i++) {
+        bool valid = !std::isnan(block_dops.gdop[i]);
+        constexpr double inf = std::numeric_limits<double>::infinity();
+        samples(epoch, i) = valid ? block_dops.gdop[i] : inf;
+        samples(epoch, BLOCK_SIZE + i) = valid ? block_dops.pdop[i] : inf;
+        samples(epoch, (2 * BLOCK_SIZE) + i) = valid ? block_dops.hdop[i] : inf;
+        samples(epoch, (3 * BLOCK_SIZE) + i) = valid ? block_dops.vdop[i] : inf;
+        available(i) += valid ? 1.0 : 0.0;
+      }
+    }
+
+    const std::size_t base = block * BLOCK_SIZE;
+    const std::size_t count = std::min(BLOCK_SIZE, num_points_ - base);
+    Eigen::MatrixXd* outputs[4] = {&summary.gdop, &summary.pdop, &summary.hdop, &summary.vdop};
+    for (std::size_t kind = 0; kind < 4; kind++) {
+      for (std::size_t i = 0; i < count; i++) {
+        double* begin = samples.col((kind * BLOCK_SIZE) + i).data();
+        double* first = begin;
+        for (std::size_t k : order) {
+          double* nth = begin + PercentileRank(percentiles[k], num_epochs);
+          if (nth >= first) {
+            std::nth_element(first, nth, begin + num_epochs);
+            first = nth + 1;
+          }
+          (*outputs[kind])(base + i, k) = *nth;
+        }
+      }
+    }
+    for (std::size_t i = 0; i < count; i++) {
+      summary.availability(base + i) = available(i) / num_epochs;
+    }
+  }, num_threads_);
+}
+
+} // namespace Gps
@@ -15,7 +15,8 @@ namespace Gps
 uint32_t ParamToBinary(const double param, const double scale_factor)
 {
   double quotient = param / scale_factor;
-  return static_cast<uint32_t>(quotient < 0 ? quotient - 0.5 : quotient + 0.5);
+  // through a signed integer, negative doubles converted straight to unsigned are undefined
+  return static_cast<uint32_t>(static_cast<int64_t>(quotient < 0 ? quotient - 0.5 : quotient + 0.5));
 }
 
 
@@ -69,36 +70,44 @@ void ClockData::Randomize()
 
 
 // --------------------------- Ephemeris --------------------------- 
-inline double Ephemeris::EfromAnomaly(const double M_k, const unsigned int iterations) const
+double Ephemeris::EfromAnomaly(const double M_k, const unsigned int iterations) const
 {
-  double E_k = M_k;
-  // for (unsigned int j = 0; j < iterations; j++) {
-  //   E_k += (M_k - E_k + (e * std::sin(E_k))) / (1.0 - (e * std::cos(E_k)));
-  // }
+  double sin_E, cos_E;
+  return SolveKepler(M_k, e, sin_E, cos_E, iterations);
+}
+
+double Ephemeris::EfromTime(const double gps_time, const unsigned int iterations) const
+{
+  return EfromAnomaly(M_0 + (MeanMotion() * TimeFromEpoch(gps_time)), iterations);
+}
 
-  double del_E;
-  do {
-    del_E = (M_k - E_k + (e * std::sin(E_k))) / (1.0 - (e * std::cos(E_k)));
-    E_k += del_E;
+void Ephemeris::EfromTime(const double* gps_times, double* E, double* sin_E, double* cos_E,
+  const std::size_t count) const
+{
+  const double n = MeanMotion();
+  for (std::size_t i = 0; i < count; i++) {
+    double t_k = gps_times[i] - t_oe;
+    t_k -= (t_k > 302400.0) ? 604800.0 : 0.0;
+    t_k += (t_k < -302400.0) ? 604800.0 : 0.0;
+    E[i] = SolveKepler(M_0 + (n * t_k), e, sin_E[i], cos_E[i]);
   }
-  while (del_E > 1.0e-15);
-  return E_k;
 }
 
-inline double Ephemeris::EfromTime(const double gps_time, const unsigned int iterations) const
+double Ephemeris::TimeFromEpoch(const double gps_time) const
 {
-  double A = std::pow(sqrtA,2.0);
-  
-  double n_0 = std::sqrt(WGS84_MU / std::pow(A,3.0));
   double t_k = gps_time - t_oe;
   if (t_k > 302400.0) {
     t_k -= 604800.0;
   } else if (t_k < -302400) {
     t_k += 604800.0;
   }
-  
-  double n = n_0 + del_n;
-  return EfromAnomaly(M_0 + (n * t_k),5);
+  return t_k;
+}
+
+double Ephemeris::MeanMotion() const
+{
+  double A = sqrtA * sqrtA;
+  return std::sqrt(WGS84_MU / (A * A * A)) + del_n;
 }
 
 void Ephemeris::P(const double gps_time, Eigen::Vector3d& pos) const
@@ -232,40 +241,43 @@ void Ephemeris::PVA(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d
 
 double Ephemeris::RelTime(const double gps_time) const
 {
-  return RELETIVISTIC_F * std::numbers::e * sqrtA * std::sin(EfromTime(gps_time,5));
+  double sin_E, cos_E;
+  SolveKepler(M_0 + (MeanMotion() * TimeFromEpoch(gps_time)), e, sin_E, cos_E);
+  return RELETIVISTIC_F * e * sqrtA * sin_E;
 }
 
 double Ephemeris::RelTimeRate(const double gps_time) const
 {
-  double A = std::pow(sqrtA,2.0);
-  double n_0 = std::sqrt(WGS84_MU / std::pow(A,3.0));
-  double t_k = gps_time - t_oe;
-  if (t_k > 302400.0) {
-    t_k -= 604800.0;
-  } else if (t_k < -302400) {
-    t_k += 604800.0;
-  }  
-  double n = n_0 + del_n;
-  double e_cos_E = std::numbers::e * std::cos( EfromAnomaly(M_0 + (n * t_k),5) );
+  double n = MeanMotion();
+  double sin_E, cos_E;
+  SolveKepler(M_0 + (n * TimeFromEpoch(gps_time)), e, sin_E, cos_E);
+  double e_cos_E = e * cos_E;
 
   return (n * RELETIVISTIC_F * sqrtA * e_cos_E) / (1.0 - e_cos_E);
 }
 
 double Ephemeris::RelTimeRateRate(const double gps_time) const
 {
-  double A = std::pow(sqrtA,2.0);
-  double n_0 = std::sqrt(WGS84_MU / std::pow(A,3.0));
-  double t_k = gps_time - t_oe;
-  if (t_k > 302400.0) {
-    t_k -= 604800.0;
-  } else if (t_k < -302400) {
-    t_k += 604800.0;
-  }  
-  double n = n_0 + del_n;
-  double E_k = EfromAnomaly(M_0 + (n * t_k),5);
+  double n = MeanMotion();
+  double sin_E, cos_E;
+  SolveKepler(M_0 + (n * TimeFromEpoch(gps_time)), e, sin_E, cos_E);
 
-  return ( n * n * RELETIVISTIC_F * std::numbers::e * sqrtA * std::sin(E_k) )
-          / std::pow(1.0 - std::numbers::e * std::cos(E_k), 2);
+  return -( n * n * RELETIVISTIC_F * e * sqrtA * sin_E )
+          / std::pow(1.0 - e * cos_E, 3);
+}
+
+void Ephemeris::RelTime(const double* gps_times, double* rel_times, const std::size_t count) const
+{
+  const double n = MeanMotion();
+  const double scale = RELETIVISTIC_F * e * sqrtA;
+  for (std::size_t i = 0; i < count; i++) {
+    double t_k = gps_times[i] - t_oe;
+    t_k -= (t_k > 302400.0) ? 604800.0 : 0.0;
+    t_k += (t_k < -302400.0) ? 604800.0 : 0.0;
+    double sin_E, cos_E;
+    SolveKepler(M_0 + (n * t_k), e, sin_E, cos_E);
+    rel_times[i] = scale * sin_E;
+  }
 }
 
 void Ephemeris::Randomize()
@@ -310,4 +322,109 @@ void Ephemeris::Print() const
   std::cout << "IODE:      " << static_cast<int>(IODE) << '\n';
 }
 
+
+
+// --------------------------- PreparedEphemeris --------------------------- 
+void PreparedEphemeris::Prepare(const Ephemeris& ephemeris)
+{
+  ephemeris_ = ephemeris;
+  orbit_ = internal::PrepareOrbit(ephemeris);
+}
+
+void PreparedEphemeris::P(const double gps_time, Eigen::Vector3d& pos) const
+{
+  OrbitState state;
+  Evaluate<false,false,false>(gps_time, state);
+  pos = state.pos;
+}
+
+void PreparedEphemeris::PV(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d& vel) const
+{
+  OrbitState state;
+  Evaluate<true,false,false>(gps_time, state);
+  pos = state.pos;
+  vel = state.vel;
+}
+
+void PreparedEphemeris::PVA(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d& vel,
+  Eigen::Vector3d& accel) const
+{
+  OrbitState state;
+  Evaluate<true,true,false>(gps_time, state);
+  pos = state.pos;
+  vel = state.vel;
+  accel = state.accel;
+}
+
+void PreparedEphemeris::Evaluate(const double gps_time, OrbitState& state) const
+{
+  Evaluate<true,true,true>(gps_time, state);
+}
+
+double PreparedEphemeris::RelTime(const double gps_time) const
+{
+  double sin_E, cos_E;
+  SolveKepler(ephemeris_.M_0 + (orbit_.n * ephemeris_.TimeFromEpoch(gps_time)), ephemeris_.e, sin_E, cos_E);
+  return orbit_.rel_scale * sin_E;
+}
+
+void PreparedEphemeris::Trajectory(const double* gps_times, const std::size_t count, Eigen::Matrix3Xd& pos) const
+{
+  SoaVector3 soa_pos, filler;
+  CalcTrajectory<false>(gps_times, count, soa_pos, filler);
+  pos = soa_pos.transpose();
+}
+
+void PreparedEphemeris::Trajectory(const double* gps_times, const std::size_t count, Eigen::Matrix3Xd& pos,
+  Eigen::Matrix3Xd& vel) const
+{
+  SoaVector3 soa_pos, soa_vel;
+  CalcTrajectory<true>(gps_times, count, soa_pos, soa_vel);
+  pos = soa_pos.transpose();
+  vel = soa_vel.transpose();
+}
+
+void PreparedEphemeris::Trajectory(const double* gps_times, const std::size_t count, SoaVector3& pos) const
+{
+  SoaVector3 filler;
+  CalcTrajectory<false>(gps_times, count, pos, filler);
+}
+
+void PreparedEphemeris::Trajectory(const double* gps_times, const std::size_t count, SoaVector3& pos,
+  SoaVector3& vel) const
+{
+  CalcTrajectory<true>(gps_times, count, pos, vel);
+}
+
+template<bool CalcVel>
+void PreparedEphemeris::CalcTrajectory(const double* gps_times, const std::size_t count, SoaVector3& pos,
+  SoaVector3& vel) const
+{
+  pos.resize(count, 3);
+  if constexpr (CalcVel) vel.resize(count, 3);
+  double* px = pos.col(0).data();
+  double* py = pos.col(1).data();
+  double* pz = pos.col(2).data();
+  double* vx = CalcVel ? vel.col(0).data() : nullptr;
+  double* vy = CalcVel ? vel.col(1).data() : nullptr;
+  double* vz = CalcVel ? vel.col(2).data() : nullptr;
+
+  // each time is solved independently so the loop is vectorized
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC ivdep
+#endif
+  for (std::size_t k = 0; k < count; k++) {
+    OrbitState state;
+    Evaluate<CalcVel,false,false>(gps_times[k], state);
+    px[k] = state.pos(0);
+    py[k] = state.pos(1);
+    pz[k] = state.pos(2);
+    if constexpr (CalcVel) {
+      vx[k] = state.vel(0);
+      vy[k] = state.vel(1);
+      vz[k] = state.vel(2);
+    }
+  }
+}
+
 } // namespace gps
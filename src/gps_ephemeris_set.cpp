@@ -0,0 +1,76 @@
+#include <cassert>
+
+#include "gps_ephemeris.hpp"
+#include "gps_ephemeris_set.hpp"
+
+namespace Gps
+{
+
+EphemerisSet::EphemerisSet(const std::vector<Ephemeris>& ephemerides)
+{
+  for (const Ephemeris& ephemeris : ephemerides) {
+    Add(ephemeris);
+  }
+}
+
+void EphemerisSet::Add(const Ephemeris& ephemeris)
+{
+  for (std::vector<double>* values : {&M_0_, &n_, &e_, &A_, &sqrt_1me2_, &sin_omega_, &cos_omega_, &Omega_ref_,
+                                      &Omega_rate_, &i_0_, &IDOT_, &C_uc_, &C_us_, &C_rc_, &C_rs_, &C_ic_, &C_is_,
+                                      &t_oe_}) {
+    values->push_back(0.0);
+  }
+  Set(Size() - 1, ephemeris);
+}
+
+void EphemerisSet::Set(const std::size_t index, const Ephemeris& ephemeris)
+{
+  assert(index < Size());
+  const internal::OrbitConstants orbit = internal::PrepareOrbit(ephemeris);
+  M_0_[index] = orbit.M_0;
+  n_[index] = orbit.n;
+  e_[index] = orbit.e;
+  A_[index] = orbit.A;
+  sqrt_1me2_[index] = orbit.sqrt_1me2;
+  sin_omega_[index] = orbit.sin_omega;
+  cos_omega_[index] = orbit.cos_omega;
+  Omega_ref_[index] = orbit.Omega_ref;
+  Omega_rate_[index] = orbit.Omega_rate;
+  i_0_[index] = orbit.i_0;
+  IDOT_[index] = orbit.IDOT;
+  C_uc_[index] = orbit.C_uc;
+  C_us_[index] = orbit.C_us;
+  C_rc_[index] = orbit.C_rc;
+  C_rs_[index] = orbit.C_rs;
+  C_ic_[index] = orbit.C_ic;
+  C_is_[index] = orbit.C_is;
+  t_oe_[index] = orbit.t_oe;
+}
+
+void EphemerisSet::Clear()
+{
+  for (std::vector<double>* values : {&M_0_, &n_, &e_, &A_, &sqrt_1me2_, &sin_omega_, &cos_omega_, &Omega_ref_,
+                                      &Omega_rate_, &i_0_, &IDOT_, &C_uc_, &C_us_, &C_rc_, &C_rs_, &C_ic_, &C_is_,
+                                      &t_oe_}) {
+    values->clear();
+  }
+}
+
+void EphemerisSet::P(const double gps_time, SoaVector3& pos) const
+{
+  SoaVector3 filler;
+  CalcPVA<false,false>(gps_time, pos, filler, filler);
+}
+
+void EphemerisSet::PV(const double gps_time, SoaVector3& pos, SoaVector3& vel) const
+{
+  SoaVector3 filler;
+  CalcPVA<true,false>(gps_time, pos, vel, filler);
+}
+
+void EphemerisSet::PVA(const double gps_time, SoaVector3& pos, SoaVector3& vel, SoaVector3& accel) const
+{
+  CalcPVA<true,true>(gps_time, pos, vel, accel);
+}
+
+} // namespace Gps
@@ -0,0 +1,112 @@
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+#include "gps_ephemeris_store.hpp"
+
+namespace Gps
+{
+
+EphemerisStore::EphemerisStore(const std::size_t max_sets_per_prn)
+  : max_sets_per_prn_{max_sets_per_prn}
+{
+  assert(max_sets_per_prn > 0);
+  Clear();
+}
+
+bool EphemerisStore::Insert(const uint8_t prn, const uint16_t week, const Ephemeris& ephemeris, const ClockData& clock_data,
+  const double fit_interval)
+{
+  if (prn < 1 || prn > MAX_PRN) {
+    return false;
+  }
+
+  NavigationSet set;
+  set.prn = prn;
+  set.week = week;
+  set.ephemeris = ephemeris;
+  set.clock_data = clock_data;
+  set.orbit.Prepare(ephemeris);
+  set.fit_interval = fit_interval;
+
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  auto sets = std::make_shared<SetList>(*sets_[prn - 1].load(std::memory_order_acquire));
+  auto same = std::find_if(sets->begin(), sets->end(), [&set](const NavigationSet& stored)
+  {
+    return (stored.ephemeris.IODE == set.ephemeris.IODE) && (stored.Epoch() == set.Epoch());
+  });
+  if (same != sets->end()) {
+    *same = set;
+  } else {
+    sets->push_back(set);
+  }
+
+  std::stable_sort(sets->begin(), sets->end(), [](const NavigationSet& a, const NavigationSet& b)
+  {
+    return a.Epoch() < b.Epoch();
+  });
+  if (sets->size() > max_sets_per_prn_) {
+    sets->erase(sets->begin(), sets->begin() + (sets->size() - max_sets_per_prn_));
+  }
+  Publish(prn, std::move(sets));
+  return true;
+}
+
+void EphemerisStore::Remove(const uint8_t prn)
+{
+  if (prn < 1 || prn > MAX_PRN) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  Publish(prn, std::make_shared<const SetList>());
+}
+
+void EphemerisStore::Clear()
+{
+  std::lock_guard<std::mutex> lock(writer_mutex_);
+  for (uint8_t prn = 1; prn <= MAX_PRN; prn++) {
+    Publish(prn, std::make_shared<const SetList>());
+  }
+}
+
+void EphemerisStore::Publish(const uint8_t prn, std::shared_ptr<const SetList> sets)
+{
+  sets_[prn - 1].store(std::move(sets), std::memory_order_release);
+}
+
+std::shared_ptr<const EphemerisStore::SetList> EphemerisStore::Sets(const uint8_t prn) const
+{
+  assert(prn >= 1 && prn <= MAX_PRN);
+  return sets_[prn - 1].load(std::memory_order_acquire);
+}
+
+std::shared_ptr<const NavigationSet> EphemerisStore::Select(const uint8_t prn, const double gps_time) const
+{
+  if (prn < 1 || prn > MAX_PRN) {
+    return nullptr;
+  }
+  std::shared_ptr<const SetList> sets = Sets(prn);
+  const NavigationSet* selected = Select(*sets, gps_time);
+  if (selected == nullptr) {
+    return nullptr;
+  }
+  // shares ownership of the whole snapshot
+  return std::shared_ptr<const NavigationSet>(std::move(sets), selected);
+}
+
+const NavigationSet* EphemerisStore::Select(const SetList& sets, const double gps_time)
+{
+  const NavigationSet* selected = nullptr;
+  double best = 0.0;
+  for (const NavigationSet& set : sets) {
+    double distance = std::abs(set.ephemeris.TimeFromEpoch(gps_time));
+    // later uploads win ties since sets are ordered by epoch
+    if (distance <= 0.5 * set.fit_interval && (selected == nullptr || distance <= best)) {
+      selected = &set;
+      best = distance;
+    }
+  }
+  return selected;
+}
+
+} // namespace Gps
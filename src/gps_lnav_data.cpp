@@ -183,6 +183,7 @@ void DataFrame::TimeIncrement()
     tow_ = tow_ % 403200;
     week_++;
   }
+  page_ = (page_ + 1) % 25;
 }
 
 Subframe DataFrame::ParityFrame(uint8_t sf)
@@ -337,6 +338,9 @@ void DataFrame::SetSubframe4()
     {57,25,26,27,28,57,29,30,31,32,57,62,52,53,54,57,55,56,58,59,57,60,61,62,63};
 
   Preamble(3);
+  for (uint8_t w = 2; w < 10; w++) {
+    subframes_[3][w].Reset();
+  }
 
   // First 2 bits data ID, 01 is only valid value
   subframes_[3][2].Set(1);
@@ -363,6 +367,25 @@ void DataFrame::SetSubframe4()
 
   if ((page_+1) == 18) {
     // ionospheric and UTC data
+    subframes_[3][2].SegmentSet(8, ParamToBinary(iono_data_.alpha[0], IonosphereDataScaleFactors.alpha[0]), 0, 7);
+    subframes_[3][2].SegmentSet(16, ParamToBinary(iono_data_.alpha[1], IonosphereDataScaleFactors.alpha[1]), 0, 7);
+    subframes_[3][3].SegmentSet(0, ParamToBinary(iono_data_.alpha[2], IonosphereDataScaleFactors.alpha[2]), 0, 7);
+    subframes_[3][3].SegmentSet(8, ParamToBinary(iono_data_.alpha[3], IonosphereDataScaleFactors.alpha[3]), 0, 7);
+    subframes_[3][3].SegmentSet(16, ParamToBinary(iono_data_.beta[0], IonosphereDataScaleFactors.beta[0]), 0, 7);
+    subframes_[3][4].SegmentSet(0, ParamToBinary(iono_data_.beta[1], IonosphereDataScaleFactors.beta[1]), 0, 7);
+    subframes_[3][4].SegmentSet(8, ParamToBinary(iono_data_.beta[2], IonosphereDataScaleFactors.beta[2]), 0, 7);
+    subframes_[3][4].SegmentSet(16, ParamToBinary(iono_data_.beta[3], IonosphereDataScaleFactors.beta[3]), 0, 7);
+
+    subframes_[3][5].SegmentSet(0, ParamToBinary(utc_data_.A_1, UtcDataScaleFactors.A_1), 0, 23);
+    uint32_t A0_bin = ParamToBinary(utc_data_.A_0, UtcDataScaleFactors.A_0);
+    subframes_[3][6].SegmentSet(0, A0_bin, 8, 31);
+    subframes_[3][7].SegmentSet(0, A0_bin, 0, 7);
+    subframes_[3][7].SegmentSet(8, ParamToBinary(utc_data_.t_ot, UtcDataScaleFactors.t_ot), 0, 7);
+    subframes_[3][7].SegmentSet(16, utc_data_.WN_t, 0, 7);
+    subframes_[3][8].SegmentSet(0, static_cast<uint8_t>(utc_data_.del_t_LS), 0, 7);
+    subframes_[3][8].SegmentSet(8, utc_data_.WN_LSF, 0, 7);
+    subframes_[3][8].SegmentSet(16, utc_data_.DN, 0, 7);
+    subframes_[3][9].SegmentSet(0, static_cast<uint8_t>(utc_data_.del_t_LSF), 0, 7);
     return;
   }
 
@@ -379,8 +402,8 @@ void DataFrame::SetSubframe5()
 
   Preamble(4);
 
-  subframes_[3][2].Set(1);
-  subframes_[3][2].SegmentSet(2,subframe5_ids[page_],0,5); // TODO cast id to uint32_t?
+  subframes_[4][2].Set(1);
+  subframes_[4][2].SegmentSet(2,subframe5_ids[page_],0,5); // TODO cast id to uint32_t?
 
   if ((page_ >= 0) || (page_ < 24)) {
     // almanac data
@@ -417,23 +440,13 @@ void DataFrame::LoadSubframe(uint8_t sf_i, Subframe& sf)
 
 void DataFrame::LoadPreamble(uint8_t sf_i, Subframe& sf)
 {
-  uint32_t preamble = 0b10001011;
-  if (sf[0].Val(0,7) == preamble)
-    std::cout << "preamble good\n";
-  else
-    std::cout << "preamble bad\n";
-
   tlm_message_ = sf[0].Val(8,21);
 
   integrity_status_flag_ = sf[0].Bit(22);
   tow_ = (sf[1].Val(0,16) << 2) - (sf_i * 4);
-  // std::cout << "recorded tow: " << tow_ << '\n';
-  std::cout << "tow: " << (sf[1].Val(0,16) << 2) << '\n';
 
   alert_flag_ = sf[1].Bit(17);
-  std::cout << "alert flag: " << alert_flag_ << '\n';
   anti_spoof_flag_ = sf[1].Bit(18);
-  std::cout << "anti-spoof flag: " << anti_spoof_flag_ << '\n';
 }
 
 void DataFrame::LoadSubframe1(Subframe& sf)
@@ -574,16 +587,29 @@ void DataFrame::LoadSubframe3(Subframe& sf)
 
 void DataFrame::LoadSubframe4(Subframe& sf)
 {
-  std::cout << "--- Loading Subframe 4 ---\n";
   LoadPreamble(3, sf);
-  std::cout << "this should be 4: " << sf[1].Val(19,21) << '\n';
-
-  if ( (sf[2].Bit(1)) && (!sf[2].Bit(0)) )
-    std::cout << "data ID is correct\n";
-  else
-    std::cout << "data ID is incorrect\n";
 
-  std::cout << "Almanac ID: " << sf[2].Val(2,7) << '\n';
+  if (sf[2].Val(2,7) == 56) {
+    // page 18, ionospheric and UTC data
+    iono_data_.alpha[0] = ParamFromBinary(sf[2].Val(8,15), IonosphereDataScaleFactors.alpha[0], 8, true);
+    iono_data_.alpha[1] = ParamFromBinary(sf[2].Val(16,23), IonosphereDataScaleFactors.alpha[1], 8, true);
+    iono_data_.alpha[2] = ParamFromBinary(sf[3].Val(0,7), IonosphereDataScaleFactors.alpha[2], 8, true);
+    iono_data_.alpha[3] = ParamFromBinary(sf[3].Val(8,15), IonosphereDataScaleFactors.alpha[3], 8, true);
+    iono_data_.beta[0] = ParamFromBinary(sf[3].Val(16,23), IonosphereDataScaleFactors.beta[0], 8, true);
+    iono_data_.beta[1] = ParamFromBinary(sf[4].Val(0,7), IonosphereDataScaleFactors.beta[1], 8, true);
+    iono_data_.beta[2] = ParamFromBinary(sf[4].Val(8,15), IonosphereDataScaleFactors.beta[2], 8, true);
+    iono_data_.beta[3] = ParamFromBinary(sf[4].Val(16,23), IonosphereDataScaleFactors.beta[3], 8, true);
+
+    utc_data_.A_1 = ParamFromBinary(sf[5].Val(0,23), UtcDataScaleFactors.A_1, 24, true);
+    uint32_t temp = (sf[6].Val(0,23) << 8) | sf[7].Val(0,7);
+    utc_data_.A_0 = ParamFromBinary(temp, UtcDataScaleFactors.A_0, 32, true);
+    utc_data_.t_ot = ParamFromBinary(sf[7].Val(8,15), UtcDataScaleFactors.t_ot, 8, false);
+    utc_data_.WN_t = sf[7].Val(16,23);
+    utc_data_.del_t_LS = static_cast<int8_t>(sf[8].Val(0,7));
+    utc_data_.WN_LSF = sf[8].Val(8,15);
+    utc_data_.DN = sf[8].Val(16,23);
+    utc_data_.del_t_LSF = static_cast<int8_t>(sf[9].Val(0,7));
+  }
 }
 
 void DataFrame::LoadSubframe5(Subframe& sf)
@@ -706,6 +732,164 @@ int16_t DataFrame::IDOT()
   return ParamToBinary(ephemeris_.IDOT, EphemerisScaleFactors.IDOT);
 }
 
+namespace internal
+{
+  // Parameter blocks are written field by field, so the layout has no struct padding in it
+  void SaveClock(std::ostream& os, const ClockData& clock)
+  {
+    WriteBinary(os, clock.T_GD);
+    WriteBinary(os, clock.t_oc);
+    WriteBinary(os, clock.a_f0);
+    WriteBinary(os, clock.a_f1);
+    WriteBinary(os, clock.a_f2);
+    WriteBinary(os, clock.IODC);
+  }
+
+  void LoadClock(std::istream& is, ClockData& clock)
+  {
+    ReadBinary(is, clock.T_GD);
+    ReadBinary(is, clock.t_oc);
+    ReadBinary(is, clock.a_f0);
+    ReadBinary(is, clock.a_f1);
+    ReadBinary(is, clock.a_f2);
+    ReadBinary(is, clock.IODC);
+  }
+
+  void SaveEphemeris(std::ostream& os, const Ephemeris& eph)
+  {
+    WriteBinary(os, eph.M_0);
+    WriteBinary(os, eph.del_n);
+    WriteBinary(os, eph.e);
+    WriteBinary(os, eph.sqrtA);
+    WriteBinary(os, eph.Omega_0);
+    WriteBinary(os, eph.i_0);
+    WriteBinary(os, eph.omega);
+    WriteBinary(os, eph.Omega_dot);
+    WriteBinary(os, eph.IDOT);
+    WriteBinary(os, eph.C_uc);
+    WriteBinary(os, eph.C_us);
+    WriteBinary(os, eph.C_rc);
+    WriteBinary(os, eph.C_rs);
+    WriteBinary(os, eph.C_ic);
+    WriteBinary(os, eph.C_is);
+    WriteBinary(os, eph.t_oe);
+    WriteBinary(os, eph.IODE);
+  }
+
+  void LoadEphemeris(std::istream& is, Ephemeris& eph)
+  {
+    ReadBinary(is, eph.M_0);
+    ReadBinary(is, eph.del_n);
+    ReadBinary(is, eph.e);
+    ReadBinary(is, eph.sqrtA);
+    ReadBinary(is, eph.Omega_0);
+    ReadBinary(is, eph.i_0);
+    ReadBinary(is, eph.omega);
+    ReadBinary(is, eph.Omega_dot);
+    ReadBinary(is, eph.IDOT);
+    ReadBinary(is, eph.C_uc);
+    ReadBinary(is, eph.C_us);
+    ReadBinary(is, eph.C_rc);
+    ReadBinary(is, eph.C_rs);
+    ReadBinary(is, eph.C_ic);
+    ReadBinary(is, eph.C_is);
+    ReadBinary(is, eph.t_oe);
+    ReadBinary(is, eph.IODE);
+  }
+
+  void SaveUtc(std::ostream& os, const UtcData& utc)
+  {
+    WriteBinary(os, utc.A_0);
+    WriteBinary(os, utc.A_1);
+    WriteBinary(os, utc.t_ot);
+    WriteBinary(os, utc.WN_t);
+    WriteBinary(os, utc.del_t_LS);
+    WriteBinary(os, utc.WN_LSF);
+    WriteBinary(os, utc.DN);
+    WriteBinary(os, utc.del_t_LSF);
+  }
+
+  void LoadUtc(std::istream& is, UtcData& utc)
+  {
+    ReadBinary(is, utc.A_0);
+    ReadBinary(is, utc.A_1);
+    ReadBinary(is, utc.t_ot);
+    ReadBinary(is, utc.WN_t);
+    ReadBinary(is, utc.del_t_LS);
+    ReadBinary(is, utc.WN_LSF);
+    ReadBinary(is, utc.DN);
+    ReadBinary(is, utc.del_t_LSF);
+  }
+}
+
+void DataFrame::Save(std::ostream& os) const
+{
+  for (const Subframe& sf : subframes_) {
+    for (uint8_t w = 0; w < 10; w++) {
+      WriteBinary(os, sf[w].Val());
+    }
+  }
+  internal::SaveClock(os, clock_data_);
+  internal::SaveEphemeris(os, ephemeris_);
+  WriteBinary(os, iono_data_.alpha);
+  WriteBinary(os, iono_data_.beta);
+  internal::SaveUtc(os, utc_data_);
+  WriteBinary(os, tlm_message_);
+  WriteBinary(os, tow_);
+  WriteBinary(os, week_);
+  WriteBinary(os, integrity_status_flag_);
+  WriteBinary(os, alert_flag_);
+  WriteBinary(os, anti_spoof_flag_);
+  WriteBinary(os, l2_flag_);
+  WriteBinary(os, URA_);
+  WriteBinary(os, health_);
+  WriteBinary(os, l2p_flag_);
+  WriteBinary(os, fit_interval_flag_);
+  WriteBinary(os, AODO_);
+  WriteBinary(os, page_);
+  WriteBinary(os, D29_);
+  WriteBinary(os, D30_);
+  WriteBinary(os, sf1w4_reserved_);
+  WriteBinary(os, sf1w5_reserved_);
+  WriteBinary(os, sf1w6_reserved_);
+  WriteBinary(os, sf1w7_reserved_);
+}
+
+bool DataFrame::Load(std::istream& is)
+{
+  for (Subframe& sf : subframes_) {
+    for (uint8_t w = 0; w < 10; w++) {
+      uint32_t bits;
+      ReadBinary(is, bits);
+      sf[w].SetVal(bits);
+    }
+  }
+  internal::LoadClock(is, clock_data_);
+  internal::LoadEphemeris(is, ephemeris_);
+  ReadBinary(is, iono_data_.alpha);
+  ReadBinary(is, iono_data_.beta);
+  internal::LoadUtc(is, utc_data_);
+  ReadBinary(is, tlm_message_);
+  ReadBinary(is, tow_);
+  ReadBinary(is, week_);
+  ReadBinary(is, integrity_status_flag_);
+  ReadBinary(is, alert_flag_);
+  ReadBinary(is, anti_spoof_flag_);
+  ReadBinary(is, l2_flag_);
+  ReadBinary(is, URA_);
+  ReadBinary(is, health_);
+  ReadBinary(is, l2p_flag_);
+  ReadBinary(is, fit_interval_flag_);
+  ReadBinary(is, AODO_);
+  ReadBinary(is, page_);
+  ReadBinary(is, D29_);
+  ReadBinary(is, D30_);
+  ReadBinary(is, sf1w4_reserved_);
+  ReadBinary(is, sf1w5_reserved_);
+  ReadBinary(is, sf1w6_reserved_);
+  return ReadBinary(is, sf1w7_reserved_);
+}
+
 void DataFrame::RandomizeParams()
 {
   clock_data_.Randomize();
@@ -0,0 +1,249 @@
+#include <cmath>
+
+#include <Eigen/Dense>
+
+#include "gps_common.hpp"
+#include "gps_coordinates.hpp"
+#include "gps_navigation.hpp"
+#include "parallel_ops.hpp"
+
+namespace Gps
+{
+
+namespace
+{
+  // Satellite position rotated into the ECEF frame at receive time by its light time
+  Eigen::Vector3d RotatedSatellite(const PvtMeasurement& measurement, const Eigen::Vector3d& rx_pos)
+  {
+    double theta = Ephemeris::WGS84_EARTH_RATE * (measurement.sat_pos - rx_pos).norm() / LIGHT_SPEED;
+    double c = std::cos(theta);
+    double s = std::sin(theta);
+    const Eigen::Vector3d& p = measurement.sat_pos;
+    return Eigen::Vector3d((c * p(0)) + (s * p(1)), (c * p(1)) - (s * p(0)), p(2));
+  }
+}
+
+
+void MakePvtMeasurement(const PreparedEphemeris& orbit, const ClockData& clock_data, const double receive_time,
+  const double pseudorange, PvtMeasurement& measurement)
+{
+  double transmit_time = receive_time - (pseudorange / LIGHT_SPEED);
+  double clock = clock_data.Offset(transmit_time) - clock_data.T_GD + orbit.RelTime(transmit_time);
+  // the satellite clock shifts the true transmit time
+  transmit_time -= clock;
+  orbit.P(transmit_time, measurement.sat_pos);
+  measurement.sat_clock = clock;
+  measurement.pseudorange = pseudorange;
+}
+
+void MakePvtMeasurement(const PreparedEphemeris& orbit, const ClockData& clock_data, const double receive_time,
+  const double pseudorange, const double pseudorange_rate, PvtMeasurement& measurement)
+{
+  double transmit_time = receive_time - (pseudorange / LIGHT_SPEED);
+  double clock = clock_data.Offset(transmit_time) - clock_data.T_GD + orbit.RelTime(transmit_time);
+  transmit_time -= clock;
+  OrbitState state;
+  orbit.Evaluate(transmit_time, state);
+  measurement.sat_pos = state.pos;
+  measurement.sat_vel = state.vel;
+  measurement.sat_clock = clock;
+  measurement.sat_clock_rate = clock_data.OffsetRate(transmit_time) + state.rel_time_rate;
+  measurement.pseudorange = pseudorange;
+  measurement.pseudorange_rate = pseudorange_rate;
+}
+
+bool SolvePvt(const PvtMeasurement* measurements, const std::size_t count, PvtSolution& solution,
+  const Eigen::Vector4d& initial, const unsigned int max_iterations, const double max_step)
+{
+  solution = PvtSolution();
+  solution.num_satellites = count;
+  if (count < 4) return false;
+
+  Eigen::Vector4d state = initial;
+  bool converged = false;
+  for (unsigned int iteration = 1; iteration <= max_iterations && !converged; iteration++) {
+    Eigen::Matrix4d normal = Eigen::Matrix4d::Zero();
+    Eigen::Vector4d rhs = Eigen::Vector4d::Zero();
+    const Eigen::Vector3d rx_pos = state.head<3>();
+    for (std::size_t i = 0; i < count; i++) {
+      const PvtMeasurement& measurement = measurements[i];
+      Eigen::Vector3d los = RotatedSatellite(measurement, rx_pos) - rx_pos;
+      double range = los.norm();
+      Eigen::Vector4d h;
+      h << -los / range, 1.0;
+      double residual = measurement.pseudorange + (LIGHT_SPEED * measurement.sat_clock) - (range + state(3));
+      normal.selfadjointView<Eigen::Lower>().rankUpdate(h, measurement.weight);
+      rhs += measurement.weight * residual * h;
+    }
+
+    Eigen::LDLT<Eigen::Matrix4d> ldlt(normal.selfadjointView<Eigen::Lower>());
+    // rank deficient geometry leaves a (near) zero pivot
+    const Eigen::Vector4d& pivots = ldlt.vectorD();
+    if ((ldlt.info() != Eigen::Success) || !(pivots.minCoeff() > 1.0e-12 * pivots.maxCoeff())) return false;
+    Eigen::Vector4d step = ldlt.solve(rhs);
+    if (!step.allFinite()) return false;
+    state += step;
+    solution.iterations = iteration;
+    converged = step.head<3>().norm() < max_step;
+  }
+  if (!converged) return false;
+
+  // residuals and unweighted geometry at the solution
+  Eigen::Matrix4d geometry = Eigen::Matrix4d::Zero();
+  double weighted_square_sum = 0.0;
+  double weight_sum = 0.0;
+  const Eigen::Vector3d rx_pos = state.head<3>();
+  for (std::size_t i = 0; i < count; i++) {
+    const PvtMeasurement& measurement = measurements[i];
+    Eigen::Vector3d los = RotatedSatellite(measurement, rx_pos) - rx_pos;
+    double range = los.norm();
+    Eigen::Vector4d h;
+    h << -los / range, 1.0;
+    double residual = measurement.pseudorange + (LIGHT_SPEED * measurement.sat_clock) - (range + state(3));
+    geometry.selfadjointView<Eigen::Lower>().rankUpdate(h);
+    weighted_square_sum += measurement.weight * residual * residual;
+    weight_sum += measurement.weight;
+  }
+  Eigen::Matrix4d cofactor = Eigen::Matrix4d(geometry.selfadjointView<Eigen::Lower>()).inverse();
+  Eigen::Matrix3d rotation = EcefToEnuRotation(rx_pos);
+  Eigen::Matrix3d local = rotation * cofactor.topLeftCorner<3,3>() * rotation.transpose();
+
+  solution.pos = rx_pos;
+  solution.clock_bias = state(3);
+  solution.gdop = std::sqrt(cofactor.trace());
+  solution.pdop = std::sqrt(cofactor.topLeftCorner<3,3>().trace());
+  solution.hdop = std::sqrt(local(0,0) + local(1,1));
+  solution.vdop = std::sqrt(local(2,2));
+  solution.tdop = std::sqrt(cofactor(3,3));
+  solution.residual_rms = std::sqrt(weighted_square_sum / weight_sum);
+  solution.valid = true;
+  return true;
+}
+
+bool SolvePvt(const PvtEpoch& epoch, PvtSolution& solution)
+{
+  return SolvePvt(epoch.measurements.data(), epoch.count, solution);
+}
+
+void SolvePvt(const PvtEpoch* epochs, const std::size_t count, PvtSolution* solutions,
+  const unsigned int num_threads)
+{
+  ParallelFor(count, [epochs, solutions](const std::size_t i)
+  {
+    SolvePvt(epochs[i], solutions[i]);
+  }, num_threads);
+}
+
+
+void NavigationFilter::Initialize(const double gps_time, const Filter::StateVector& state,
+  const Filter::StateMatrix& covariance)
+{
+  time_ = gps_time;
+  filter_.Initialize(state, covariance);
+}
+
+void NavigationFilter::Initialize(const double gps_time, const PvtSolution& solution, const double position_sigma,
+  const double velocity_sigma, const double clock_drift_sigma)
+{
+  Filter::StateVector state = Filter::StateVector::Zero();
+  state.head<3>() = solution.pos;
+  state(6) = solution.clock_bias;
+  Filter::StateVector variances;
+  variances << Eigen::Vector3d::Constant(position_sigma * position_sigma),
+               Eigen::Vector3d::Constant(velocity_sigma * velocity_sigma),
+               position_sigma * position_sigma, clock_drift_sigma * clock_drift_sigma;
+  Initialize(gps_time, state, variances.asDiagonal().toDenseMatrix());
+}
+
+void NavigationFilter::Predict(const double gps_time)
+{
+  const double dt = gps_time - time_;
+  time_ = gps_time;
+  if (dt == 0.0) return;
+
+  const double dt2 = dt * dt / 2.0;
+  const double dt3 = dt * dt * dt / 3.0;
+  Filter::StateMatrix transition = Filter::StateMatrix::Identity();
+  Filter::StateMatrix process_noise = Filter::StateMatrix::Zero();
+  for (int axis = 0; axis < 3; axis++) {
+    transition(axis, axis + 3) = dt;
+    process_noise(axis, axis) = config_.accel_psd * dt3;
+    process_noise(axis, axis + 3) = config_.accel_psd * dt2;
+    process_noise(axis + 3, axis) = config_.accel_psd * dt2;
+    process_noise(axis + 3, axis + 3) = config_.accel_psd * dt;
+  }
+  transition(6,7) = dt;
+  process_noise(6,6) = (config_.clock_bias_psd * dt) + (config_.clock_drift_psd * dt3);
+  process_noise(6,7) = config_.clock_drift_psd * dt2;
+  process_noise(7,6) = config_.clock_drift_psd * dt2;
+  process_noise(7,7) = config_.clock_drift_psd * dt;
+  filter_.Predict(transition, process_noise);
+}
+
+std::size_t NavigationFilter::Update(const double gps_time, const PvtMeasurement* measurements,
+  const std::size_t count)
+{
+  constexpr double omega_e = Ephemeris::WGS84_EARTH_RATE;
+  Predict(gps_time);
+
+  // each measurement is linearized at the state left by the previous one
+  std::size_t applied = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    const PvtMeasurement& measurement = measurements[i];
+    const Filter::StateVector& state = filter_.State();
+    const Eigen::Vector3d rx_pos = state.head<3>();
+    double theta = omega_e * (measurement.sat_pos - rx_pos).norm() / LIGHT_SPEED;
+    double c = std::cos(theta);
+    double s = std::sin(theta);
+    const Eigen::Vector3d& p = measurement.sat_pos;
+    Eigen::Vector3d sat_pos((c * p(0)) + (s * p(1)), (c * p(1)) - (s * p(0)), p(2));
+    Eigen::Vector3d los = sat_pos - rx_pos;
+    double range = los.norm();
+    Eigen::Vector3d unit = los / range;
+
+    Filter::MeasurementRow jacobian = Filter::MeasurementRow::Zero();
+    jacobian.head<3>() = -unit.transpose();
+    jacobian(6) = 1.0;
+    double innovation = measurement.pseudorange + (LIGHT_SPEED * measurement.sat_clock) - (range + state(6));
+    applied += filter_.Update(innovation, jacobian, 1.0 / measurement.weight, config_.gate);
+
+    if (measurement.rate_weight > 0.0) {
+      // same geometry, velocities from the updated state
+      const Filter::StateVector& updated = filter_.State();
+      const Eigen::Vector3d& v = measurement.sat_vel;
+      Eigen::Vector3d sat_vel((c * v(0)) + (s * v(1)), (c * v(1)) - (s * v(0)), v(2));
+      Eigen::Vector3d relative_vel = sat_vel - updated.segment<3>(3);
+      // d(range)/d(receive time) includes the light-time factor, as in ObservableModel
+      Eigen::Vector3d w((omega_e * sat_pos(1)) - sat_vel(0), (-omega_e * sat_pos(0)) - sat_vel(1), -sat_vel(2));
+      double light_time_factor = 1.0 / (1.0 - (unit.dot(w) / LIGHT_SPEED));
+      double range_rate = unit.dot(relative_vel);
+      jacobian.setZero();
+      jacobian.head<3>() = -light_time_factor * (relative_vel - (range_rate * unit)).transpose() / range;
+      jacobian.segment<3>(3) = -light_time_factor * unit.transpose();
+      jacobian(7) = 1.0;
+      double rate_innovation = measurement.pseudorange_rate + (LIGHT_SPEED * measurement.sat_clock_rate)
+                             - ((light_time_factor * range_rate) + updated(7));
+      applied += filter_.Update(rate_innovation, jacobian, 1.0 / measurement.rate_weight, config_.gate);
+    }
+  }
+  filter_.Symmetrize();
+  return applied;
+}
+
+std::size_t NavigationFilter::Update(const double gps_time, const PvtEpoch& epoch)
+{
+  return Update(gps_time, epoch.measurements.data(), epoch.count);
+}
+
+void UpdateNavigationFilters(NavigationFilter* filters, const std::size_t count, const double* times,
+  const PvtEpoch* epochs, const std::size_t num_epochs, const unsigned int num_threads)
+{
+  ParallelFor(count, [filters, count, times, epochs, num_epochs](const std::size_t r)
+  {
+    for (std::size_t k = 0; k < num_epochs; k++) {
+      filters[r].Update(times[k], epochs[(k * count) + r]);
+    }
+  }, num_threads);
+}
+
+} // namespace Gps
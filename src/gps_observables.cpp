@@ -0,0 +1,171 @@
+#include <cmath>
+#include <cassert>
+
+#include <Eigen/Dense>
+
+#include "gps_common.hpp"
+#include "gps_observables.hpp"
+#include "parallel_ops.hpp"
+
+namespace Gps
+{
+
+ObservableModel::ObservableModel(const std::vector<Ephemeris>& ephemerides,
+  const std::vector<ClockData>& clock_data, const double reference_interval, const unsigned int num_threads)
+  : orbits_(ephemerides.begin(), ephemerides.end()), clock_data_{clock_data},
+    reference_interval_{reference_interval}, num_threads_{num_threads},
+    reference_states_(ephemerides.size()), jerk_(ephemerides.size()), clock_(ephemerides.size()), clock_rate_(ephemerides.size()),
+    clock_rate_rate_(ephemerides.size())
+{
+  assert(ephemerides.size() == clock_data.size());
+}
+
+void ObservableModel::Refresh(const double reference_time)
+{
+  reference_time_ = reference_time;
+  has_reference_ = true;
+  for (std::size_t s = 0; s < orbits_.size(); s++) {
+    // acceleration and jerk by central differences of the ephemeris velocity, the force model in
+    // PreparedEphemeris differs from the broadcast fit by up to ~3e-3 m/s^2
+    constexpr double h = 0.5;
+    OrbitState& state = reference_states_[s];
+    OrbitState before, after;
+    orbits_[s].Evaluate(reference_time, state);
+    orbits_[s].Evaluate<true,false,false>(reference_time - h, before);
+    orbits_[s].Evaluate<true,false,false>(reference_time + h, after);
+    state.accel = (after.vel - before.vel) / (2.0 * h);
+    jerk_[s] = (after.vel - (2.0 * state.vel) + before.vel) / (h * h);
+    const ClockData& clock_data = clock_data_[s];
+    clock_[s] = clock_data.Offset(reference_time) - clock_data.T_GD + state.rel_time;
+    clock_rate_[s] = clock_data.OffsetRate(reference_time) + state.rel_time_rate;
+    clock_rate_rate_[s] = clock_data.OffsetRateRate() + state.rel_time_rate_rate;
+  }
+}
+
+void ObservableModel::Compute(const double gps_time, const SoaVector3& rx_pos, ObservableBatch& obs)
+{
+  SoaVector3 zeros = SoaVector3::Zero(rx_pos.rows(), 3);
+  Compute(gps_time, rx_pos, zeros, zeros, obs);
+}
+
+void ObservableModel::Compute(const double gps_time, const SoaVector3& rx_pos, const SoaVector3& rx_vel,
+  const SoaVector3& rx_acc, ObservableBatch& obs)
+{
+  assert(rx_vel.rows() == rx_pos.rows() && rx_acc.rows() == rx_pos.rows());
+  constexpr double nominal_light_time = 0.075;
+  double target = gps_time - nominal_light_time;
+  if (!has_reference_ || std::abs(target - reference_time_) > 0.5 * reference_interval_) {
+    Refresh(target);
+  }
+
+  const Eigen::Index num_receivers = rx_pos.rows();
+  const Eigen::Index num_sats = static_cast<Eigen::Index>(orbits_.size());
+  for (Eigen::MatrixXd* values : {&obs.pseudorange, &obs.pseudorange_rate, &obs.pseudorange_accel,
+                                  &obs.transmit_time}) {
+    values->resize(num_receivers, num_sats);
+  }
+
+  const std::size_t num_pairs = static_cast<std::size_t>(num_receivers) * orbits_.size();
+  ParallelFor(orbits_.size(), [&](const std::size_t sat)
+  {
+    ComputeSatellite(sat, gps_time, rx_pos, rx_vel, rx_acc, obs);
+  }, ThreadsForWork(num_threads_, num_pairs, MIN_PAIRS_PER_THREAD));
+}
+
+void ObservableModel::ComputeSatellite(const std::size_t sat, const double gps_time, const SoaVector3& rx_pos,
+  const SoaVector3& rx_vel, const SoaVector3& rx_acc, ObservableBatch& obs) const
+{
+  constexpr double omega_e = Ephemeris::WGS84_EARTH_RATE;
+  const double inv_c = 1.0 / LIGHT_SPEED;
+  const OrbitState& ref = reference_states_[sat];
+  const double px = ref.pos(0), py = ref.pos(1), pz = ref.pos(2);
+  const double vx = ref.vel(0), vy = ref.vel(1), vz = ref.vel(2);
+  const double ax = ref.accel(0), ay = ref.accel(1), az = ref.accel(2);
+  const double jx = jerk_[sat](0), jy = jerk_[sat](1), jz = jerk_[sat](2);
+  const double clock = clock_[sat];
+  const double clock_rate = clock_rate_[sat];
+  const double clock_rate_rate = clock_rate_rate_[sat];
+  const double dt_rx = gps_time - reference_time_;
+
+  const double* rx = rx_pos.col(0).data();
+  const double* ry = rx_pos.col(1).data();
+  const double* rz = rx_pos.col(2).data();
+  const double* rvx = rx_vel.col(0).data();
+  const double* rvy = rx_vel.col(1).data();
+  const double* rvz = rx_vel.col(2).data();
+  const double* rax = rx_acc.col(0).data();
+  const double* ray = rx_acc.col(1).data();
+  const double* raz = rx_acc.col(2).data();
+  double* pseudorange = obs.pseudorange.col(sat).data();
+  double* pseudorange_rate = obs.pseudorange_rate.col(sat).data();
+  double* pseudorange_accel = obs.pseudorange_accel.col(sat).data();
+  double* transmit_time = obs.transmit_time.col(sat).data();
+
+  // outputs never alias the receiver states; too many arrays for GCC's runtime alias checks
+#if defined(__GNUC__) && !defined(__clang__)
+  #pragma GCC ivdep
+#endif
+  for (Eigen::Index r = 0; r < rx_pos.rows(); r++) {
+    // light time from the reference state, then two fixed iterations
+    double dx = px - rx[r], dy = py - ry[r], dz = pz - rz[r];
+    double light_time = std::sqrt((dx * dx) + (dy * dy) + (dz * dz)) * inv_c;
+    double tx, ty, tz, dt, theta, cos_theta;
+    for (int i = 0; i < 3; i++) {
+      dt = dt_rx - light_time;
+      double dt2 = 0.5 * dt * dt;
+      double dt3 = dt2 * dt / 3.0;
+      double x = px + (vx * dt) + (ax * dt2) + (jx * dt3);
+      double y = py + (vy * dt) + (ay * dt2) + (jy * dt3);
+      double z = pz + (vz * dt) + (az * dt2) + (jz * dt3);
+
+      // Sagnac: transmit position in the ECEF frame at receive time
+      theta = omega_e * light_time;
+      cos_theta = 1.0 - (0.5 * theta * theta);
+      tx = (cos_theta * x) + (theta * y);
+      ty = (cos_theta * y) - (theta * x);
+      tz = z;
+      dx = tx - rx[r];
+      dy = ty - ry[r];
+      dz = tz - rz[r];
+      if (i < 2) {
+        light_time = std::sqrt((dx * dx) + (dy * dy) + (dz * dz)) * inv_c;
+      }
+    }
+
+    double dt2 = 0.5 * dt * dt;
+    double sat_vx = vx + (ax * dt) + (jx * dt2);
+    double sat_vy = vy + (ay * dt) + (jy * dt2);
+    double sat_ax = ax + (jx * dt);
+    double sat_ay = ay + (jy * dt);
+    double vel_x = (cos_theta * sat_vx) + (theta * sat_vy) - rvx[r];
+    double vel_y = (cos_theta * sat_vy) - (theta * sat_vx) - rvy[r];
+    double vel_z = vz + (az * dt) + (jz * dt2) - rvz[r];
+    double acc_x = (cos_theta * sat_ax) + (theta * sat_ay) - rax[r];
+    double acc_y = (cos_theta * sat_ay) - (theta * sat_ax) - ray[r];
+    double acc_z = az + (jz * dt) - raz[r];
+
+    double range = std::sqrt((dx * dx) + (dy * dy) + (dz * dz));
+    double inv_range = 1.0 / range;
+
+    // d(range)/d(receive time) = u.(v_sat - v_rx) / (1 - u.w / c), w = d(transmit position)/d(light time)
+    double w_x = (omega_e * ty) - (vel_x + rvx[r]);
+    double w_y = (-omega_e * tx) - (vel_y + rvy[r]);
+    double w_z = -(vel_z + rvz[r]);
+    double light_time_factor = 1.0 / (1.0 - (((dx * w_x) + (dy * w_y) + (dz * w_z)) * inv_range * inv_c));
+    double range_rate = ((dx * vel_x) + (dy * vel_y) + (dz * vel_z)) * inv_range * light_time_factor;
+    double speed2 = (vel_x * vel_x) + (vel_y * vel_y) + (vel_z * vel_z);
+    double range_accel = (((dx * acc_x) + (dy * acc_y) + (dz * acc_z)) * inv_range)
+                       + ((speed2 - (range_rate * range_rate)) * inv_range);
+
+    // satellite clock at transmit time, expanded about the reference
+    double sat_clock = clock + (clock_rate * dt) + (0.5 * clock_rate_rate * dt * dt);
+    double sat_clock_rate = clock_rate + (clock_rate_rate * dt);
+
+    pseudorange[r] = range - (LIGHT_SPEED * sat_clock);
+    pseudorange_rate[r] = range_rate - (LIGHT_SPEED * sat_clock_rate);
+    pseudorange_accel[r] = range_accel - (LIGHT_SPEED * clock_rate_rate);
+    transmit_time[r] = gps_time - (pseudorange[r] * inv_c);
+  }
+}
+
+} // namespace Gps
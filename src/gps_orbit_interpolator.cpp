@@ -0,0 +1,199 @@
+#include <cmath>
+#include <numbers>
+#include <cassert>
+#include <algorithm>
+
+#include <Eigen/Dense>
+
+#include "gps_orbit_interpolator.hpp"
+
+namespace Gps
+{
+
+OrbitInterpolator::OrbitInterpolator(const Ephemeris& ephemeris, const ClockData& clock_data, const double window,
+  const double position_tolerance)
+  : orbit_{ephemeris}, clock_data_{clock_data}, t_oe_{ephemeris.t_oe}, window_{window}, inv_half_window_{2.0 / window},
+    position_tolerance_{position_tolerance}
+{
+  assert(window > 0.0);
+  Fit(0.0);
+}
+
+void OrbitInterpolator::PositionVelocity(const double gps_time, Eigen::Vector3d& pos, Eigen::Vector3d& vel)
+{
+  double x = Normalize(gps_time);
+  pos = Horner(coeffs_, degree_, x).head<3>();
+  vel = Horner(deriv_coeffs_, degree_, x).head<3>();
+}
+
+void OrbitInterpolator::Positions(const double* gps_times, const std::size_t count, Eigen::Matrix3Xd& pos,
+  double* clock)
+{
+  alignas(64) double t_k[BLOCK_SIZE];
+  alignas(64) double x[BLOCK_SIZE];
+  pos.resize(3, count);
+  std::size_t start = 0;
+  // whole blocks within one window, fixed trip counts so the passes vectorize even at -O2
+  for (; start + BLOCK_SIZE <= count; start += BLOCK_SIZE) {
+    const double* times = gps_times + start;
+    const double t_oe = t_oe_;
+    const double window_start = window_start_;
+    const double window_end = window_start_ + window_;
+    const double inv_half_window = inv_half_window_;
+
+    // as Normalize, in two passes that vectorize
+    for (std::size_t i = 0; i < BLOCK_SIZE; i++) {
+      double t = times[i] - t_oe;
+      double forward = (t < -302400.0) ? 604800.0 : 0.0;
+      double back = (t > 302400.0) ? 604800.0 : 0.0;
+      t_k[i] = t + forward - back;
+    }
+    double outside = 0.0;
+    for (std::size_t i = 0; i < BLOCK_SIZE; i++) {
+      outside += ((t_k[i] < window_start) | (t_k[i] >= window_end)) ? 1.0 : 0.0;
+      x[i] = ((t_k[i] - window_start) * inv_half_window) - 1.0;
+    }
+
+    if (outside == 0.0) {
+      EvaluateBlock<MIN_DEGREE>(x, pos.data() + (3 * start), clock ? (clock + start) : nullptr);
+    } else {
+      PositionsSingle(times, BLOCK_SIZE, pos.data() + (3 * start), clock ? (clock + start) : nullptr);
+    }
+  }
+  PositionsSingle(gps_times + start, count - start, pos.data() + (3 * start), clock ? (clock + start) : nullptr);
+}
+
+void OrbitInterpolator::PositionsSingle(const double* gps_times, const std::size_t count, double* pos, double* clock)
+{
+  for (std::size_t i = 0; i < count; i++) {
+    Eigen::Array4d state = Horner(coeffs_, degree_, Normalize(gps_times[i]));
+    pos[3 * i] = state(0);
+    pos[(3 * i) + 1] = state(1);
+    pos[(3 * i) + 2] = state(2);
+    if (clock) clock[i] = state(3);
+  }
+}
+
+template<unsigned int Degree>
+void OrbitInterpolator::EvaluateBlock(const double* x, double* pos, double* clock) const
+{
+  if constexpr (Degree < MAX_DEGREE) {
+    if (degree_ != Degree) {
+      EvaluateBlock<Degree + 1>(x, pos, clock);
+      return;
+    }
+  }
+
+  // one component at a time, each a loop over time with the Horner steps unrolled
+  alignas(64) double sums[4][BLOCK_SIZE];
+  const int num_components = clock ? 4 : 3;
+  for (int m = 0; m < num_components; m++) {
+    double c[Degree + 1];
+    for (unsigned int k = 0; k <= Degree; k++) {
+      c[k] = coeffs_[k](m);
+    }
+    double* sum = sums[m];
+    for (std::size_t i = 0; i < BLOCK_SIZE; i++) {
+      double value = c[Degree];
+#if defined(__GNUC__) && !defined(__clang__)
+      #pragma GCC unroll 16
+#endif
+      for (unsigned int k = Degree; k > 0; k--) {
+        value = (value * x[i]) + c[k - 1];
+      }
+      sum[i] = value;
+    }
+  }
+  for (std::size_t i = 0; i < BLOCK_SIZE; i++) {
+    pos[3 * i] = sums[0][i];
+    pos[(3 * i) + 1] = sums[1][i];
+    pos[(3 * i) + 2] = sums[2][i];
+  }
+  if (clock) std::copy(sums[3], sums[3] + BLOCK_SIZE, clock);
+}
+
+void OrbitInterpolator::TrueState(const double t_k, double* state) const
+{
+  const Ephemeris& eph = orbit_.Parameters();
+  OrbitState orbit_state;
+  orbit_.Evaluate<false,false,true>(eph.t_oe + t_k, orbit_state);
+  state[0] = orbit_state.pos(0);
+  state[1] = orbit_state.pos(1);
+  state[2] = orbit_state.pos(2);
+  state[3] = clock_data_.Offset(eph.t_oe + t_k) + orbit_state.rel_time;
+}
+
+void OrbitInterpolator::Fit(const double t_k)
+{
+  window_start_ = std::floor(t_k / window_) * window_;
+  const double half_window = 0.5 * window_;
+  double node_states[4 * (MAX_DEGREE + 1)];
+  double truth[4];
+
+  for (unsigned int degree = MIN_DEGREE; degree <= MAX_DEGREE; degree++) {
+    const double num_nodes = static_cast<double>(degree + 1);
+    for (unsigned int j = 0; j <= degree; j++) {
+      double x = std::cos(std::numbers::pi * (j + 0.5) / num_nodes);
+      TrueState(window_start_ + ((x + 1.0) * half_window), &node_states[4 * j]);
+    }
+    FitDegree(node_states, degree);
+
+    // check midway between nodes and at the window edges, where the error peaks
+    position_error_ = 0.0;
+    clock_error_ = 0.0;
+    for (unsigned int j = 0; j <= degree + 1; j++) {
+      double x = std::cos(std::numbers::pi * j / num_nodes);
+      x = std::clamp(x, -1.0, 1.0);
+      TrueState(window_start_ + ((x + 1.0) * half_window), truth);
+      Eigen::Array4d error = Horner(coeffs_, degree, x) - Eigen::Array4d(truth[0], truth[1], truth[2], truth[3]);
+      position_error_ = std::max(position_error_, error.head<3>().matrix().norm());
+      clock_error_ = std::max(clock_error_, std::abs(error(3)));
+    }
+    degree_ = degree;
+    if (position_error_ <= position_tolerance_) break;
+  }
+}
+
+void OrbitInterpolator::FitDegree(const double* node_states, const unsigned int degree)
+{
+  const double num_nodes = static_cast<double>(degree + 1);
+  Coefficients chebyshev {};
+  for (unsigned int k = 0; k <= MAX_DEGREE; k++) {
+    chebyshev[k].setZero();
+    coeffs_[k].setZero();
+    deriv_coeffs_[k].setZero();
+  }
+
+  // c_k = 2/(N+1) sum_j f(x_j) T_k(x_j), halved for k = 0
+  for (unsigned int k = 0; k <= degree; k++) {
+    double scale = ((k == 0) ? 1.0 : 2.0) / num_nodes;
+    for (unsigned int j = 0; j <= degree; j++) {
+      double T_k = std::cos(std::numbers::pi * k * (j + 0.5) / num_nodes);
+      chebyshev[k] += scale * T_k * Eigen::Array4d::Map(&node_states[4 * j]);
+    }
+  }
+
+  // to powers of x, with the power coefficients of T_k from T_{k+1} = 2x T_k - T_{k-1}
+  std::array<double,MAX_DEGREE + 2> T_prev {};
+  std::array<double,MAX_DEGREE + 2> T_k {};
+  T_k[0] = 1.0;
+  for (unsigned int k = 0; k <= degree; k++) {
+    for (unsigned int j = 0; j <= k; j++) {
+      coeffs_[j] += chebyshev[k] * T_k[j];
+    }
+    std::array<double,MAX_DEGREE + 2> T_next {};
+    for (unsigned int j = 0; j <= k; j++) {
+      T_next[j + 1] += ((k == 0) ? 1.0 : 2.0) * T_k[j];
+      T_next[j] -= T_prev[j];
+    }
+    T_prev = T_k;
+    T_k = T_next;
+  }
+
+  // d/dt of the powers of x, 1/s
+  for (unsigned int k = 0; k < degree; k++) {
+    deriv_coeffs_[k] = (k + 1.0) * inv_half_window_ * coeffs_[k + 1];
+  }
+}
+
+} // namespace Gps
@@ -0,0 +1,329 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "gps_rinex.hpp"
+#include "parallel_ops.hpp"
+
+namespace Gps
+{
+
+namespace
+{
+  constexpr double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  struct Line
+  {
+    const char* begin;
+    const char* end; // excludes the line break
+
+    // Fixed-width field, clipped to the line since trailing blanks may be trimmed
+    bool Number(const std::size_t start, const std::size_t width, double& value) const
+    {
+      const char* field = begin + std::min<std::size_t>(start, end - begin);
+      const char* field_end = field + std::min<std::size_t>(width, end - field);
+      return ParseRinexNumber(field, field_end, value);
+    }
+  };
+
+  bool NextLine(const char*& p, const char* end, Line& line)
+  {
+    if (p >= end) return false;
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    const char* line_end = (newline != nullptr) ? newline : end;
+    line.begin = p;
+    line.end = ((line_end > p) && (*(line_end - 1) == '\r')) ? line_end - 1 : line_end;
+    p = (newline != nullptr) ? newline + 1 : end;
+    return true;
+  }
+
+  // Orbit lines are indented, record lines start with the PRN (right-justified I2 in 2.x)
+  bool RecordStart(const Line& line, const bool version3)
+  {
+    std::size_t length = line.end - line.begin;
+    if (version3) return (length > 0) && (line.begin[0] != ' ');
+    return (length > 1) && (line.begin[1] != ' ');
+  }
+
+  int64_t DaysFromCivil(int64_t year, const unsigned int month, const unsigned int day)
+  {
+    year -= (month <= 2) ? 1 : 0;
+    const int64_t era = ((year >= 0) ? year : year - 399) / 400;
+    const unsigned int year_of_era = static_cast<unsigned int>(year - (era * 400));
+    const unsigned int day_of_year = ((153 * ((month > 2) ? month - 3 : month + 9)) + 2) / 5 + day - 1;
+    const unsigned int day_of_era = (year_of_era * 365) + (year_of_era / 4) - (year_of_era / 100) + day_of_year;
+    return (era * 146097) + static_cast<int64_t>(day_of_era) - 719468;
+  }
+
+  // Seconds of the GPS week of a calendar epoch
+  double SecondsOfWeek(const int year, const int month, const int day, const int hour, const int minute,
+    const double second)
+  {
+    const int64_t days = DaysFromCivil(year, month, day) - DaysFromCivil(1980, 1, 6);
+    return (static_cast<double>(days % 7) * 86400.0) + (hour * 3600.0) + (minute * 60.0) + second;
+  }
+
+  // Epoch and clock line plus seven orbit lines of one GPS record
+  bool ParseRecord(const Line& first, const Line* orbit, const bool version3, NavigationRecord& record)
+  {
+    // PRN and epoch columns, then the three clock fields
+    const std::size_t prn_start = version3 ? 1 : 0;
+    const std::size_t epoch_starts[6] = {3, 5, 8, 11, 14, 17};
+    const std::size_t epoch_widths[6] = {2, 3, 3, 3, 3, 5};
+    const std::size_t epoch3_starts[6] = {4, 9, 12, 15, 18, 21};
+    const std::size_t epoch3_widths[6] = {4, 2, 2, 2, 2, 2};
+    const std::size_t field_start = version3 ? 23 : 22;
+    const std::size_t orbit_start = version3 ? 4 : 3;
+
+    double prn, epoch[6];
+    bool ok = first.Number(prn_start, 2, prn);
+    for (int i = 0; i < 6; i++) {
+      ok = ok && first.Number(version3 ? epoch3_starts[i] : epoch_starts[i],
+                              version3 ? epoch3_widths[i] : epoch_widths[i], epoch[i]);
+    }
+    if (!ok || prn < 1 || prn > 255 || epoch[1] < 1 || epoch[1] > 12) return false;
+    int year = static_cast<int>(epoch[0]);
+    if (!version3) year += (year < 80) ? 2000 : 1900;
+
+    ClockData& clock = record.clock_data;
+    ok = first.Number(field_start, 19, clock.a_f0)
+      && first.Number(field_start + 19, 19, clock.a_f1)
+      && first.Number(field_start + 38, 19, clock.a_f2);
+
+    double values[28];
+    for (int l = 0; l < 7; l++) {
+      for (int f = 0; f < 4; f++) {
+        ok = ok && orbit[l].Number(orbit_start + (19 * f), 19, values[(4 * l) + f]);
+      }
+    }
+    if (!ok) return false;
+
+    record.prn = static_cast<uint8_t>(prn);
+    clock.t_oc = SecondsOfWeek(year, static_cast<int>(epoch[1]), static_cast<int>(epoch[2]),
+                               static_cast<int>(epoch[3]), static_cast<int>(epoch[4]), epoch[5]);
+
+    Ephemeris& eph = record.ephemeris;
+    eph.IODE = static_cast<uint8_t>(values[0]);
+    eph.C_rs = values[1];
+    eph.del_n = values[2];
+    eph.M_0 = values[3];
+    eph.C_uc = values[4];
+    eph.e = values[5];
+    eph.C_us = values[6];
+    eph.sqrtA = values[7];
+    eph.t_oe = values[8];
+    eph.C_ic = values[9];
+    eph.Omega_0 = values[10];
+    eph.C_is = values[11];
+    eph.i_0 = values[12];
+    eph.C_rc = values[13];
+    eph.omega = values[14];
+    eph.Omega_dot = values[15];
+    eph.IDOT = values[16];
+    record.week = static_cast<uint16_t>(values[18]);
+    record.accuracy = values[20];
+    record.health = static_cast<uint8_t>(values[21]);
+    clock.T_GD = values[22];
+    clock.IODC = static_cast<uint16_t>(values[23]);
+    record.transmit_time = values[24];
+    // hours, zero when unknown which means the nominal 4 hours
+    record.fit_interval = (values[25] > 0.0) ? values[25] * 3600.0 : 14400.0;
+    return true;
+  }
+
+  // Records starting in [begin,end), a record may run past end
+  void ParseChunk(const char* begin, const char* end, const char* data_end, const bool version3,
+    std::vector<NavigationRecord>& records)
+  {
+    const char* p = begin;
+    Line line;
+    while (p < end && NextLine(p, data_end, line)) {
+      if (!RecordStart(line, version3)) continue;
+      // other systems are skipped by scanning to the next record line
+      if (version3 && line.begin[0] != 'G') continue;
+
+      Line orbit[7];
+      int count = 0;
+      const char* q = p;
+      while (count < 7 && NextLine(q, data_end, orbit[count]) && !RecordStart(orbit[count], version3)) {
+        count++;
+      }
+      if (count < 7) continue;
+
+      NavigationRecord record;
+      if (ParseRecord(line, orbit, version3, record)) {
+        records.push_back(record);
+      }
+      p = q;
+    }
+  }
+}
+
+
+bool ParseRinexNumber(const char* begin, const char* end, double& value)
+{
+  const char* p = begin;
+  while (p < end && *p == ' ') p++;
+  if (p == end) {
+    value = 0.0;
+    return true;
+  }
+
+  bool negative = (*p == '-');
+  if (*p == '-' || *p == '+') p++;
+
+  // up to 19 significant digits in an integer mantissa, the rest only scale
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool any_digits = false;
+  for (; p < end && *p >= '0' && *p <= '9'; p++) {
+    any_digits = true;
+    if (digits < 19) {
+      mantissa = (mantissa * 10) + static_cast<uint64_t>(*p - '0');
+      digits += (mantissa > 0) ? 1 : 0;
+    } else {
+      exponent++;
+    }
+  }
+  if (p < end && *p == '.') {
+    for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+      any_digits = true;
+      if (digits < 19) {
+        mantissa = (mantissa * 10) + static_cast<uint64_t>(*p - '0');
+        digits += (mantissa > 0) ? 1 : 0;
+        exponent--;
+      }
+    }
+  }
+  if (!any_digits) return false;
+
+  if (p < end && (*p == 'D' || *p == 'd' || *p == 'E' || *p == 'e')) {
+    p++;
+    bool negative_exponent = (p < end && *p == '-');
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    if (p == end || *p < '0' || *p > '9') return false;
+    int written = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++) {
+      written = std::min((written * 10) + (*p - '0'), 100000);
+    }
+    exponent += negative_exponent ? -written : written;
+  }
+  while (p < end && *p == ' ') p++;
+  if (p != end) return false;
+
+  // exact when the mantissa and the power of ten are both exact doubles
+  if (mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+    double magnitude = static_cast<double>(mantissa);
+    magnitude = (exponent < 0) ? magnitude / POWERS_OF_TEN[-exponent] : magnitude * POWERS_OF_TEN[exponent];
+    value = negative ? -magnitude : magnitude;
+    return true;
+  }
+
+  // rare: correctly rounded conversion of a stack copy
+  char buffer[64];
+  std::size_t length = std::min<std::size_t>(end - begin, sizeof(buffer) - 1);
+  std::transform(begin, begin + length, buffer, [](const char c) { return (c == 'D' || c == 'd') ? 'E' : c; });
+  buffer[length] = '\0';
+  value = std::strtod(buffer, nullptr);
+  return true;
+}
+
+bool ParseRinexNavigation(const char* data, const std::size_t size, std::vector<NavigationRecord>& records,
+  const unsigned int num_threads)
+{
+  const char* end = data + size;
+  const char* p = data;
+  Line line;
+
+  // RINEX VERSION / TYPE: version F9.2, file type at column 20, system at column 40
+  if (!NextLine(p, end, line)) return false;
+  double version;
+  if (!line.Number(0, 9, version) || (line.end - line.begin) < 21 || line.begin[20] != 'N') return false;
+  const bool version3 = (version >= 3.0);
+  if (version3 && (line.end - line.begin) > 40 && line.begin[40] != 'G' && line.begin[40] != 'M') return false;
+
+  bool header_done = false;
+  while (!header_done && NextLine(p, end, line)) {
+    header_done = ((line.end - line.begin) >= 73) && (std::memcmp(line.begin + 60, "END OF HEADER", 13) == 0);
+  }
+  if (!header_done) return false;
+
+  // chunks begin at record lines so they can be parsed independently
+  const std::size_t body_size = end - p;
+  const std::size_t min_chunk = 1 << 16;
+  const std::size_t num_chunks = std::max<std::size_t>(1, std::min<std::size_t>(
+    4 * ResolveThreadCount(num_threads), body_size / min_chunk));
+  std::vector<const char*> starts(num_chunks + 1, end);
+  starts[0] = p;
+  for (std::size_t c = 1; c < num_chunks; c++) {
+    const char* q = std::max(p + ((body_size * c) / num_chunks), starts[c - 1]);
+    const char* newline = static_cast<const char*>(std::memchr(q, '\n', end - q));
+    q = (newline != nullptr) ? newline + 1 : end;
+    while (q < end) {
+      const char* line_start = q;
+      NextLine(q, end, line);
+      if (RecordStart(line, version3)) {
+        q = line_start;
+        break;
+      }
+    }
+    starts[c] = q;
+  }
+
+  std::vector<std::vector<NavigationRecord>> chunk_records(num_chunks);
+  ParallelFor(num_chunks, [&](const std::size_t c)
+  {
+    ParseChunk(starts[c], starts[c + 1], end, version3, chunk_records[c]);
+  }, num_threads);
+
+  std::size_t total = records.size();
+  for (const std::vector<NavigationRecord>& chunk : chunk_records) {
+    total += chunk.size();
+  }
+  records.reserve(total);
+  for (const std::vector<NavigationRecord>& chunk : chunk_records) {
+    records.insert(records.end(), chunk.begin(), chunk.end());
+  }
+  return true;
+}
+
+bool ReadRinexNavigation(const std::string& path, std::vector<NavigationRecord>& records,
+  const unsigned int num_threads)
+{
+#if defined(__unix__) || defined(__APPLE__)
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  std::size_t size = static_cast<std::size_t>(info.st_size);
+  void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED) return false;
+  madvise(mapped, size, MADV_WILLNEED);
+  bool success = ParseRinexNavigation(static_cast<const char*>(mapped), size, records, num_threads);
+  munmap(mapped, size);
+  return success;
+#else
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return false;
+  std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return ParseRinexNavigation(contents.data(), contents.size(), records, num_threads);
+#endif
+}
+
+} // namespace Gps
@@ -0,0 +1,124 @@
+#include <cmath>
+
+#include <Eigen/Dense>
+
+#include "gps_atmosphere.hpp"
+#include "gps_common.hpp"
+#include "gps_coordinates.hpp"
+#include "gps_signal_dynamics.hpp"
+
+namespace Gps
+{
+
+ReceiverTrajectory StaticReceiver(const Eigen::Vector3d& pos)
+{
+  return [pos](const double, Eigen::Vector3d& rx_pos, Eigen::Vector3d& rx_vel,
+    Eigen::Vector3d& rx_acc)
+  {
+    rx_pos = pos;
+    rx_vel.setZero();
+    rx_acc.setZero();
+  };
+}
+
+
+SatelliteDynamics::SatelliteDynamics(const Ephemeris& ephemeris, const ClockData& clock_data,
+  const double elevation_mask)
+  : ephemeris_{ephemeris}, clock_data_{clock_data}, elevation_mask_{elevation_mask}
+{}
+
+void SatelliteDynamics::Observe(const double gps_time, const Eigen::Vector3d& rx_pos,
+  const Eigen::Vector3d& rx_vel, const Eigen::Vector3d& rx_acc, SignalObservables& obs) const
+{
+  constexpr double nominal_light_time = 0.075;
+
+  Eigen::Vector3d sat_pos, sat_vel, sat_acc;
+  double t_ref = gps_time - nominal_light_time;
+  ephemeris_.PVA(t_ref, sat_pos, sat_vel, sat_acc);
+
+  // Light time iteration on the Taylor expansion of the orbit about t_ref
+  double light_time = nominal_light_time;
+  Eigen::Vector3d tx_pos, tx_vel, tx_acc;
+  for (int i = 0; i < 3; i++) {
+    double dt = (gps_time - light_time) - t_ref;
+    tx_pos = sat_pos + (sat_vel * dt) + (0.5 * sat_acc * dt * dt);
+    tx_vel = sat_vel + (sat_acc * dt);
+    tx_acc = sat_acc;
+
+    // Sagnac: express the transmit position in the ECEF frame at receive time
+    double theta = Ephemeris::WGS84_EARTH_RATE * light_time;
+    double c = std::cos(theta);
+    double s = std::sin(theta);
+    Eigen::Matrix3d R;
+    R << c,  s,  0.0,
+        -s,  c,  0.0,
+         0.0, 0.0, 1.0;
+    tx_pos = R * tx_pos;
+    tx_vel = R * tx_vel;
+    tx_acc = R * tx_acc;
+    light_time = (tx_pos - rx_pos).norm() / LIGHT_SPEED;
+  }
+
+  Eigen::Vector3d los = tx_pos - rx_pos;
+  double range = los.norm();
+  Eigen::Vector3d unit_los = los / range;
+  Eigen::Vector3d rel_vel = tx_vel - rx_vel;
+  double range_rate = unit_los.dot(rel_vel);
+  double range_accel = unit_los.dot(tx_acc - rx_acc)
+                     + ((rel_vel.squaredNorm() - (range_rate * range_rate)) / range);
+
+  // Satellite clock (L1 C/A users apply T_GD)
+  double t_tx = gps_time - light_time;
+  double clock_offset = clock_data_.Offset(t_tx) - clock_data_.T_GD;
+  double clock_rate = clock_data_.OffsetRate(t_tx);
+  double clock_rate_rate = clock_data_.OffsetRateRate();
+
+  obs.pseudorange = range - (LIGHT_SPEED * clock_offset);
+  obs.pseudorange_rate = range_rate - (LIGHT_SPEED * clock_rate);
+  obs.pseudorange_accel = range_accel - (LIGHT_SPEED * clock_rate_rate);
+
+  obs.ionosphere_delay = 0.0;
+  obs.troposphere_delay = 0.0;
+  if (use_ionosphere_ || use_troposphere_) {
+    double lat, lon, alt, azimuth;
+    EcefToLla(rx_pos, lat, lon, alt);
+    Eigen::Vector3d enu = EcefToEnuRotation(lat, lon) * los;
+    obs.elevation = std::atan2(enu(2), std::hypot(enu(0), enu(1)));
+    azimuth = std::atan2(enu(0), enu(1));
+    if (use_ionosphere_) {
+      obs.ionosphere_delay = LIGHT_SPEED * KlobucharDelay(iono_, gps_time, lat, lon, obs.elevation, azimuth);
+    }
+    if (use_troposphere_) {
+      obs.troposphere_delay = TroposphereDelay(lat, alt, obs.elevation);
+    }
+    obs.pseudorange += obs.ionosphere_delay + obs.troposphere_delay;
+  } else {
+    obs.elevation = Elevation(rx_pos, tx_pos);
+  }
+  obs.transmit_time = gps_time - (obs.pseudorange / LIGHT_SPEED);
+}
+
+bool SatelliteDynamics::Block(const double gps_time, const Eigen::Vector3d& rx_pos,
+  const Eigen::Vector3d& rx_vel, const Eigen::Vector3d& rx_acc, const double intermediate_frequency,
+  PhasePolynomial& poly) const
+{
+  SignalObservables obs;
+  Observe(gps_time, rx_pos, rx_vel, rx_acc, obs);
+
+  poly.visible = (obs.elevation >= elevation_mask_);
+  poly.transmit_time = obs.transmit_time;
+
+  poly.code_frequency = CA_RATE * (1.0 - (obs.pseudorange_rate / LIGHT_SPEED));
+  poly.code_frequency_rate = -CA_RATE * obs.pseudorange_accel / LIGHT_SPEED;
+
+  // the ionosphere delays the code and advances the carrier
+  double carrier_range = obs.pseudorange - (2.0 * obs.ionosphere_delay);
+  poly.carrier_phase = circular_fmod2(-L1_RADIANS_PER_METER * carrier_range, TwoPi<double>);
+  poly.carrier_frequency = intermediate_frequency - (L1_FREQUENCY * obs.pseudorange_rate / LIGHT_SPEED);
+  poly.carrier_frequency_rate = -L1_FREQUENCY * obs.pseudorange_accel / LIGHT_SPEED;
+
+  return poly.visible;
+}
+
+
+} // namespace Gps
@@ -1,4 +1,6 @@
 
+#include <cmath>
+
 #include "gps_common.hpp"
 #include "gps_signal_gen.hpp"
 
@@ -6,6 +8,21 @@
 namespace Gps {
 namespace Lnav {
 
+namespace internal
+{
+  static std::array<int16_t,SINE_TABLE_SIZE> GenSineTable()
+  {
+    std::array<int16_t,SINE_TABLE_SIZE> table;
+    for (uint32_t i = 0; i < SINE_TABLE_SIZE; i++) {
+      double angle = TwoPi<double> * static_cast<double>(i) / static_cast<double>(SINE_TABLE_SIZE);
+      table[i] = static_cast<int16_t>(std::lround(32767.0 * std::sin(angle)));
+    }
+    return table;
+  }
+
+  const std::array<int16_t,SINE_TABLE_SIZE> sine_table = GenSineTable();
+}
+
 SatelliteInfo::SatelliteInfo(const uint8_t prn) : prn_{prn}
 {
   // Initialize(0);
@@ -30,6 +47,36 @@ void SatelliteInfo::Initialize(uint8_t first_subframe)
 }
 
 
+void SatelliteInfo::Save(std::ostream& os) const
+{
+  WriteBinary(os, prn_);
+  frame_.Save(os);
+  for (uint8_t i = 0; i < 2; i++) {
+    WriteBinary(os, subframe_nums_[i]);
+    for (uint8_t w = 0; w < 10; w++) {
+      WriteBinary(os, parity_subframes_[i][w].Val());
+    }
+  }
+}
+
+bool SatelliteInfo::Load(std::istream& is)
+{
+  ReadBinary(is, prn_);
+  if (!frame_.Load(is)) return false;
+  for (uint8_t i = 0; i < 2; i++) {
+    ReadBinary(is, subframe_nums_[i]);
+    for (uint8_t w = 0; w < 10; w++) {
+      uint32_t bits;
+      ReadBinary(is, bits);
+      parity_subframes_[i][w].SetVal(bits);
+    }
+  }
+  if (!is || (prn_ < 1) || (prn_ > 32)) return false;
+  GenCA(&ca_code_, prn_);
+  return true;
+}
+
+
 uint8_t SatelliteInfo::GetSubframeIndex(const uint8_t subframe_num)
 {
   assert(subframe_num < 5);
@@ -0,0 +1,287 @@
+#include <cmath>
+#include <array>
+#include <complex>
+#include <numbers>
+
+#include "gps_common.hpp"
+#include "gps_correlator_sim.hpp"
+#include "gps_tracking_sim.hpp"
+#include "parallel_ops.hpp"
+
+namespace Gps
+{
+
+namespace
+{
+
+// Natural frequency (rad/s) from noise bandwidth and the filter coefficients, Kaplan table 5.6
+struct LoopGains
+{
+  double w0 = 0.0;
+  double a = 0.0; // second order a2 or third order a3
+  double b = 0.0; // third order b3
+};
+
+LoopGains CalcLoopGains(const LoopFilterConfig& filter)
+{
+  LoopGains gains;
+  switch (filter.order) {
+    case 1:
+      gains.w0 = filter.bandwidth / 0.25;
+      break;
+    case 2:
+      gains.w0 = filter.bandwidth / 0.53;
+      gains.a = std::numbers::sqrt2;
+      break;
+    case 3:
+      gains.w0 = filter.bandwidth / 0.7845;
+      gains.a = 1.1;
+      gains.b = 2.4;
+      break;
+    default:
+      assert(false && "loop filter order must be 1, 2 or 3");
+  }
+  return gains;
+}
+
+double CalcDllDiscriminator(const DllDiscriminator type, const std::complex<double>& early,
+  const std::complex<double>& prompt, const std::complex<double>& late, const double spacing)
+{
+  // Each form is scaled to return the chip error (truth - replica) near lock
+  switch (type) {
+    case DllDiscriminator::EarlyMinusLatePower: {
+      double e2 = std::norm(early);
+      double l2 = std::norm(late);
+      return 0.5 * (1.0 - 0.5 * spacing) * (e2 - l2) / (e2 + l2);
+    }
+    case DllDiscriminator::EarlyMinusLateEnvelope: {
+      double e = std::abs(early);
+      double l = std::abs(late);
+      return (1.0 - 0.5 * spacing) * (e - l) / (e + l);
+    }
+    case DllDiscriminator::DotProduct:
+      return 0.5 * std::real((early - late) * std::conj(prompt)) / std::norm(prompt);
+  }
+  return 0.0;
+}
+
+// Wraps a phase error to the discriminator's ambiguity (half cycle for Costas)
+double WrapPhaseError(const double phase_error, const PllDiscriminator type)
+{
+  if (type == PllDiscriminator::Costas) {
+    return phase_error - 0.5 * std::round(2.0 * phase_error);
+  }
+  return phase_error - std::round(phase_error);
+}
+
+} // namespace
+
+
+TrialResult RunTrackingTrial(const TrackingLoopConfig& config, const TruthProfile& truth,
+  std::mt19937_64& gen)
+{
+  assert(config.integration_time > 0.0);
+  assert(config.dll.order == 1 || config.dll.order == 2);
+  assert(config.fll.order == 1 || config.fll.order == 2);
+
+  const double cycles_per_meter = L1_FREQUENCY / LIGHT_SPEED;
+  const double code_per_carrier = CA_RATE / L1_FREQUENCY;
+  const double T = config.integration_time;
+  const double half_spacing = 0.5 * config.early_late_spacing;
+  const double cno = std::pow(10.0, 0.1 * truth.cno);
+  const bool use_fll = config.fll.bandwidth > 0.0;
+  const LoopGains dll = CalcLoopGains(config.dll);
+  const LoopGains pll = CalcLoopGains(config.pll);
+  const LoopGains fll = use_fll ? CalcLoopGains(config.fll) : LoopGains{};
+
+  MultiTapCorrelatorSim<double,3> correlator({-half_spacing, 0.0, half_spacing});
+  std::array<std::complex<double>,3> taps;
+
+  // Truth code/carrier phase relative to nominal, range starts at zero
+  auto range = [&truth](const double t)
+  {
+    return t * (truth.range_rate + t * (0.5 * truth.range_accel + t * truth.range_jerk / 6.0));
+  };
+  auto range_rate = [&truth](const double t)
+  {
+    return truth.range_rate + t * (truth.range_accel + 0.5 * t * truth.range_jerk);
+  };
+
+  // Receiver NCOs
+  double chip = -truth.initial_chip_error;
+  double phase = -truth.initial_phase_error;
+  double frequency = -range_rate(0.0) * cycles_per_meter - truth.initial_frequency_error;
+  const double code_rate_base = config.carrier_aiding ? 0.0 : frequency * code_per_carrier;
+  double code_rate = code_rate_base + (config.carrier_aiding ? frequency * code_per_carrier : 0.0);
+
+  // Loop filter integrators
+  double carrier_velocity = frequency; // Hz
+  double carrier_accel = 0.0; // Hz/s
+  double code_velocity = 0.0; // chips/s
+  std::complex<double> prev_prompt = 0.0;
+
+  TrialResult result;
+  const std::size_t num_epochs = static_cast<std::size_t>(truth.duration / T);
+  for (std::size_t k = 0; k < num_epochs; k++) {
+    double t_mid = (static_cast<double>(k) + 0.5) * T;
+    double r_mid = range(t_mid);
+    double chip_error = -r_mid * CHIPS_PER_METER - (chip + 0.5 * T * code_rate);
+    double phase_error = -r_mid * cycles_per_meter - (phase + 0.5 * T * frequency);
+    double frequency_error = -range_rate(t_mid) * cycles_per_meter - frequency;
+
+    if (std::abs(chip_error) > config.max_chip_error
+        || std::abs(frequency_error) > config.max_frequency_error) {
+      result.lost_lock = true;
+      result.loss_of_lock_time = static_cast<double>(k) * T;
+      break;
+    }
+    double wrapped_phase = WrapPhaseError(phase_error, config.pll_discriminator);
+    result.sum_sq_chip_error += chip_error * chip_error;
+    result.sum_sq_phase_error += wrapped_phase * wrapped_phase;
+    result.sum_sq_frequency_error += frequency_error * frequency_error;
+    result.epochs++;
+
+    correlator.Simulate(taps, chip_error, frequency_error, phase_error, T, cno, gen);
+    const std::complex<double>& prompt = taps[1];
+
+    // Propagate the NCOs over the interval just correlated
+    chip += code_rate * T;
+    phase += frequency * T;
+
+    // Carrier loop
+    double pll_error = (config.pll_discriminator == PllDiscriminator::Costas)
+                     ? std::atan(prompt.imag() / prompt.real())
+                     : std::arg(prompt);
+    pll_error /= TwoPi<double>;
+    double fll_error = 0.0;
+    if (use_fll && k > 0) {
+      double cross = prev_prompt.real() * prompt.imag() - prompt.real() * prev_prompt.imag();
+      double dot = prev_prompt.real() * prompt.real() + prev_prompt.imag() * prompt.imag();
+      fll_error = (config.pll_discriminator == PllDiscriminator::Costas)
+                ? std::atan(cross / dot) : std::atan2(cross, dot);
+      fll_error /= TwoPi<double> * T;
+    }
+    prev_prompt = prompt;
+
+    double pll_proportional = 0.0;
+    switch (config.pll.order) {
+      case 1:
+        pll_proportional = pll.w0 * pll_error;
+        break;
+      case 2:
+        carrier_velocity += T * pll.w0 * pll.w0 * pll_error;
+        pll_proportional = pll.a * pll.w0 * pll_error;
+        break;
+      case 3:
+        carrier_accel += T * pll.w0 * pll.w0 * pll.w0 * pll_error;
+        carrier_velocity += T * (carrier_accel + pll.a * pll.w0 * pll.w0 * pll_error);
+        pll_proportional = pll.b * pll.w0 * pll_error;
+        break;
+    }
+    if (use_fll) {
+      if (config.fll.order == 1) {
+        carrier_velocity += T * fll.w0 * fll_error;
+      } else {
+        carrier_accel += T * fll.w0 * fll.w0 * fll_error;
+        if (config.pll.order < 3) {
+          carrier_velocity += T * carrier_accel;
+        }
+        carrier_velocity += T * fll.a * fll.w0 * fll_error;
+      }
+    }
+    frequency = carrier_velocity + pll_proportional;
+
+    // Code loop
+    double dll_error = CalcDllDiscriminator(config.dll_discriminator, taps[0], prompt, taps[2],
+                                            config.early_late_spacing);
+    double dll_proportional = dll.w0 * dll_error;
+    if (config.dll.order == 2) {
+      code_velocity += T * dll.w0 * dll.w0 * dll_error;
+      dll_proportional = dll.a * dll.w0 * dll_error;
+    }
+    code_rate = code_rate_base + code_velocity + dll_proportional
+              + (config.carrier_aiding ? frequency * code_per_carrier : 0.0);
+  }
+  return result;
+}
+
+
+TrackingStatistics SummarizeTrials(const TrialResult* trials, const std::size_t count)
+{
+  TrackingStatistics stats;
+  stats.num_trials = count;
+  double sum_sq_chip = 0.0, sum_sq_phase = 0.0, sum_sq_frequency = 0.0, sum_loss_time = 0.0;
+  std::size_t epochs = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    sum_sq_chip += trials[i].sum_sq_chip_error;
+    sum_sq_phase += trials[i].sum_sq_phase_error;
+    sum_sq_frequency += trials[i].sum_sq_frequency_error;
+    epochs += trials[i].epochs;
+    if (trials[i].lost_lock) {
+      stats.num_lost++;
+      sum_loss_time += trials[i].loss_of_lock_time;
+    }
+  }
+  if (epochs > 0) {
+    stats.rms_chip_error = std::sqrt(sum_sq_chip / static_cast<double>(epochs));
+    stats.rms_phase_error = std::sqrt(sum_sq_phase / static_cast<double>(epochs));
+    stats.rms_frequency_error = std::sqrt(sum_sq_frequency / static_cast<double>(epochs));
+  }
+  if (stats.num_lost > 0) {
+    stats.mean_loss_of_lock_time = sum_loss_time / static_cast<double>(stats.num_lost);
+  }
+  if (count > 0) {
+    stats.lock_probability = static_cast<double>(count - stats.num_lost) / static_cast<double>(count);
+  }
+  return stats;
+}
+
+
+namespace
+{
+
+std::mt19937_64 TrialGenerator(const uint64_t seed, const std::size_t trial)
+{
+  std::seed_seq seq {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+                     static_cast<uint32_t>(trial), static_cast<uint32_t>(uint64_t(trial) >> 32)};
+  return std::mt19937_64(seq);
+}
+
+} // namespace
+
+
+TrackingStatistics RunTrackingMonteCarlo(const TrackingLoopConfig& config, const TruthProfile& truth,
+  const std::size_t num_trials, const uint64_t seed, const unsigned int num_threads)
+{
+  std::vector<TrialResult> trials(num_trials);
+  ParallelFor(num_trials, [&](const std::size_t i)
+  {
+    std::mt19937_64 gen = TrialGenerator(seed, i);
+    trials[i] = RunTrackingTrial(config, truth, gen);
+  }, num_threads);
+  return SummarizeTrials(trials.data(), num_trials);
+}
+
+
+std::vector<TrackingStatistics> RunTrackingSweep(const std::vector<TrackingLoopConfig>& configs,
+  const TruthProfile& truth, const std::size_t num_trials, const uint64_t seed,
+  const unsigned int num_threads)
+{
+  // Trial i of every configuration sees the same noise stream, so configurations are compared
+  // on common random numbers
+  std::vector<TrialResult> trials(configs.size() * num_trials);
+  ParallelFor(trials.size(), [&](const std::size_t j)
+  {
+    std::size_t trial = j % num_trials;
+    std::mt19937_64 gen = TrialGenerator(seed, trial);
+    trials[j] = RunTrackingTrial(configs[j / num_trials], truth, gen);
+  }, num_threads);
+
+  std::vector<TrackingStatistics> stats(configs.size());
+  for (std::size_t c = 0; c < configs.size(); c++) {
+    stats[c] = SummarizeTrials(trials.data() + c * num_trials, num_trials);
+  }
+  return stats;
+}
+
+} // namespace Gps
@@ -0,0 +1,221 @@
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+#include <Eigen/Dense>
+
+#include "gps_coordinates.hpp"
+#include "gps_visibility.hpp"
+#include "parallel_ops.hpp"
+
+namespace Gps
+{
+
+namespace
+{
+  constexpr double ROOT_TOLERANCE = 1e-3; // seconds
+  constexpr double PEAK_TOLERANCE = 1e-3; // seconds
+  constexpr unsigned int MAX_ROOT_ITERATIONS = 30;
+
+  // Satellite states on the coarse grid, shared by all receivers
+  struct OrbitGrid
+  {
+    std::vector<double> times;
+    std::vector<SoaVector3> pos;
+    std::vector<SoaVector3> vel;
+
+    // Cubic Hermite interpolation of one satellite's position
+    Eigen::Vector3d Position(const std::size_t sat, const double t) const
+    {
+      std::size_t j = static_cast<std::size_t>(std::upper_bound(times.begin() + 1, times.end() - 1, t) - times.begin());
+      double h = times[j] - times[j - 1];
+      double s = (t - times[j - 1]) / h;
+      double s2 = s * s;
+      double s3 = s2 * s;
+      double h00 = (2.0 * s3) - (3.0 * s2) + 1.0;
+      double h10 = (s3 - (2.0 * s2) + s) * h;
+      double h01 = (3.0 * s2) - (2.0 * s3);
+      double h11 = (s3 - s2) * h;
+      return (h00 * pos[j - 1].row(sat).transpose()) + (h10 * vel[j - 1].row(sat).transpose())
+           + (h01 * pos[j].row(sat).transpose()) + (h11 * vel[j].row(sat).transpose());
+    }
+  };
+
+  // sin(elevation) - sin(mask) of one satellite from a receiver
+  struct MaskFunction
+  {
+    const OrbitGrid& grid;
+    const Eigen::Vector3d& rx_pos;
+    const Eigen::Vector3d& up;
+    std::size_t sat;
+    double sin_mask;
+
+    double operator()(const double t) const
+    {
+      Eigen::Vector3d los = grid.Position(sat, t) - rx_pos;
+      return (up.dot(los) / los.norm()) - sin_mask;
+    }
+  };
+
+  // Illinois variant of regula falsi on a bracketing interval
+  double RefineCrossing(const MaskFunction& f, double a, double b, double fa, double fb)
+  {
+    int side = 0;
+    double c = a;
+    for (unsigned int i = 0; i < MAX_ROOT_ITERATIONS && (b - a) > ROOT_TOLERANCE; i++) {
+      c = ((a * fb) - (b * fa)) / (fb - fa);
+      double fc = f(c);
+      if (fc == 0.0) break;
+      if ((fc > 0.0) == (fb > 0.0)) {
+        b = c;
+        fb = fc;
+        if (side == -1) fa *= 0.5;
+        side = -1;
+      } else {
+        a = c;
+        fa = fc;
+        if (side == 1) fb *= 0.5;
+        side = 1;
+      }
+    }
+    return c;
+  }
+
+  double RefinePeak(const MaskFunction& f, double a, double b)
+  {
+    constexpr double inv_phi = 0.6180339887498949;
+    double c = b - (inv_phi * (b - a));
+    double d = a + (inv_phi * (b - a));
+    double fc = f(c);
+    double fd = f(d);
+    while ((b - a) > PEAK_TOLERANCE) {
+      if (fc > fd) {
+        b = d;
+        d = c;
+        fd = fc;
+        c = b - (inv_phi * (b - a));
+        fc = f(c);
+      } else {
+        a = c;
+        c = d;
+        fc = fd;
+        d = a + (inv_phi * (b - a));
+        fd = f(d);
+      }
+    }
+    return 0.5 * (a + b);
+  }
+
+  void ReceiverPasses(const OrbitGrid& grid, const std::size_t num_sats, const Eigen::Vector3d& rx_pos,
+    const double sin_mask, std::vector<SatellitePass>& passes)
+  {
+    const Eigen::Vector3d up = EcefToEnuRotation(rx_pos).row(2).transpose();
+    const std::size_t num_steps = grid.times.size();
+    std::vector<double> values(num_sats);
+    std::vector<double> prev_values(num_sats);
+    std::vector<double> rise_time(num_sats);
+    std::vector<std::size_t> peak_step(num_sats);
+    std::vector<double> peak_value(num_sats);
+
+    auto close_pass = [&](const std::size_t s, const double set_time)
+    {
+      MaskFunction f {grid, rx_pos, up, s, sin_mask};
+      std::size_t m = peak_step[s];
+      double a = grid.times[(m > 0) ? m - 1 : 0];
+      double b = grid.times[std::min(m + 1, num_steps - 1)];
+      a = std::max(a, rise_time[s]);
+      b = std::min(b, set_time);
+
+      SatellitePass& pass = passes.emplace_back();
+      pass.satellite = static_cast<uint16_t>(s);
+      pass.rise_time = rise_time[s];
+      pass.set_time = set_time;
+      // the search stops up to PEAK_TOLERANCE inside the bracket, so take a peak clipped to the span exactly
+      double peak_time = (b > a) ? RefinePeak(f, a, b) : a;
+      double peak_value = f(peak_time);
+      for (double end : {a, b}) {
+        double value = f(end);
+        if (value > peak_value) {
+          peak_time = end;
+          peak_value = value;
+        }
+      }
+      pass.peak_time = peak_time;
+      ElevationAzimuth(rx_pos, grid.Position(s, pass.peak_time), pass.peak_elevation, pass.peak_azimuth);
+    };
+
+    for (std::size_t j = 0; j < num_steps; j++) {
+      const double* px = grid.pos[j].col(0).data();
+      const double* py = grid.pos[j].col(1).data();
+      const double* pz = grid.pos[j].col(2).data();
+      for (std::size_t s = 0; s < num_sats; s++) {
+        double dx = px[s] - rx_pos(0);
+        double dy = py[s] - rx_pos(1);
+        double dz = pz[s] - rx_pos(2);
+        double up_range = (up(0) * dx) + (up(1) * dy) + (up(2) * dz);
+        values[s] = (up_range / std::sqrt((dx * dx) + (dy * dy) + (dz * dz))) - sin_mask;
+      }
+
+      for (std::size_t s = 0; s < num_sats; s++) {
+        bool visible = values[s] >= 0.0;
+        bool was_visible = (j > 0) && (prev_values[s] >= 0.0);
+        if (visible && !was_visible) {
+          rise_time[s] = (j == 0) ? grid.times[0]
+            : RefineCrossing(MaskFunction{grid, rx_pos, up, s, sin_mask}, grid.times[j - 1], grid.times[j],
+                             prev_values[s], values[s]);
+          peak_step[s] = j;
+          peak_value[s] = values[s];
+        } else if (visible && values[s] > peak_value[s]) {
+          peak_step[s] = j;
+          peak_value[s] = values[s];
+        } else if (!visible && was_visible) {
+          close_pass(s, RefineCrossing(MaskFunction{grid, rx_pos, up, s, sin_mask}, grid.times[j - 1],
+                                       grid.times[j], prev_values[s], values[s]));
+        }
+      }
+      std::swap(values, prev_values);
+    }
+
+    // passes still up at the end of the span
+    for (std::size_t s = 0; s < num_sats; s++) {
+      if (prev_values[s] >= 0.0) {
+        close_pass(s, grid.times.back());
+      }
+    }
+    std::sort(passes.begin(), passes.end(), [](const SatellitePass& a, const SatellitePass& b)
+    {
+      return a.rise_time < b.rise_time;
+    });
+  }
+}
+
+
+std::vector<std::vector<SatellitePass>> PredictPasses(const EphemerisSet& satellites,
+  const std::vector<Eigen::Vector3d>& receivers, const double start_time, const double end_time,
+  const double elevation_mask, const double coarse_step, const unsigned int num_threads)
+{
+  assert(end_time > start_time);
+  assert(coarse_step > 0.0);
+
+  OrbitGrid grid;
+  std::size_t num_steps = static_cast<std::size_t>(std::ceil((end_time - start_time) / coarse_step)) + 1;
+  for (std::size_t j = 0; j < num_steps; j++) {
+    grid.times.push_back(std::min(start_time + (j * coarse_step), end_time));
+  }
+  grid.pos.resize(num_steps);
+  grid.vel.resize(num_steps);
+  ParallelFor(num_steps, [&grid, &satellites](const std::size_t j)
+  {
+    satellites.PV(grid.times[j], grid.pos[j], grid.vel[j]);
+  }, num_threads);
+
+  std::vector<std::vector<SatellitePass>> passes(receivers.size());
+  const double sin_mask = std::sin(elevation_mask);
+  ParallelFor(receivers.size(), [&](const std::size_t r)
+  {
+    ReceiverPasses(grid, satellites.Size(), receivers[r], sin_mask, passes[r]);
+  }, num_threads);
+  return passes;
+}
+
+} // namespace Gps
@@ -0,0 +1,197 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "gps_atmosphere.hpp"
+#include "gps_common.hpp"
+#include "gps_coordinates.hpp"
+#include "gps_lnav_data.hpp"
+#include "gps_signal_dynamics.hpp"
+
+// Broadcast values typical of the ionosphere around solar maximum
+Gps::IonosphereData TestIonosphere()
+{
+  Gps::IonosphereData iono;
+  iono.alpha = {1.1176e-8, 7.4506e-9, -5.9605e-8, -5.9605e-8};
+  iono.beta = {90112.0, 0.0, -196608.0, -65536.0};
+  return iono;
+}
+
+/*
+Encodes subframe 4 page 18 and decodes it into another frame, checking the ionospheric and UTC
+parameters survive to their broadcast resolution and that subframe 5 leaves the page intact.
+*/
+bool Page18Test()
+{
+  Gps::Lnav::DataFrame frame;
+  frame.SetTOW(100);
+  frame.SetWeek(100);
+  frame.IonosphereParams() = TestIonosphere();
+  Gps::UtcData& utc = frame.UtcParams();
+  utc.A_0 = -1.3969838619e-9;
+  utc.A_1 = 2.6645352591e-15;
+  utc.t_ot = 405504.0;
+  utc.WN_t = 187;
+  utc.del_t_LS = 18;
+  utc.WN_LSF = 137;
+  utc.DN = 7;
+  utc.del_t_LSF = 18;
+  frame.SetPage(17);
+  frame.SetSubframe4();
+  frame.SetSubframe5();
+
+  Gps::Lnav::DataFrame decoded;
+  Gps::Lnav::Subframe subframe = frame[3];
+  decoded.LoadSubframe4(subframe);
+
+  bool passed = (frame[3][2].Val(2,7) == 56);
+  for (int n = 0; n < 4; n++) {
+    passed &= (std::abs(decoded.IonosphereParams().alpha[n] - frame.IonosphereParams().alpha[n])
+               <= 0.5 * Gps::IonosphereDataScaleFactors.alpha[n]);
+    passed &= (std::abs(decoded.IonosphereParams().beta[n] - frame.IonosphereParams().beta[n])
+               <= 0.5 * Gps::IonosphereDataScaleFactors.beta[n]);
+  }
+  const Gps::UtcData& out = decoded.UtcParams();
+  passed &= (std::abs(out.A_0 - utc.A_0) <= 0.5 * Gps::UtcDataScaleFactors.A_0)
+         && (std::abs(out.A_1 - utc.A_1) <= 0.5 * Gps::UtcDataScaleFactors.A_1)
+         && (out.t_ot == utc.t_ot) && (out.WN_t == utc.WN_t) && (out.del_t_LS == utc.del_t_LS)
+         && (out.WN_LSF == utc.WN_LSF) && (out.DN == utc.DN) && (out.del_t_LSF == utc.del_t_LSF);
+  std::cout << "Page 18 Test: " << (passed ? "passed" : "failed") << "\n";
+  return passed;
+}
+
+
+/*
+Compares the batched (branch-free) ionospheric and tropospheric delays to the scalar functions over
+random receivers, satellites and times, and checks the delays are in their physical range. The
+same epoch split across threads must match one thread bit for bit. Also times a 10k receiver,
+24 satellite epoch.
+*/
+bool AtmosphereBatchTest()
+{
+  std::cout << "Atmosphere Batch Test: ";
+  constexpr std::size_t num_receivers = 10000;
+  constexpr std::size_t num_sats = 24;
+  std::mt19937_64 gen(11);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  Gps::SoaVector3 rx_pos(num_receivers, 3);
+  for (std::size_t r = 0; r < num_receivers; r++) {
+    rx_pos.row(r) = Gps::LlaToEcef(1.5 * unit(gen), std::numbers::pi * unit(gen), 2000.0 * (unit(gen) + 1.0));
+  }
+  std::vector<Eigen::Vector3d> sat_pos(num_sats);
+  for (Eigen::Vector3d& pos : sat_pos) {
+    pos = Eigen::Vector3d(unit(gen), unit(gen), unit(gen)).normalized() * 2.656e7;
+  }
+
+  Gps::AtmosphereModel model(TestIonosphere(), 1);
+  model.SetReceivers(rx_pos);
+  Eigen::MatrixXd iono, tropo;
+  double max_scalar_error = 0.0;
+  double min_iono = 1.0e9, max_iono = 0.0;
+  for (double gps_time : {1000.0, 40000.0, 50400.0, 300000.0}) {
+    model.Compute(gps_time, sat_pos, iono, tropo);
+    for (std::size_t r = 0; r < num_receivers; r += 7) {
+      Eigen::Vector3d pos = rx_pos.row(r).transpose();
+      double lat, lon, alt;
+      Gps::EcefToLla(pos, lat, lon, alt);
+      for (std::size_t s = 0; s < num_sats; s++) {
+        double elevation, azimuth;
+        Gps::ElevationAzimuth(pos, sat_pos[s], elevation, azimuth);
+        if (elevation < 0.0) continue;
+        double scalar_iono = Gps::LIGHT_SPEED * Gps::KlobucharDelay(TestIonosphere(), gps_time, lat, lon, elevation, azimuth);
+        double scalar_tropo = Gps::TroposphereDelay(lat, alt, elevation);
+        max_scalar_error = std::max({max_scalar_error, std::abs(iono(r,s) - scalar_iono), std::abs(tropo(r,s) - scalar_tropo)});
+        min_iono = std::min(min_iono, iono(r,s));
+        max_iono = std::max(max_iono, iono(r,s));
+      }
+    }
+  }
+  Gps::AtmosphereModel threaded_model(TestIonosphere(), 4);
+  threaded_model.SetReceivers(rx_pos);
+  Eigen::MatrixXd threaded_iono, threaded_tropo;
+  threaded_model.Compute(300000.0, sat_pos, threaded_iono, threaded_tropo);
+  bool threads_match = (threaded_iono == iono) && (threaded_tropo == tropo);
+
+  // standard atmosphere zenith delay at sea level is about 2.4 m
+  double zenith_error = std::abs(Gps::TroposphereZenithDelay(0.7, 0.0) - 2.4);
+
+  constexpr int repeats = 20;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repeats; i++) {
+    model.Compute(1000.0 + i, sat_pos, iono, tropo);
+  }
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // night-time vertical delay is c * 5 ns, the obliquity factor is at most 3
+  bool passed = (max_scalar_error < 1.0e-4) && (zenith_error < 0.1) && (min_iono > 1.49) && (max_iono < 60.0)
+             && threads_match;
+  std::cout << (passed ? "passed" : "failed") << " (batch vs scalar " << max_scalar_error << " m, ionosphere "
+            << min_iono << " to " << max_iono << " m, " << 1.0e9 * elapsed / (repeats * num_receivers * num_sats)
+            << " ns per pair)\n";
+  return passed;
+}
+
+
+/*
+Enabling the atmosphere in SatelliteDynamics must add exactly the modeled delays to the pseudorange
+and advance the carrier phase by the ionospheric delay.
+*/
+bool DynamicsAtmosphereTest()
+{
+  std::cout << "Dynamics Atmosphere Test: ";
+  Gps::SeedRandom(4);
+  Gps::Ephemeris eph;
+  Gps::ClockData clock;
+  eph.Randomize();
+  clock.Randomize();
+  Gps::SatelliteDynamics plain(eph, clock);
+  Gps::SatelliteDynamics delayed(eph, clock);
+  delayed.SetIonosphere(TestIonosphere());
+  delayed.SetTroposphere(true);
+
+  bool passed = true;
+  std::size_t checked = 0;
+  std::mt19937_64 gen(12);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  Eigen::Vector3d zero = Eigen::Vector3d::Zero();
+  for (int i = 0; i < 2000; i++) {
+    double lat = 1.5 * unit(gen), lon = std::numbers::pi * unit(gen), alt = 500.0 * (unit(gen) + 1.0);
+    Eigen::Vector3d rx_pos = Gps::LlaToEcef(lat, lon, alt);
+    double gps_time = eph.t_oe + (3600.0 * unit(gen));
+    Gps::SignalObservables a, b;
+    plain.Observe(gps_time, rx_pos, zero, zero, a);
+    delayed.Observe(gps_time, rx_pos, zero, zero, b);
+    if (a.elevation < 0.0) continue;
+    checked++;
+    Eigen::Vector3d sat_pos;
+    eph.P(gps_time - 0.075, sat_pos);
+    double elevation, azimuth;
+    Gps::ElevationAzimuth(rx_pos, sat_pos, elevation, azimuth);
+    double iono = Gps::LIGHT_SPEED * Gps::KlobucharDelay(TestIonosphere(), gps_time, lat, lon, b.elevation, azimuth);
+    double tropo = Gps::TroposphereDelay(lat, alt, b.elevation);
+    passed &= (std::abs((b.pseudorange - a.pseudorange) - (b.ionosphere_delay + b.troposphere_delay)) < 1.0e-6)
+           && (std::abs(b.ionosphere_delay - iono) < 1.0e-2) && (std::abs(b.troposphere_delay - tropo) < 1.0e-6);
+
+    Gps::PhasePolynomial pa, pb;
+    plain.Block(gps_time, rx_pos, zero, zero, 0.0, pa);
+    delayed.Block(gps_time, rx_pos, zero, zero, 0.0, pb);
+    double phase_shift = std::remainder(pb.carrier_phase - pa.carrier_phase, TwoPi<double>);
+    double expected = std::remainder(-Gps::L1_RADIANS_PER_METER * (tropo - b.ionosphere_delay), TwoPi<double>);
+    passed &= (std::abs(std::remainder(phase_shift - expected, TwoPi<double>)) < 1.0e-3);
+  }
+  passed &= (checked > 100);
+  std::cout << (passed ? "passed" : "failed") << " (" << checked << " visible)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = Page18Test();
+  passed &= AtmosphereBatchTest();
+  passed &= DynamicsAtmosphereTest();
+  return passed ? 0 : 1;
+}
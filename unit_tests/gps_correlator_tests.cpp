@@ -0,0 +1,470 @@
+#include <iostream>
+#include <complex>
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "vector_math.hpp"
+#include "gps_correlator_sim.hpp"
+#include "gps_cno_estimation.hpp"
+#include "gps_coordinates.hpp"
+#include "gps_correlator_scenario.hpp"
+#include "test_constellation.hpp"
+
+/*
+Verifies the TableMath policy against ExactMath over and beyond the table ranges,
+and that the documented maximum errors hold.
+*/
+bool TableMathTest()
+{
+  std::cout << "Table Math Test: ";
+  double max_sinc_error = 0.0;
+  for (double x = -20.0; x <= 20.0; x += 1.0e-4) {
+    max_sinc_error = std::max(max_sinc_error, std::abs(Gps::TableMath::Sinc(x) - Gps::ExactMath::Sinc(x)));
+  }
+  double max_phasor_error = 0.0;
+  for (double cycles = -3.0; cycles <= 3.0; cycles += 1.0e-5) {
+    std::complex<double> diff = Gps::TableMath::Phasor(cycles) - Gps::ExactMath::Phasor(cycles);
+    max_phasor_error = std::max({max_phasor_error, std::abs(diff.real()), std::abs(diff.imag())});
+  }
+  // out of range arguments fall back to exact evaluation
+  bool exact_fallback = (Gps::TableMath::Sinc(100.0) == Gps::ExactMath::Sinc(100.0))
+                     && (Gps::TableMath::Phasor(1.0e13) == Gps::ExactMath::Phasor(1.0e13));
+
+  bool passed = (max_sinc_error < 6.4e-7) && (max_phasor_error < 1.2e-6) && exact_fallback;
+  std::cout << (passed ? "passed" : "failed") << " (sinc " << max_sinc_error
+            << ", phasor " << max_phasor_error << ")\n";
+  return passed;
+}
+
+
+/*
+Compares correlator outputs computed with each math policy across chip, frequency and phase errors.
+*/
+bool CorrelatorPolicyTest()
+{
+  std::cout << "Correlator Policy Test: ";
+  const double corr_period = 0.001;
+  const double cno = std::pow(10.0, 4.5);
+  const double amplitude = std::sqrt(2.0 * cno * corr_period);
+  double max_error = 0.0;
+  for (double chip = -1.0; chip <= 1.0; chip += 0.05) {
+    for (double freq = -2000.0; freq <= 2000.0; freq += 37.0) {
+      for (double phase = -1.0; phase <= 1.0; phase += 0.013) {
+        std::complex<double> exact = Gps::CalcCorrelatorOutput<double,Gps::ExactMath>(chip, freq, phase, corr_period, cno);
+        std::complex<double> table = Gps::CalcCorrelatorOutput<double,Gps::TableMath>(chip, freq, phase, corr_period, cno);
+        max_error = std::max(max_error, std::abs(exact - table) / amplitude);
+      }
+    }
+  }
+  bool passed = max_error < 2.0e-6;
+  std::cout << (passed ? "passed" : "failed") << " (relative " << max_error << ")\n";
+  return passed;
+}
+
+
+/*
+The streaming accumulator must match averaging the error arrays. A float accumulator fed a million
+samples (one by one and in bulk) must still hold the averages to float precision.
+*/
+bool CorrelatorAccumulatorTest()
+{
+  std::cout << "Correlator Accumulator Test: ";
+  std::vector<double> chips(100), freqs(100), phases(100);
+  Gps::CorrelatorAccumulator<double> accumulator;
+  double chip_sum = 0.0, freq_sum = 0.0, phase_sum = 0.0;
+  for (std::size_t i = 0; i < chips.size(); i++) {
+    chips[i] = 0.1 + (1.0e-3 * static_cast<double>(i));
+    freqs[i] = 5.0 + (0.01 * static_cast<double>(i));
+    phases[i] = 0.2 + (1.0e-3 * static_cast<double>(i));
+    chip_sum += chips[i];
+    freq_sum += freqs[i];
+    phase_sum += phases[i];
+    accumulator.Push(chips[i], freqs[i], phases[i]);
+  }
+  std::complex<double> expected = Gps::CalcCorrelatorOutput(chip_sum / 100.0, freq_sum / 100.0, phase_sum / 100.0,
+                                                             0.001, 1.0e4);
+  std::complex<double> streamed = accumulator.Dump(0.001, 1.0e4);
+  std::complex<double> bulk = Gps::CalcCorrelatorOutput(chips, freqs, phases, 0.001, 1.0e4);
+  bool passed = (std::abs(streamed - expected) < 1.0e-12) && (std::abs(bulk - expected) < 1.0e-12)
+             && (accumulator.Count() == 0);
+
+  // a float running sum of these drifts by about 1e-2 relative
+  constexpr std::size_t num_long = 1000000;
+  std::vector<float> long_chips(num_long), long_freqs(num_long), long_phases(num_long);
+  double long_chip_sum = 0.0, long_freq_sum = 0.0, long_phase_sum = 0.0;
+  Gps::CorrelatorAccumulator<float> single, batched;
+  for (std::size_t i = 0; i < num_long; i++) {
+    long_chips[i] = 0.1f + (1.0e-7f * static_cast<float>(i));
+    long_freqs[i] = 4999.5f + (1.0e-6f * static_cast<float>(i));
+    long_phases[i] = 1.3f + (1.0e-7f * static_cast<float>(i));
+    long_chip_sum += long_chips[i];
+    long_freq_sum += long_freqs[i];
+    long_phase_sum += long_phases[i];
+    single.Push(long_chips[i], long_freqs[i], long_phases[i]);
+  }
+  batched.Push(long_chips, long_freqs, long_phases);
+  double max_long_error = 0.0;
+  for (const Gps::CorrelatorAccumulator<float>* long_accumulator : {&single, &batched}) {
+    max_long_error = std::max({max_long_error,
+      std::abs((long_accumulator->ChipAverage() / (long_chip_sum / num_long)) - 1.0),
+      std::abs((long_accumulator->FreqAverage() / (long_freq_sum / num_long)) - 1.0),
+      std::abs((long_accumulator->PhaseAverage() / (long_phase_sum / num_long)) - 1.0)});
+  }
+  passed &= (max_long_error < 1.0e-7);
+  std::cout << (passed ? "passed" : "failed") << " (float average relative error " << max_long_error << ")\n";
+  return passed;
+}
+
+
+/*
+Feeds prompts at a known C/N0 (with data bit transitions and phase jitter) through the estimator and
+lock detector banks. Each estimator must be within 0.5 dB on average and every channel locked.
+*/
+bool CnoEstimatorTest()
+{
+  std::cout << "C/N0 Estimator Test: ";
+  const std::size_t num_channels = 200;
+  const double corr_period = 0.001;
+  const double cno_db = 45.0;
+  const double amplitude = std::sqrt(2.0 * std::pow(10.0, 0.1 * cno_db) * corr_period);
+  std::mt19937_64 gen(1);
+  std::normal_distribution<double> normal_dist;
+
+  Gps::CnoEstimatorBank<double> estimators(num_channels, corr_period, 1000, 20);
+  Gps::LockDetectorBank<double> detectors(num_channels, corr_period, 20);
+  std::vector<std::complex<double>> prompts(num_channels);
+  for (std::size_t k = 0; k < 1000; k++) {
+    double bit = ((k / 20) % 2 == 0) ? 1.0 : -1.0;
+    for (std::complex<double>& prompt : prompts) {
+      prompt = (bit * std::polar(amplitude, 0.05 * normal_dist(gen)))
+             + std::complex<double>(normal_dist(gen), normal_dist(gen));
+    }
+    estimators.Update(prompts.data());
+    detectors.Update(prompts.data());
+  }
+
+  double nwpr = 0.0, moments = 0.0, beaulieu = 0.0;
+  bool locked = estimators.Ready();
+  for (std::size_t c = 0; c < num_channels; c++) {
+    nwpr += estimators.Nwpr()[c] / num_channels;
+    moments += estimators.Moments()[c] / num_channels;
+    beaulieu += estimators.Beaulieu()[c] / num_channels;
+    locked &= detectors.PhaseLock()[c] && detectors.CodeLock()[c];
+  }
+  bool passed = locked && (std::abs(nwpr - cno_db) < 0.5) && (std::abs(moments - cno_db) < 0.5)
+             && (std::abs(beaulieu - cno_db) < 0.5);
+  std::cout << (passed ? "passed" : "failed") << " (NWPR " << nwpr << ", moments " << moments
+            << ", Beaulieu " << beaulieu << ")\n";
+  return passed;
+}
+
+
+/*
+The branch-free elementary functions must agree with the standard library, in every quadrant and
+at the special points (sinc at 0, log across the sqrt(2) split of the mantissa). The step weights
+must treat signed zeros as documented, and limited values must match std::clamp to an ulp of the
+limit (exactly inside the range).
+*/
+bool VectorMathTest()
+{
+  std::cout << "Vector Math Test: ";
+  std::mt19937_64 gen(3);
+  std::uniform_real_distribution<double> angle_dist(-1.0e4, 1.0e4);
+  std::uniform_real_distribution<double> exponent_dist(-300.0, 300.0);
+  double sincos_error = 0.0, sinc_error = 0.0, log_error = 0.0;
+  for (int k = 0; k < 1000000; k++) {
+    double x = (k < 1000) ? (k * std::numbers::pi / 8.0) : angle_dist(gen);
+    double s, c;
+    FastSinCos(x, s, c);
+    sincos_error = std::max({sincos_error, std::abs(s - std::sin(x)), std::abs(c - std::cos(x))});
+    double y = 1.0e-3 * x;
+    sinc_error = std::max(sinc_error, std::abs(FastSinc(y) - (std::sin(y) / y)));
+    double z = std::pow(10.0, exponent_dist(gen));
+    log_error = std::max(log_error, std::abs(FastLog(z) - std::log(z)) / std::abs(std::log(z)));
+  }
+  for (double m = 1.40; m < 1.43; m += 1.0e-5) {
+    log_error = std::max(log_error, std::abs(FastLog(m) - std::log(m)) / std::abs(std::log(m)));
+  }
+  double clamp_error = 0.0;
+  bool inside_exact = true;
+  std::uniform_real_distribution<double> clamp_dist(-2.0, 2.0);
+  for (int k = 0; k < 100000; k++) {
+    double x = clamp_dist(gen);
+    double clamped = FastClamp(x, -0.416, 0.416);
+    clamp_error = std::max(clamp_error, std::abs(clamped - std::clamp(x, -0.416, 0.416)));
+    inside_exact &= (std::abs(x) > 0.416) || (clamped == x);
+  }
+  bool steps = (StepWeight(0.0) == 1.0) && (StepWeight(-0.0) == 0.0) && (StepWeight(-1.0e-300) == 0.0)
+            && (StepWeight(3.0f) == 1.0f) && (FastMax(-3.0, 0.0) == 0.0) && !std::signbit(FastMax(-3.0, 0.0))
+            && (FastMax(2.5, 0.0) == 2.5) && (FastMin(5.0, 1.0) == 1.0) && (FastMin(-5.0, 1.0) == -5.0)
+            && (FastClamp(1.5, 0.0, 1.0) == 1.0);
+  bool passed = (sincos_error < 1.0e-12) && (sinc_error < 1.0e-15) && (log_error < 1.0e-15)
+             && (FastSinc(0.0) == 1.0) && (FastSinc(0.0f) == 1.0f) && (FastLog(1.0) == 0.0)
+             && (clamp_error < 1.0e-16) && inside_exact && steps;
+  std::cout << (passed ? "passed" : "failed") << " (sincos " << sincos_error << ", sinc " << sinc_error
+            << ", log relative " << log_error << ", clamp " << clamp_error << ")\n";
+  return passed;
+}
+
+
+/*
+The batched structure-of-arrays path must match the scalar ExactMath model, including chip errors
+beyond one chip and zero frequency error. Its noise must be standard normal and independent
+between in-phase and quadrature.
+*/
+bool CorrelatorBatchTest()
+{
+  std::cout << "Correlator Batch Test: ";
+  constexpr std::size_t count = 100000;
+  std::mt19937_64 gen(11);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::vector<double> chips(count), freqs(count), phases(count), periods(count), cnos(count);
+  for (std::size_t i = 0; i < count; i++) {
+    chips[i] = 2.4 * (unit(gen) - 0.5);
+    freqs[i] = (i % 10 == 0) ? 0.0 : 1000.0 * (unit(gen) - 0.5);
+    phases[i] = 6.0 * (unit(gen) - 0.5);
+    periods[i] = (i % 2 == 0) ? 0.001 : 0.02;
+    cnos[i] = std::pow(10.0, 3.0 + (2.0 * unit(gen)));
+  }
+  std::vector<std::complex<double>> outputs(count);
+  Gps::CalcCorrelatorOutputs(outputs.data(), chips.data(), freqs.data(), phases.data(), periods.data(),
+    cnos.data(), count);
+  double max_error = 0.0;
+  std::size_t zeros = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    std::complex<double> scalar = Gps::CalcCorrelatorOutput(chips[i], freqs[i], phases[i], periods[i], cnos[i]);
+    double scale = std::sqrt(2.0 * cnos[i] * periods[i]);
+    max_error = std::max(max_error, std::abs(outputs[i] - scalar) / scale);
+    zeros += (scalar == 0.0) ? 1 : 0;
+  }
+
+  // noise alone
+  constexpr std::size_t noise_count = 1000000;
+  std::vector<std::complex<double>> noise(noise_count, 0.0);
+  Gps::AddCorrelatorNoise(noise.data(), noise_count, gen);
+  double mean_i = 0.0, mean_q = 0.0, var_i = 0.0, var_q = 0.0, cov = 0.0, fourth = 0.0;
+  for (const std::complex<double>& n : noise) {
+    mean_i += n.real() / noise_count;
+    mean_q += n.imag() / noise_count;
+    var_i += n.real() * n.real() / noise_count;
+    var_q += n.imag() * n.imag() / noise_count;
+    cov += n.real() * n.imag() / noise_count;
+    fourth += std::pow(n.real(), 4.0) / noise_count;
+  }
+  // standard errors are 1e-3 for the means and covariance, 1.4e-3 for the variances, 1e-2 for the kurtosis
+  bool passed = (max_error < 1.0e-12) && (zeros > 0.1 * count)
+             && (std::abs(mean_i) < 5.0e-3) && (std::abs(mean_q) < 5.0e-3)
+             && (std::abs(var_i - 1.0) < 7.0e-3) && (std::abs(var_q - 1.0) < 7.0e-3)
+             && (std::abs(cov) < 5.0e-3) && (std::abs((fourth / (var_i * var_i)) - 3.0) < 0.05);
+  std::cout << (passed ? "passed" : "failed") << " (relative error " << max_error << ", noise variance "
+            << var_i << "/" << var_q << ", I/Q covariance " << cov << ", kurtosis " << fourth / (var_i * var_i) << ")\n";
+  return passed;
+}
+
+
+/*
+Multi-tap outputs without noise must equal the single correlator at each tap's chip error, for
+both math policies. The noise between taps must have the code autocorrelation as its covariance
+(in-phase and quadrature each, and none between them), checked on pure noise draws at zero C/N0.
+*/
+bool MultiTapTest()
+{
+  std::cout << "Multi Tap Test: ";
+  const std::array<double,4> offsets = {-0.5, -0.1, 0.0, 0.5};
+  const double corr_period = 0.001;
+  const double cno = std::pow(10.0, 4.5);
+  const double amplitude = std::sqrt(2.0 * cno * corr_period);
+  double exact_error = 0.0, table_error = 0.0;
+  for (double chip = -1.0; chip <= 1.0; chip += 0.07) {
+    for (double freq = -300.0; freq <= 300.0; freq += 41.0) {
+      std::array<std::complex<double>,4> exact, table;
+      Gps::CalcCorrelatorTaps<double,4,Gps::ExactMath>(exact, offsets, chip, freq, 0.3, corr_period, cno);
+      Gps::CalcCorrelatorTaps<double,4,Gps::TableMath>(table, offsets, chip, freq, 0.3, corr_period, cno);
+      for (std::size_t i = 0; i < offsets.size(); i++) {
+        std::complex<double> single = Gps::CalcCorrelatorOutput(chip + offsets[i], freq, 0.3, corr_period, cno);
+        exact_error = std::max(exact_error, std::abs(exact[i] - single) / amplitude);
+        table_error = std::max(table_error, std::abs(table[i] - single) / amplitude);
+      }
+    }
+  }
+
+  constexpr std::size_t num_draws = 200000;
+  Gps::MultiTapCorrelatorSim<double,4,Gps::TableMath> sim(offsets);
+  std::mt19937_64 gen(5);
+  Eigen::Matrix4d in_phase = Eigen::Matrix4d::Zero();
+  Eigen::Matrix4d quadrature = Eigen::Matrix4d::Zero();
+  Eigen::Matrix4d cross = Eigen::Matrix4d::Zero();
+  for (std::size_t k = 0; k < num_draws; k++) {
+    std::array<std::complex<double>,4> outputs;
+    sim.Simulate(outputs, 0.0, 0.0, 0.0, corr_period, 0.0, gen);
+    Eigen::Vector4d i_values, q_values;
+    for (std::size_t i = 0; i < 4; i++) {
+      i_values(i) = outputs[i].real();
+      q_values(i) = outputs[i].imag();
+    }
+    in_phase += i_values * i_values.transpose() / num_draws;
+    quadrature += q_values * q_values.transpose() / num_draws;
+    cross += i_values * q_values.transpose() / num_draws;
+  }
+  // standard error of a unit covariance estimate is at most sqrt(2 / num_draws) = 3.2e-3
+  double covariance_error = std::max((in_phase - sim.NoiseCorrelation()).cwiseAbs().maxCoeff(),
+                                     (quadrature - sim.NoiseCorrelation()).cwiseAbs().maxCoeff());
+  double cross_error = cross.cwiseAbs().maxCoeff();
+  bool passed = (exact_error < 1.0e-14) && (table_error < 2.0e-6) && (covariance_error < 0.015)
+             && (cross_error < 0.015) && (sim.NoiseCorrelation()(1,2) == 0.9) && (sim.NoiseCorrelation()(0,3) == 0.0);
+  std::cout << (passed ? "passed" : "failed") << " (exact " << exact_error << ", table " << table_error
+            << ", covariance " << covariance_error << ", I/Q cross " << cross_error << ")\n";
+  return passed;
+}
+
+
+/*
+End to end C/N0 convention: prompts from CorrelatorSim (scalar and batched paths) at a known C/N0
+with data bit transitions must be estimated at that C/N0 by every estimator. Tracking errors are
+zero here, since any phase jitter legitimately biases the NWPR estimate low at high C/N0.
+*/
+bool CorrelatorCnoTest()
+{
+  std::cout << "Correlator C/N0 Test: ";
+  constexpr std::size_t num_channels = 200;
+  constexpr double corr_period = 0.001;
+  std::mt19937_64 gen(23);
+  Gps::CorrelatorSim<double> sim;
+  bool passed = true;
+  double worst_error = 0.0;
+  for (double cno_db : {35.0, 45.0}) {
+    const double cno = std::pow(10.0, 0.1 * cno_db);
+    Gps::CnoEstimatorBank<double> scalar_bank(num_channels, corr_period, 1000, 20);
+    Gps::CnoEstimatorBank<double> batch_bank(num_channels, corr_period, 1000, 20);
+    std::vector<std::complex<double>> prompts(num_channels);
+    std::vector<double> chips(num_channels, 0.0), freqs(num_channels, 0.0), phases(num_channels, 0.0);
+    std::vector<double> periods(num_channels, corr_period), cnos(num_channels, cno);
+    for (std::size_t k = 0; k < 1000; k++) {
+      double bit = ((k / 20) % 2 == 0) ? 1.0 : -1.0;
+      for (std::complex<double>& prompt : prompts) {
+        prompt = bit * sim.Simulate(0.0, 0.0, 0.0, corr_period, cno);
+      }
+      scalar_bank.Update(prompts.data());
+      sim.Simulate(prompts.data(), chips.data(), freqs.data(), phases.data(), periods.data(), cnos.data(),
+                   num_channels, gen);
+      for (std::complex<double>& prompt : prompts) {
+        prompt *= bit;
+      }
+      batch_bank.Update(prompts.data());
+    }
+    for (const Gps::CnoEstimatorBank<double>* bank : {&scalar_bank, &batch_bank}) {
+      double nwpr = 0.0, moments = 0.0, beaulieu = 0.0;
+      for (std::size_t c = 0; c < num_channels; c++) {
+        nwpr += bank->Nwpr()[c] / num_channels;
+        moments += bank->Moments()[c] / num_channels;
+        beaulieu += bank->Beaulieu()[c] / num_channels;
+      }
+      for (double estimate : {nwpr, moments, beaulieu}) {
+        worst_error = std::max(worst_error, std::abs(estimate - cno_db));
+      }
+      passed &= bank->Ready();
+    }
+  }
+  passed &= (worst_error < 0.3);
+  std::cout << (passed ? "passed" : "failed") << " (worst mean error " << worst_error << " dB)\n";
+  return passed;
+}
+
+
+/*
+Scenario visibility and elevations must match a full light-time solution with the unexpanded
+ephemeris and Sagnac rotation, with the mask applied and C/N0 interpolated in sin(elevation).
+Outputs must depend only on the seed: identical for one and four threads, different for another
+seed. (The geometry only selects satellites and sets C/N0; tracking errors are white draws.)
+*/
+bool CorrelatorScenarioTest()
+{
+  std::cout << "Correlator Scenario Test: ";
+  constexpr double mask = 10.0 * std::numbers::pi / 180.0;
+  const std::vector<Gps::Ephemeris> ephemerides = MakeConstellation();
+  std::vector<Gps::ReceiverTrajectory> receivers;
+  std::vector<Eigen::Vector3d> positions;
+  for (int r = 0; r < 6; r++) {
+    positions.push_back(Gps::LlaToEcef(-1.2 + (0.5 * r), 0.9 * r, 100.0 * r));
+    receivers.push_back(Gps::StaticReceiver(positions.back()));
+  }
+  Gps::TrackingErrorModel model;
+  Gps::CorrelatorScenario serial(ephemerides, receivers, {model}, 0.02, 1.0, mask, 9, 1);
+  Gps::CorrelatorScenario threaded(ephemerides, receivers, {model}, 0.02, 1.0, mask, 9, 4);
+  Gps::CorrelatorScenario reseeded(ephemerides, receivers, {model}, 0.02, 1.0, mask, 10, 4);
+
+  bool passed = true, same_outputs = true, reseed_differs = false;
+  double max_elevation_error = 0.0;
+  std::size_t num_visible = 0, num_masked = 0;
+  for (int step = 0; step < 50; step++) {
+    double gps_time = 7200.0 + (300.0 * step);
+    serial.Step(gps_time);
+    threaded.Step(gps_time);
+    reseeded.Step(gps_time);
+    for (std::size_t r = 0; r < receivers.size(); r++) {
+      const std::vector<Gps::CorrelatorChannel>& channels = serial.Channels(r);
+      std::size_t c = 0;
+      for (std::size_t s = 0; s < ephemerides.size(); s++) {
+        Eigen::Vector3d tx_pos;
+        double light_time = 0.07;
+        for (int i = 0; i < 5; i++) {
+          ephemerides[s].P(gps_time - light_time, tx_pos);
+          double theta = Gps::Ephemeris::WGS84_EARTH_RATE * light_time;
+          tx_pos = Eigen::Vector3d(tx_pos(0) + (theta * tx_pos(1)), tx_pos(1) - (theta * tx_pos(0)), tx_pos(2));
+          light_time = (tx_pos - positions[r]).norm() / Gps::LIGHT_SPEED;
+        }
+        double elevation = Gps::Elevation(positions[r], tx_pos);
+        bool listed = (c < channels.size()) && (channels[c].satellite == s);
+        if (std::abs(elevation - mask) < 1.0e-6) {
+          c += listed ? 1 : 0;
+          continue;
+        }
+        passed &= (listed == (elevation >= mask));
+        if (!listed) {
+          num_masked++;
+          continue;
+        }
+        const Gps::CorrelatorChannel& channel = channels[c++];
+        max_elevation_error = std::max(max_elevation_error, std::abs(channel.elevation - elevation));
+        double cno = model.horizon_cno + ((model.zenith_cno - model.horizon_cno) * std::sin(channel.elevation));
+        passed &= (std::abs(channel.cno - cno) < 1.0e-9);
+        num_visible++;
+      }
+      passed &= (c == channels.size());
+
+      const std::vector<Gps::CorrelatorChannel>& other = threaded.Channels(r);
+      same_outputs &= (other.size() == channels.size());
+      for (std::size_t k = 0; same_outputs && (k < channels.size()); k++) {
+        same_outputs &= (other[k].satellite == channels[k].satellite) && (other[k].taps == channels[k].taps);
+      }
+      const std::vector<Gps::CorrelatorChannel>& reseed = reseeded.Channels(r);
+      reseed_differs |= !reseed.empty() && (reseed[0].taps != channels[0].taps);
+    }
+  }
+  passed &= same_outputs && reseed_differs && (max_elevation_error < 1.0e-8) && (num_visible > 1000)
+         && (num_masked > 1000);
+  std::cout << (passed ? "passed" : "failed") << " (" << num_visible << " visible, " << num_masked
+            << " masked, elevation error " << max_elevation_error << " rad)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = TableMathTest();
+  passed &= CorrelatorPolicyTest();
+  passed &= CorrelatorAccumulatorTest();
+  passed &= CnoEstimatorTest();
+  passed &= VectorMathTest();
+  passed &= CorrelatorBatchTest();
+  passed &= MultiTapTest();
+  passed &= CorrelatorCnoTest();
+  passed &= CorrelatorScenarioTest();
+  return passed ? 0 : 1;
+}
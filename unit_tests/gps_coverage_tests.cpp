@@ -0,0 +1,156 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "gps_coordinates.hpp"
+#include "gps_coverage.hpp"
+#include "test_constellation.hpp"
+
+/*
+Compares the closed-form DOPs to an Eigen inverse of the normal matrix, rotated to the local frame,
+at random points and epochs. A thinned constellation and high mask give epochs with fewer than four
+satellites, which must come out as NaN.
+*/
+bool CoverageReferenceTest()
+{
+  std::cout << "Coverage Reference Test: ";
+  constexpr std::size_t num_points = 300;
+  constexpr double mask = 15.0 * std::numbers::pi / 180.0;
+  std::vector<Gps::Ephemeris> ephemerides = MakeConstellation();
+  ephemerides.resize(14);
+  std::mt19937_64 gen(21);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  Gps::SoaVector3 points(num_points, 3);
+  for (std::size_t p = 0; p < num_points; p++) {
+    points.row(p) = Gps::LlaToEcef(1.5 * unit(gen), std::numbers::pi * unit(gen), 3000.0 * (unit(gen) + 1.0));
+  }
+  std::vector<double> gps_times;
+  for (int e = 0; e < 40; e++) {
+    gps_times.push_back(7200.0 + (1800.0 * e));
+  }
+
+  Gps::CoverageModel model(ephemerides, points, mask, 2);
+  Gps::DopMaps dops;
+  model.Compute(gps_times, dops);
+
+  bool passed = (dops.gdop.rows() == num_points) && (dops.gdop.cols() == static_cast<Eigen::Index>(gps_times.size()));
+  double max_error = 0.0;
+  std::size_t solved = 0, unsolved = 0;
+  for (std::size_t e = 0; e < gps_times.size(); e++) {
+    std::vector<Eigen::Vector3d> sat_pos(ephemerides.size());
+    for (std::size_t s = 0; s < ephemerides.size(); s++) {
+      ephemerides[s].P(gps_times[e], sat_pos[s]);
+    }
+    for (std::size_t p = 0; p < num_points; p++) {
+      Eigen::Vector3d pos = points.row(p).transpose();
+      Eigen::Matrix4d normal = Eigen::Matrix4d::Zero();
+      int visible = 0;
+      for (const Eigen::Vector3d& sat : sat_pos) {
+        if (Gps::Elevation(pos, sat) < mask) continue;
+        Eigen::Vector4d row;
+        row << -(sat - pos).normalized(), 1.0;
+        normal += row * row.transpose();
+        visible++;
+      }
+      passed &= (dops.num_visible(p,e) == visible);
+      if (visible < 4) {
+        passed &= std::isnan(dops.gdop(p,e)) && std::isnan(dops.pdop(p,e))
+               && std::isnan(dops.hdop(p,e)) && std::isnan(dops.vdop(p,e));
+        unsolved++;
+        continue;
+      }
+      double lat, lon, alt;
+      Gps::EcefToLla(pos, lat, lon, alt);
+      Eigen::Matrix3d rotation = Gps::EcefToEnuRotation(lat, lon);
+      Eigen::Matrix4d cofactor = normal.inverse();
+      Eigen::Matrix3d local = rotation * cofactor.topLeftCorner<3,3>() * rotation.transpose();
+      double gdop = std::sqrt(cofactor.trace());
+      double pdop = std::sqrt(local.trace());
+      double hdop = std::sqrt(local(0,0) + local(1,1));
+      double vdop = std::sqrt(local(2,2));
+      max_error = std::max({max_error, std::abs(dops.gdop(p,e) - gdop) / gdop, std::abs(dops.pdop(p,e) - pdop) / pdop,
+                            std::abs(dops.hdop(p,e) - hdop) / hdop, std::abs(dops.vdop(p,e) - vdop) / vdop});
+      solved++;
+    }
+  }
+  passed &= (max_error < 1.0e-8) && (solved > 1000) && (unsolved > 100);
+  std::cout << (passed ? "passed" : "failed") << " (" << solved << " solved, " << unsolved
+            << " unsolved, max relative error " << max_error << ")\n";
+  return passed;
+}
+
+
+/*
+Summarizes a global 2 degree grid over one day at 5 minute epochs, checking the percentiles against
+sorted dense maps at a sample of points, then times it and scales to a 1 degree grid at 1 minute
+epochs.
+*/
+bool CoverageSummaryTest()
+{
+  std::cout << "Coverage Summary Test: ";
+  constexpr double pi = std::numbers::pi;
+  const std::vector<Gps::Ephemeris> ephemerides = MakeConstellation();
+  Gps::SoaVector3 points = Gps::LatLonGrid(-pi / 2.0, pi / 2.0, 91, -pi, pi - (pi / 90.0), 180);
+  std::vector<double> gps_times;
+  for (int e = 0; e < 288; e++) {
+    gps_times.push_back(300.0 * e);
+  }
+  const std::vector<double> percentiles = {50.0, 95.0, 0.0, 100.0};
+
+  Gps::CoverageModel model(ephemerides, points, 5.0 * pi / 180.0);
+  Gps::DopSummary summary;
+  auto start = std::chrono::steady_clock::now();
+  model.Summarize(gps_times, percentiles, summary);
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::vector<std::size_t> indices;
+  for (std::size_t p = 0; p < model.NumPoints(); p += 97) {
+    indices.push_back(p);
+  }
+  Gps::SoaVector3 sample(indices.size(), 3);
+  for (std::size_t k = 0; k < indices.size(); k++) {
+    sample.row(k) = points.row(indices[k]);
+  }
+  Gps::CoverageModel dense_model(ephemerides, sample, 5.0 * pi / 180.0);
+  Gps::DopMaps dops;
+  dense_model.Compute(gps_times, dops);
+
+  bool passed = (summary.gdop.rows() == points.rows()) && (summary.gdop.cols() == 4);
+  for (std::size_t k = 0; k < indices.size(); k++) {
+    std::vector<double> values(gps_times.size());
+    std::size_t available = 0;
+    for (std::size_t e = 0; e < gps_times.size(); e++) {
+      bool valid = !std::isnan(dops.pdop(k,e));
+      values[e] = valid ? dops.pdop(k,e) : std::numeric_limits<double>::infinity();
+      available += valid ? 1 : 0;
+    }
+    std::sort(values.begin(), values.end());
+    passed &= (summary.pdop(indices[k],0) == values[143]) && (summary.pdop(indices[k],1) == values[273])
+           && (summary.pdop(indices[k],2) == values[0]) && (summary.pdop(indices[k],3) == values[287])
+           && (summary.availability(indices[k]) == static_cast<double>(available) / gps_times.size());
+  }
+  // ordering of the DOPs and a sensible median for a full constellation
+  double worst_median = summary.pdop.col(0).maxCoeff();
+  passed &= (summary.hdop.array() <= summary.pdop.array()).all() && (summary.vdop.array() <= summary.pdop.array()).all()
+         && (summary.pdop.array() <= summary.gdop.array()).all() && (worst_median < 10.0)
+         && (summary.availability.minCoeff() > 0.9);
+
+  double scaled = elapsed * (181.0 * 360.0 / points.rows()) * 5.0;
+  std::cout << (passed ? "passed" : "failed") << " (worst median PDOP " << worst_median << ", min availability "
+            << summary.availability.minCoeff() << ", " << elapsed << " s, ~" << scaled
+            << " s for 1 degree / 1 minute)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = CoverageReferenceTest();
+  passed &= CoverageSummaryTest();
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gps_ephemeris_store.hpp"
+
+// A GPS-like orbit with its epoch and a clock offset that tags it with the same epoch
+void MakeSet(const uint16_t week, const double t_oe, const uint8_t iode, Gps::Ephemeris& eph, Gps::ClockData& clock)
+{
+  eph = Gps::Ephemeris();
+  eph.sqrtA = 5153.7;
+  eph.e = 0.01;
+  eph.i_0 = 0.96;
+  eph.t_oe = t_oe;
+  eph.IODE = iode;
+  clock = Gps::ClockData();
+  clock.t_oc = t_oe;
+  clock.a_f0 = (604800.0 * week) + t_oe;
+}
+
+
+// True if a snapshot is ordered by epoch, within the size limit and every set agrees with its tag
+bool Consistent(const Gps::EphemerisStore::SetList& sets, const uint8_t prn, const std::size_t max_sets)
+{
+  bool consistent = (sets.size() <= max_sets);
+  for (std::size_t k = 0; k < sets.size(); k++) {
+    consistent &= (sets[k].prn == prn) && (sets[k].clock_data.a_f0 == sets[k].Epoch());
+    if (k > 0) {
+      consistent &= (sets[k - 1].Epoch() < sets[k].Epoch());
+    }
+  }
+  return consistent;
+}
+
+
+/*
+Inserts 2 hour uploads spanning the end of week 2000 in shuffled order, then checks that the store
+keeps the four latest by continuous time (ordering by t_oe alone would evict the week 2001 sets
+first), that selection picks the closest set on either side of the rollover with the later upload
+winning a tie, and that only an upload with the same IODE and epoch is replaced.
+*/
+bool RolloverTest()
+{
+  std::cout << "Rollover Test: ";
+  constexpr uint8_t prn = 5;
+  struct Upload { uint16_t week; double t_oe; };
+  std::vector<Upload> uploads = {{2000, 590400.0}, {2000, 597600.0}, {2001, 0.0}, {2001, 7200.0}, {2001, 14400.0},
+                                 {2000, 583200.0}};
+  std::mt19937_64 gen(7);
+  std::shuffle(uploads.begin(), uploads.end(), gen);
+
+  Gps::EphemerisStore store(4);
+  Gps::Ephemeris eph;
+  Gps::ClockData clock;
+  bool passed = true;
+  for (const Upload& upload : uploads) {
+    MakeSet(upload.week, upload.t_oe, static_cast<uint8_t>(upload.t_oe / 7200.0), eph, clock);
+    passed &= store.Insert(prn, upload.week, eph, clock);
+  }
+  std::shared_ptr<const Gps::EphemerisStore::SetList> sets = store.Sets(prn);
+  const double expected[4] = {(604800.0 * 2000) + 597600.0, 604800.0 * 2001, (604800.0 * 2001) + 7200.0,
+                              (604800.0 * 2001) + 14400.0};
+  passed &= (sets->size() == 4) && Consistent(*sets, prn, 4);
+  for (std::size_t k = 0; passed && k < 4; k++) {
+    passed &= (sets->at(k).Epoch() == expected[k]);
+  }
+
+  // closest set, across the rollover in both directions, later upload on a tie
+  auto selected_epoch = [&store](const double gps_time)
+  {
+    std::shared_ptr<const Gps::NavigationSet> set = store.Select(prn, gps_time);
+    return (set == nullptr) ? -1.0 : set->Epoch();
+  };
+  passed &= (selected_epoch(598000.0) == expected[0]) && (selected_epoch(603000.0) == expected[1])
+         && (selected_epoch(601200.0) == expected[1]) && (selected_epoch(500.0) == expected[1])
+         && (selected_epoch(13000.0) == expected[3]) && (selected_epoch(590000.0) == -1.0)
+         && (selected_epoch(30000.0) == -1.0);
+
+  // same IODE and epoch replaces, same t_oe in an older week is a different (and evicted) upload
+  MakeSet(2001, 7200.0, 1, eph, clock);
+  clock.T_GD = 1.0e-9;
+  passed &= store.Insert(prn, 2001, eph, clock);
+  MakeSet(2000, 7200.0, 1, eph, clock);
+  passed &= store.Insert(prn, 2000, eph, clock);
+  sets = store.Sets(prn);
+  passed &= (sets->size() == 4) && Consistent(*sets, prn, 4) && (sets->at(2).Epoch() == expected[2])
+         && (sets->at(2).clock_data.T_GD == 1.0e-9) && (sets->front().Epoch() == expected[0]);
+  passed &= !store.Insert(0, 2001, eph, clock) && !store.Insert(Gps::EphemerisStore::MAX_PRN + 1, 2001, eph, clock)
+         && (store.Select(0, 0.0) == nullptr);
+
+  std::cout << (passed ? "passed" : "failed") << '\n';
+  return passed;
+}
+
+
+/*
+One writer streams 10 minute uploads for eight PRNs through a week rollover while readers take
+snapshots and select at the newest epoch they saw. Every snapshot must be ordered, within the size
+limit and untorn, selecting from it must find its newest set, a selection from the store must be
+that set or a later one, and a set held from the start must stay intact after it is evicted.
+*/
+bool ConcurrentTest()
+{
+  std::cout << "Concurrent Test: ";
+  constexpr std::size_t max_sets = 4;
+  constexpr uint8_t num_prns = 8;
+  constexpr int num_uploads = 600;
+  constexpr unsigned int num_readers = 3;
+  constexpr double start = (604800.0 * 2000) + 604800.0 - (300.0 * 600.0);
+
+  Gps::EphemerisStore store(max_sets);
+  Gps::Ephemeris eph;
+  Gps::ClockData clock;
+  for (uint8_t prn = 1; prn <= num_prns; prn++) {
+    MakeSet(2000, std::fmod(start, 604800.0), 0, eph, clock);
+    store.Insert(prn, 2000, eph, clock);
+  }
+  std::shared_ptr<const Gps::NavigationSet> held = store.Select(1, std::fmod(start, 604800.0));
+
+  std::atomic<bool> done {false};
+  std::atomic<bool> failed {false};
+  std::atomic<std::size_t> reads {0};
+  std::vector<std::thread> readers;
+  for (unsigned int r = 0; r < num_readers; r++) {
+    readers.emplace_back([&, r]()
+    {
+      std::mt19937_64 gen(r);
+      std::uniform_int_distribution<int> random_prn(1, num_prns);
+      std::size_t count = 0;
+      while (!done.load(std::memory_order_acquire)) {
+        uint8_t prn = static_cast<uint8_t>(random_prn(gen));
+        std::shared_ptr<const Gps::EphemerisStore::SetList> sets = store.Sets(prn);
+        bool ok = !sets->empty() && Consistent(*sets, prn, max_sets);
+        if (ok) {
+          // the store may have moved past the snapshot's fit intervals, so only its answer may be empty
+          double tow = std::fmod(sets->back().Epoch(), 604800.0);
+          std::shared_ptr<const Gps::NavigationSet> set = store.Select(prn, tow);
+          ok = (Gps::EphemerisStore::Select(*sets, tow) == &sets->back())
+            && ((set == nullptr) || ((set->prn == prn) && (set->clock_data.a_f0 == set->Epoch())
+                                     && (set->Epoch() >= sets->back().Epoch())));
+        }
+        if (!ok) {
+          failed.store(true);
+        }
+        count++;
+      }
+      reads += count;
+    });
+  }
+
+  for (int k = 1; k <= num_uploads; k++) {
+    double epoch = start + (600.0 * k);
+    uint16_t week = static_cast<uint16_t>(std::floor(epoch / 604800.0));
+    for (uint8_t prn = 1; prn <= num_prns; prn++) {
+      MakeSet(week, epoch - (604800.0 * week), static_cast<uint8_t>(k), eph, clock);
+      store.Insert(prn, week, eph, clock);
+    }
+    if (k % 8 == 0) {
+      std::this_thread::yield();
+    }
+  }
+  done.store(true, std::memory_order_release);
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+
+  bool passed = !failed.load() && (held != nullptr) && (held->clock_data.a_f0 == start) && (held->Epoch() == start);
+  for (uint8_t prn = 1; prn <= num_prns; prn++) {
+    std::shared_ptr<const Gps::EphemerisStore::SetList> sets = store.Sets(prn);
+    passed &= (sets->size() == max_sets) && Consistent(*sets, prn, max_sets)
+           && (sets->back().Epoch() == start + (600.0 * num_uploads));
+  }
+  std::cout << (passed ? "passed" : "failed") << " (" << reads.load() << " reads during "
+            << (num_uploads * num_prns) << " inserts)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = RolloverTest();
+  passed &= ConcurrentTest();
+  return passed ? 0 : 1;
+}
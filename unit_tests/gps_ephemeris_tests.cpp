@@ -0,0 +1,440 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+#include "gps_ephemeris.hpp"
+#include "gps_kepler.hpp"
+#include "gps_ephemeris_set.hpp"
+#include "gps_orbit_interpolator.hpp"
+
+// Random broadcast-range ephemerides, every fourth one with its epoch at the start or end of the
+// week so that the evaluation times cross the rollover
+std::vector<Gps::Ephemeris> RandomEphemerides(const std::size_t count, std::mt19937_64& gen)
+{
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  std::vector<Gps::Ephemeris> ephemerides(count);
+  for (std::size_t s = 0; s < count; s++) {
+    ephemerides[s].Randomize();
+    if (s % 4 == 1) ephemerides[s].t_oe = 7200.0 * unit(gen);
+    if (s % 4 == 3) ephemerides[s].t_oe = 604800.0 - (7200.0 * unit(gen));
+  }
+  return ephemerides;
+}
+
+// Kepler's equation by Newton steps in long double until converged
+double ReferenceE(const double M, const double e)
+{
+  long double E = M;
+  for (int i = 0; i < 50; i++) {
+    E -= (E - (e * std::sin(E)) - M) / (1.0L - (e * std::cos(E)));
+  }
+  return static_cast<double>(E);
+}
+
+// IS-GPS-200 user algorithm with library trigonometry, the true anomaly by atan2 and a converged
+// Kepler solve, independent of the fused evaluation
+void ReferenceOrbit(const Gps::Ephemeris& eph, const double gps_time, Gps::OrbitState& state)
+{
+  constexpr double mu = Gps::Ephemeris::WGS84_MU;
+  constexpr double omega_e = Gps::Ephemeris::WGS84_EARTH_RATE;
+  double A = eph.sqrtA * eph.sqrtA;
+  double n = std::sqrt(mu / (A * A * A)) + eph.del_n;
+  double t_k = gps_time - eph.t_oe;
+  t_k += (t_k < -302400.0) ? 604800.0 : ((t_k > 302400.0) ? -604800.0 : 0.0);
+  double E_k = ReferenceE(eph.M_0 + (n * t_k), eph.e);
+  double denom = 1.0 - (eph.e * std::cos(E_k));
+  double v_k = std::atan2(std::sqrt(1.0 - (eph.e * eph.e)) * std::sin(E_k) / denom, (std::cos(E_k) - eph.e) / denom);
+  double Phi = v_k + eph.omega;
+  double du_k = (eph.C_us * std::sin(2.0 * Phi)) + (eph.C_uc * std::cos(2.0 * Phi));
+  double dr_k = (eph.C_rs * std::sin(2.0 * Phi)) + (eph.C_rc * std::cos(2.0 * Phi));
+  double di_k = (eph.C_is * std::sin(2.0 * Phi)) + (eph.C_ic * std::cos(2.0 * Phi));
+  double u_k = Phi + du_k;
+  double r_k = (A * denom) + dr_k;
+  double i_k = eph.i_0 + di_k + (eph.IDOT * t_k);
+  double x_orb = r_k * std::cos(u_k);
+  double y_orb = r_k * std::sin(u_k);
+  double Omega_dot_k = eph.Omega_dot - omega_e;
+  double Omega_k = eph.Omega_0 + (Omega_dot_k * t_k) - (omega_e * eph.t_oe);
+  state.pos << (x_orb * std::cos(Omega_k)) - (y_orb * std::cos(i_k) * std::sin(Omega_k)),
+               (x_orb * std::sin(Omega_k)) + (y_orb * std::cos(i_k) * std::cos(Omega_k)),
+               y_orb * std::sin(i_k);
+
+  double Ed_k = n / denom;
+  double vd_k = Ed_k * std::sqrt(1.0 - (eph.e * eph.e)) / denom;
+  double id_k = eph.IDOT + (2.0 * vd_k * ((eph.C_is * std::cos(2.0 * Phi)) - (eph.C_ic * std::sin(2.0 * Phi))));
+  double ud_k = vd_k + (2.0 * vd_k * ((eph.C_us * std::cos(2.0 * Phi)) - (eph.C_uc * std::sin(2.0 * Phi))));
+  double rd_k = (eph.e * A * Ed_k * std::sin(E_k)) + (2.0 * vd_k * ((eph.C_rs * std::cos(2.0 * Phi)) - (eph.C_rc * std::sin(2.0 * Phi))));
+  double xd_orb = (rd_k * std::cos(u_k)) - (r_k * ud_k * std::sin(u_k));
+  double yd_orb = (rd_k * std::sin(u_k)) + (r_k * ud_k * std::cos(u_k));
+  state.vel << (-x_orb * Omega_dot_k * std::sin(Omega_k)) + (xd_orb * std::cos(Omega_k)) - (yd_orb * std::sin(Omega_k) * std::cos(i_k))
+                 - (y_orb * ((Omega_dot_k * std::cos(Omega_k) * std::cos(i_k)) - (id_k * std::sin(Omega_k) * std::sin(i_k)))),
+               (x_orb * Omega_dot_k * std::cos(Omega_k)) + (xd_orb * std::sin(Omega_k)) + (yd_orb * std::cos(Omega_k) * std::cos(i_k))
+                 - (y_orb * ((Omega_dot_k * std::sin(Omega_k) * std::cos(i_k)) + (id_k * std::cos(Omega_k) * std::sin(i_k)))),
+               (yd_orb * std::sin(i_k)) + (y_orb * id_k * std::cos(i_k));
+
+  double r = r_k;
+  double F = -1.5 * Gps::Ephemeris::J2 * (mu / (r * r)) * std::pow(Gps::Ephemeris::WGS84_EQUAT_RADIUS / r, 2.0);
+  double z_r2 = std::pow(state.pos(2) / r, 2.0);
+  state.accel << (-mu * state.pos(0) / (r * r * r)) + (F * (1.0 - (5.0 * z_r2)) * state.pos(0) / r)
+                   + (2.0 * state.vel(1) * omega_e) + (state.pos(0) * omega_e * omega_e),
+                 (-mu * state.pos(1) / (r * r * r)) + (F * (1.0 - (5.0 * z_r2)) * state.pos(1) / r)
+                   - (2.0 * state.vel(0) * omega_e) + (state.pos(1) * omega_e * omega_e),
+                 (-mu * state.pos(2) / (r * r * r)) + (F * (3.0 - (5.0 * z_r2)) * state.pos(2) / r);
+
+  double scale = Gps::Ephemeris::RELETIVISTIC_F * eph.e * eph.sqrtA;
+  state.rel_time = scale * std::sin(E_k);
+  state.rel_time_rate = scale * std::cos(E_k) * Ed_k;
+  state.rel_time_rate_rate = -scale * std::sin(E_k) * n * n / (denom * denom * denom);
+}
+
+// Time of week within four hours of the ephemeris epoch
+double NearEpoch(const Gps::Ephemeris& eph, std::mt19937_64& gen)
+{
+  std::uniform_real_distribution<double> offset(-14400.0, 14400.0);
+  double gps_time = eph.t_oe + offset(gen);
+  gps_time += (gps_time < 0.0) ? 604800.0 : 0.0;
+  gps_time -= (gps_time >= 604800.0) ? 604800.0 : 0.0;
+  return gps_time;
+}
+
+
+/*
+Evaluates an EphemerisSet of random ephemerides at random times (crossing the week for some) and
+compares position, velocity and acceleration with Ephemeris::P/PV/PVA for each satellite.
+*/
+bool EphemerisSetTest()
+{
+  std::cout << "Ephemeris Set Test: ";
+  constexpr std::size_t num_sats = 64;
+  std::mt19937_64 gen(38);
+  const std::vector<Gps::Ephemeris> ephemerides = RandomEphemerides(num_sats, gen);
+  Gps::EphemerisSet set(ephemerides);
+
+  double max_pos_error = 0.0, max_vel_error = 0.0, max_accel_error = 0.0;
+  Gps::SoaVector3 pos_p, pos, vel, pos_a, vel_a, accel;
+  for (int trial = 0; trial < 200; trial++) {
+    double gps_time = NearEpoch(ephemerides[trial % num_sats], gen);
+    set.P(gps_time, pos_p);
+    set.PV(gps_time, pos, vel);
+    set.PVA(gps_time, pos_a, vel_a, accel);
+    for (std::size_t s = 0; s < num_sats; s++) {
+      Eigen::Vector3d ref_pos, ref_vel, ref_accel;
+      ephemerides[s].PVA(gps_time, ref_pos, ref_vel, ref_accel);
+      max_pos_error = std::max({max_pos_error, (pos_p.row(s).transpose() - ref_pos).norm(),
+                                (pos.row(s).transpose() - ref_pos).norm(), (pos_a.row(s).transpose() - ref_pos).norm()});
+      max_vel_error = std::max({max_vel_error, (vel.row(s).transpose() - ref_vel).norm(),
+                                (vel_a.row(s).transpose() - ref_vel).norm()});
+      max_accel_error = std::max(max_accel_error, (accel.row(s).transpose() - ref_accel).norm());
+    }
+  }
+  bool passed = (max_pos_error < 1.0e-6) && (max_vel_error < 1.0e-9) && (max_accel_error < 1.0e-12);
+  std::cout << (passed ? "passed" : "failed") << " (max position error " << max_pos_error << " m, velocity "
+            << max_vel_error << " m/s, acceleration " << max_accel_error << " m/s^2)\n";
+  return passed;
+}
+
+
+/*
+Solves Kepler's equation at random mean anomalies (|M| up to 50 rad, beyond a week of GPS orbit
+propagation) for eccentricities up to 0.3 and compares E, sin(E) and cos(E) to a converged long
+double Newton solve. Two steps must be within a few ulp up to e = 0.1 and within the documented
+2e-13 and 9e-11 at 0.2 and 0.3; three steps within a few ulp everywhere. SmallSinCos is checked on
+its whole documented range.
+*/
+bool KeplerTest()
+{
+  std::cout << "Kepler Test: ";
+  std::mt19937_64 gen(39);
+  std::uniform_real_distribution<double> anomaly(-50.0, 50.0);
+  bool passed = true;
+  double max_error_gps = 0.0, max_error_03 = 0.0, max_error_03_three = 0.0;
+  for (double e : {0.0, 0.01, 0.03, 0.1, 0.2, 0.3}) {
+    double max_error = 0.0, max_error_three = 0.0;
+    for (int k = 0; k < 100000; k++) {
+      double M = anomaly(gen);
+      double E_ref = ReferenceE(M, e);
+      double sin_E, cos_E;
+      double E = Gps::SolveKepler(M, e, sin_E, cos_E);
+      max_error = std::max({max_error, std::abs(E - E_ref), std::abs(sin_E - std::sin(E_ref)),
+                            std::abs(cos_E - std::cos(E_ref))});
+      E = Gps::SolveKepler(M, e, sin_E, cos_E, 3);
+      max_error_three = std::max({max_error_three, std::abs(E - E_ref), std::abs(sin_E - std::sin(E_ref)),
+                                  std::abs(cos_E - std::cos(E_ref))});
+    }
+    double bound = (e <= 0.1) ? 1.0e-14 : ((e <= 0.2) ? 3.0e-13 : 1.0e-10);
+    passed &= (max_error < bound) && (max_error_three < 1.0e-14);
+    if (e <= 0.03) max_error_gps = std::max(max_error_gps, max_error);
+    if (e == 0.3) {
+      max_error_03 = max_error;
+      max_error_03_three = max_error_three;
+    }
+  }
+
+  double max_series_error = 0.0;
+  for (int k = -5000; k <= 5000; k++) {
+    double d = 0.5 * k / 5000.0;
+    double sin_d, cos_d;
+    Gps::internal::SmallSinCos(d, sin_d, cos_d);
+    max_series_error = std::max({max_series_error, std::abs(sin_d - std::sin(d)), std::abs(cos_d - std::cos(d))});
+  }
+  passed &= (max_series_error < 2.5e-16);
+
+  std::cout << (passed ? "passed" : "failed") << " (e <= 0.03 " << max_error_gps << ", e = 0.3 " << max_error_03
+            << " with two steps and " << max_error_03_three << " with three, series " << max_series_error << ")\n";
+  return passed;
+}
+
+
+/*
+Compares Ephemeris::EfromTime, scalar and batched, to the reference solve from the mean anomaly at
+times that cross the week rollover, and the relativistic clock correction and its two derivatives
+to F e sqrt(A) sin(E) and central differences of it.
+*/
+bool EfromTimeTest()
+{
+  std::cout << "E from Time Test: ";
+  constexpr double F = Gps::Ephemeris::RELETIVISTIC_F;
+  std::mt19937_64 gen(139);
+  const std::vector<Gps::Ephemeris> ephemerides = RandomEphemerides(32, gen);
+  double max_E_error = 0.0, max_batch_error = 0.0, max_rel_error = 0.0;
+  double max_rate_error = 0.0, max_rate_rate_error = 0.0;
+  for (const Gps::Ephemeris& eph : ephemerides) {
+    std::vector<double> times(64), E(64), sin_E(64), cos_E(64), rel(64);
+    for (double& t : times) {
+      t = NearEpoch(eph, gen);
+    }
+    eph.EfromTime(times.data(), E.data(), sin_E.data(), cos_E.data(), times.size());
+    eph.RelTime(times.data(), rel.data(), times.size());
+    const double scale = F * eph.e * eph.sqrtA;
+    const double n = eph.MeanMotion();
+    for (std::size_t i = 0; i < times.size(); i++) {
+      double t_k = times[i] - eph.t_oe;
+      t_k += (t_k < -302400.0) ? 604800.0 : ((t_k > 302400.0) ? -604800.0 : 0.0);
+      double E_ref = ReferenceE(eph.M_0 + (n * t_k), eph.e);
+      max_E_error = std::max(max_E_error, std::abs(eph.EfromTime(times[i]) - E_ref));
+      max_batch_error = std::max({max_batch_error, std::abs(E[i] - E_ref), std::abs(sin_E[i] - std::sin(E_ref)),
+                                  std::abs(cos_E[i] - std::cos(E_ref))});
+
+      // the correction is below 2e-7 s, its rate below 3e-11 and its second derivative below 5e-15 1/s
+      double rel_ref = scale * std::sin(E_ref);
+      max_rel_error = std::max({max_rel_error, std::abs(eph.RelTime(times[i]) - rel_ref) / 2.0e-7,
+                                std::abs(rel[i] - rel_ref) / 2.0e-7});
+      constexpr double h = 1.0;
+      double before = eph.RelTime(times[i] - h), after = eph.RelTime(times[i] + h);
+      double rate = (after - before) / (2.0 * h);
+      double rate_rate = (after - (2.0 * rel_ref) + before) / (h * h);
+      max_rate_error = std::max(max_rate_error, std::abs(eph.RelTimeRate(times[i]) - rate) / 3.0e-11);
+      max_rate_rate_error = std::max(max_rate_rate_error, std::abs(eph.RelTimeRateRate(times[i]) - rate_rate) / 5.0e-15);
+    }
+  }
+  bool passed = (max_E_error < 1.0e-14) && (max_batch_error < 1.0e-14) && (max_rel_error < 1.0e-14)
+             && (max_rate_error < 1.0e-6) && (max_rate_rate_error < 1.0e-5);
+  std::cout << (passed ? "passed" : "failed") << " (E " << max_E_error << ", batched " << max_batch_error
+            << ", relative errors of the clock correction " << max_rel_error << ", rate " << max_rate_error
+            << ", rate rate " << max_rate_rate_error << ")\n";
+  return passed;
+}
+
+
+/*
+Compares PreparedEphemeris::Evaluate and Ephemeris::PVA, RelTimeRate and RelTimeRateRate to the
+reference algorithm for random ephemerides, and the reference velocity to central differences of
+the reference position, which pins down the node-rate and inclination-rate terms of vel(0).
+*/
+bool PreparedEphemerisTest()
+{
+  std::cout << "Prepared Ephemeris Test: ";
+  std::mt19937_64 gen(40);
+  const std::vector<Gps::Ephemeris> ephemerides = RandomEphemerides(64, gen);
+  double max_pos_error = 0.0, max_vel_error = 0.0, max_accel_error = 0.0, max_rel_error = 0.0;
+  double max_direct_error = 0.0, max_difference_error = 0.0;
+  for (const Gps::Ephemeris& eph : ephemerides) {
+    Gps::PreparedEphemeris prepared(eph);
+    for (int trial = 0; trial < 50; trial++) {
+      double gps_time = NearEpoch(eph, gen);
+      Gps::OrbitState ref, state;
+      ReferenceOrbit(eph, gps_time, ref);
+      prepared.Evaluate(gps_time, state);
+      max_pos_error = std::max(max_pos_error, (state.pos - ref.pos).norm());
+      max_vel_error = std::max(max_vel_error, (state.vel - ref.vel).norm());
+      max_accel_error = std::max(max_accel_error, (state.accel - ref.accel).norm());
+      max_rel_error = std::max({max_rel_error, std::abs(state.rel_time - ref.rel_time) / 2.0e-7,
+                                std::abs(state.rel_time_rate - ref.rel_time_rate) / 3.0e-11,
+                                std::abs(state.rel_time_rate_rate - ref.rel_time_rate_rate) / 5.0e-15,
+                                std::abs(eph.RelTimeRate(gps_time) - ref.rel_time_rate) / 3.0e-11,
+                                std::abs(eph.RelTimeRateRate(gps_time) - ref.rel_time_rate_rate) / 5.0e-15});
+
+      Eigen::Vector3d pos, vel, accel;
+      eph.PVA(gps_time, pos, vel, accel);
+      max_direct_error = std::max({max_direct_error, (pos - state.pos).norm(), (vel - state.vel).norm(),
+                                   (accel - state.accel).norm()});
+
+      // fourth-order central difference of the reference position
+      constexpr double h = 0.5;
+      Gps::OrbitState m2, m1, p1, p2;
+      ReferenceOrbit(eph, gps_time - (2.0 * h), m2);
+      ReferenceOrbit(eph, gps_time - h, m1);
+      ReferenceOrbit(eph, gps_time + h, p1);
+      ReferenceOrbit(eph, gps_time + (2.0 * h), p2);
+      Eigen::Vector3d diff_vel = (m2.pos - (8.0 * m1.pos) + (8.0 * p1.pos) - p2.pos) / (12.0 * h);
+      max_difference_error = std::max(max_difference_error, (diff_vel - ref.vel).norm());
+    }
+  }
+  bool passed = (max_pos_error < 1.0e-6) && (max_vel_error < 1.0e-9) && (max_accel_error < 1.0e-12)
+             && (max_rel_error < 1.0e-12) && (max_direct_error < 1.0e-6) && (max_difference_error < 1.0e-5);
+  std::cout << (passed ? "passed" : "failed") << " (position " << max_pos_error << " m, velocity " << max_vel_error
+            << " m/s, acceleration " << max_accel_error << " m/s^2, relativistic terms " << max_rel_error
+            << " relative, Ephemeris::PVA " << max_direct_error << ", differenced velocity " << max_difference_error
+            << " m/s)\n";
+  return passed;
+}
+
+
+/*
+Samples interpolators every 50 ms over 40 minutes (eight windows, crossing the week for half of the
+ephemerides) with batched and single queries, and checks position and clock against
+PreparedEphemeris plus ClockData::Offset and velocity against PreparedEphemeris::PV. Every window
+must meet the tolerance; an unreachable tolerance must be flagged at MAX_DEGREE. Then times batched
+queries against Ephemeris::P plus Offset.
+*/
+bool OrbitInterpolatorTest()
+{
+  std::cout << "Orbit Interpolator Test: ";
+  constexpr double tolerance = 1.0e-4;
+  std::mt19937_64 gen(41);
+  const std::vector<Gps::Ephemeris> ephemerides = RandomEphemerides(8, gen);
+  bool passed = true;
+  double max_pos_error = 0.0, max_clock_error = 0.0, max_vel_error = 0.0, max_batch_difference = 0.0;
+  unsigned int max_degree = 0;
+  for (const Gps::Ephemeris& eph : ephemerides) {
+    Gps::ClockData clock_data;
+    clock_data.Randomize();
+    clock_data.t_oc = eph.t_oe;
+    Gps::PreparedEphemeris orbit(eph);
+    Gps::OrbitInterpolator interpolator(eph, clock_data, 300.0, tolerance);
+
+    std::vector<double> times(48000);
+    double start = eph.t_oe - 1200.0;
+    for (std::size_t i = 0; i < times.size(); i++) {
+      double gps_time = start + (0.05 * i);
+      times[i] = gps_time + ((gps_time < 0.0) ? 604800.0 : 0.0) - ((gps_time >= 604800.0) ? 604800.0 : 0.0);
+    }
+    Eigen::Matrix3Xd batch_pos;
+    std::vector<double> batch_clock(times.size());
+    interpolator.Positions(times.data(), times.size(), batch_pos, batch_clock.data());
+
+    for (std::size_t i = 0; i < times.size(); i++) {
+      Gps::OrbitState state;
+      orbit.Evaluate(times[i], state);
+      double true_clock = clock_data.Offset(times[i]) + state.rel_time;
+      Eigen::Vector3d pos, vel;
+      double clock;
+      interpolator.Position(times[i], pos, clock);
+      passed &= interpolator.WithinTolerance() && (interpolator.PositionFitError() <= tolerance);
+      max_degree = std::max(max_degree, interpolator.Degree());
+      max_pos_error = std::max(max_pos_error, (pos - state.pos).norm());
+      max_clock_error = std::max(max_clock_error, std::abs(clock - true_clock));
+      max_batch_difference = std::max({max_batch_difference, (batch_pos.col(i) - pos).norm(),
+                                       std::abs(batch_clock[i] - clock) * 3.0e8});
+      if (i % 10 == 0) {
+        interpolator.PositionVelocity(times[i], pos, vel);
+        max_vel_error = std::max(max_vel_error, (vel - state.vel).norm());
+      }
+    }
+  }
+  passed &= (max_pos_error < tolerance) && (max_clock_error < 1.0e-12) && (max_vel_error < 1.0e-4)
+         && (max_batch_difference < 1.0e-8);
+
+  Gps::ClockData clock_data;
+  clock_data.Randomize();
+  Gps::OrbitInterpolator strict(ephemerides[0], clock_data, 300.0, 1.0e-12);
+  passed &= !strict.WithinTolerance() && (strict.Degree() == Gps::OrbitInterpolator::MAX_DEGREE);
+
+  // batches of 1024 samples (per block use), against the ephemeris at every tenth time
+  const Gps::Ephemeris& eph = ephemerides[0];
+  Gps::OrbitInterpolator interpolator(eph, clock_data);
+  std::vector<double> times(1000000);
+  for (std::size_t i = 0; i < times.size(); i++) {
+    times[i] = eph.t_oe + (1.0e-3 * i);
+  }
+  Eigen::Matrix3Xd pos;
+  std::vector<double> clock(1024);
+  double sum = 0.0;
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t b = 0; b < times.size(); b += 1024) {
+    interpolator.Positions(&times[b], std::min<std::size_t>(1024, times.size() - b), pos, clock.data());
+    sum += pos(0,0) + clock[0];
+  }
+  double batched = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / times.size();
+  start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < times.size(); i += 10) {
+    Eigen::Vector3d p;
+    eph.P(times[i], p);
+    sum += p(0) + clock_data.Offset(times[i]);
+  }
+  double direct = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / (times.size() / 10);
+
+  std::cout << (passed ? "passed" : "failed") << " (position " << max_pos_error << " m, clock " << max_clock_error
+            << " s, velocity " << max_vel_error << " m/s, batched vs single " << max_batch_difference
+            << ", degree up to " << max_degree << ", " << 1.0e9 * batched << " ns per batched query, "
+            << direct / batched << "x faster than the ephemeris" << (std::isnan(sum) ? "" : "") << ")\n";
+  return passed;
+}
+
+
+/*
+Evaluates PreparedEphemeris::Trajectory, all four overloads, at unsorted random times (crossing the
+week for every fourth ephemeris, with a count that is not a multiple of the vector width) and
+compares every column and row to pointwise Evaluate.
+*/
+bool TrajectoryTest()
+{
+  std::cout << "Trajectory Test: ";
+  std::mt19937_64 gen(42);
+  const std::vector<Gps::Ephemeris> ephemerides = RandomEphemerides(16, gen);
+  double max_pos_error = 0.0, max_vel_error = 0.0;
+  bool passed = true;
+  for (const Gps::Ephemeris& eph : ephemerides) {
+    Gps::PreparedEphemeris orbit(eph);
+    std::vector<double> times(1001);
+    for (double& t : times) {
+      t = NearEpoch(eph, gen);
+    }
+    Eigen::Matrix3Xd pos_only, pos, vel;
+    Gps::SoaVector3 soa_pos_only, soa_pos, soa_vel;
+    orbit.Trajectory(times.data(), times.size(), pos_only);
+    orbit.Trajectory(times.data(), times.size(), pos, vel);
+    orbit.Trajectory(times.data(), times.size(), soa_pos_only);
+    orbit.Trajectory(times.data(), times.size(), soa_pos, soa_vel);
+    passed &= (pos_only.cols() == 1001) && (vel.cols() == 1001) && (soa_pos_only.rows() == 1001) && (soa_vel.rows() == 1001);
+    if (!passed) break;
+
+    for (std::size_t i = 0; i < times.size(); i++) {
+      Gps::OrbitState state;
+      orbit.Evaluate(times[i], state);
+      max_pos_error = std::max({max_pos_error, (pos_only.col(i) - state.pos).norm(), (pos.col(i) - state.pos).norm(),
+                                (soa_pos_only.row(i).transpose() - state.pos).norm(),
+                                (soa_pos.row(i).transpose() - state.pos).norm()});
+      max_vel_error = std::max({max_vel_error, (vel.col(i) - state.vel).norm(), (soa_vel.row(i).transpose() - state.vel).norm()});
+    }
+  }
+  passed &= (max_pos_error < 1.0e-6) && (max_vel_error < 1.0e-9);
+  std::cout << (passed ? "passed" : "failed") << " (position " << max_pos_error << " m, velocity " << max_vel_error
+            << " m/s)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = EphemerisSetTest();
+  passed &= KeplerTest();
+  passed &= EfromTimeTest();
+  passed &= PreparedEphemerisTest();
+  passed &= OrbitInterpolatorTest();
+  passed &= TrajectoryTest();
+  return passed ? 0 : 1;
+}
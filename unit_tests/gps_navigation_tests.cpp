@@ -0,0 +1,476 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "gps_common.hpp"
+#include "gps_coordinates.hpp"
+#include "gps_navigation.hpp"
+#include "gps_observables.hpp"
+#include "test_constellation.hpp"
+
+// Pseudorange by iterating the light time to convergence on the full ephemeris, with the exact Earth rotation
+double ReferencePseudorange(const Gps::Ephemeris& eph, const Gps::ClockData& clock_data,
+  const Eigen::Vector3d& rx_pos, const double gps_time)
+{
+  double light_time = 0.075;
+  double range = 0.0;
+  for (int i = 0; i < 10; i++) {
+    Eigen::Vector3d sat_pos;
+    eph.P(gps_time - light_time, sat_pos);
+    double theta = Gps::Ephemeris::WGS84_EARTH_RATE * light_time;
+    Eigen::Vector3d rotated((std::cos(theta) * sat_pos(0)) + (std::sin(theta) * sat_pos(1)),
+                            (std::cos(theta) * sat_pos(1)) - (std::sin(theta) * sat_pos(0)), sat_pos(2));
+    range = (rotated - rx_pos).norm();
+    light_time = range / Gps::LIGHT_SPEED;
+  }
+  double transmit_time = gps_time - light_time;
+  return range - (Gps::LIGHT_SPEED * (clock_data.Offset(transmit_time) - clock_data.T_GD + eph.RelTime(transmit_time)));
+}
+
+
+/*
+Compares ObservableModel to a converged light-time solution on the full ephemeris for static and
+accelerating receivers, with the rate and acceleration checked against central differences of that
+solution. Epochs are spread over one reference interval so the reference states are reused up to
+just inside the 0.5 * reference_interval refresh limit, and the reused results are also compared
+to a model refreshed at the same epoch.
+*/
+bool ObservableModelTest()
+{
+  std::cout << "Observable Model Test: ";
+  std::vector<Gps::Ephemeris> ephemerides;
+  std::vector<Gps::ClockData> clock_data;
+  MakeConstellation(ephemerides, clock_data);
+  for (std::size_t s = 0; s < ephemerides.size(); s++) {
+    // harmonic corrections and clock drift rate so every term of the full ephemeris is exercised
+    Gps::Ephemeris& eph = ephemerides[s];
+    eph.del_n = 4.0e-9;
+    eph.IDOT = 1.0e-10;
+    eph.C_rs = 50.0;
+    eph.C_rc = 200.0;
+    eph.C_us = 5.0e-6;
+    eph.C_uc = 1.0e-6;
+    eph.C_is = -1.0e-7;
+    eph.C_ic = 1.0e-7;
+    clock_data[s].a_f2 = 1.0e-18;
+  }
+  Gps::ObservableModel model(ephemerides, clock_data, 1.0, 1);
+
+  constexpr std::size_t num_receivers = 40;
+  std::mt19937_64 gen(3);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  Gps::SoaVector3 start_pos(num_receivers, 3);
+  Gps::SoaVector3 rx_vel = Gps::SoaVector3::Zero(num_receivers, 3);
+  Gps::SoaVector3 rx_acc = Gps::SoaVector3::Zero(num_receivers, 3);
+  for (std::size_t r = 0; r < num_receivers; r++) {
+    start_pos.row(r) = Gps::LlaToEcef(1.4 * unit(gen), std::numbers::pi * unit(gen), 5000.0 * (unit(gen) + 1.0));
+    if (r % 2 == 1) {
+      rx_vel.row(r) = 250.0 * Eigen::Vector3d(unit(gen), unit(gen), unit(gen));
+      rx_acc.row(r) = 5.0 * Eigen::Vector3d(unit(gen), unit(gen), unit(gen));
+    }
+  }
+
+  constexpr double start_time = 7300.0;
+  auto receiver = [&](const std::size_t r, const double gps_time)
+  {
+    double elapsed = gps_time - start_time;
+    return Eigen::Vector3d(start_pos.row(r).transpose() + (elapsed * rx_vel.row(r).transpose())
+                           + (0.5 * elapsed * elapsed * rx_acc.row(r).transpose()));
+  };
+
+  // the first epoch sets the reference, 0.499 s reuses it just inside the limit, 0.501 s refreshes
+  const std::vector<double> offsets = {0.0, 0.2, 0.499, 0.501, 0.99};
+  double max_range_error = 0.0, max_rate_error = 0.0, max_accel_error = 0.0, max_time_error = 0.0;
+  double max_reuse_difference = 0.0;
+  bool passed = true;
+  Gps::ObservableBatch obs, fresh_obs;
+  for (double offset : offsets) {
+    double gps_time = start_time + offset;
+    Gps::SoaVector3 rx_pos(num_receivers, 3), vel(num_receivers, 3);
+    for (std::size_t r = 0; r < num_receivers; r++) {
+      rx_pos.row(r) = receiver(r, gps_time).transpose();
+      vel.row(r) = rx_vel.row(r) + (offset * rx_acc.row(r));
+    }
+    model.Compute(gps_time, rx_pos, vel, rx_acc, obs);
+    passed &= (obs.pseudorange.rows() == num_receivers) && (obs.pseudorange.cols() == 24);
+    if (!passed) break;
+
+    for (std::size_t r = 0; r < num_receivers; r++) {
+      for (std::size_t s = 0; s < model.NumSatellites(); s++) {
+        auto pseudorange = [&](const double t)
+        {
+          return ReferencePseudorange(ephemerides[s], clock_data[s], receiver(r, t), t);
+        };
+        constexpr double h_rate = 0.01, h_accel = 0.05;
+        double expected = pseudorange(gps_time);
+        double expected_rate = (pseudorange(gps_time + h_rate) - pseudorange(gps_time - h_rate)) / (2.0 * h_rate);
+        double expected_accel = (pseudorange(gps_time + h_accel) - (2.0 * expected) + pseudorange(gps_time - h_accel))
+                              / (h_accel * h_accel);
+        max_range_error = std::max(max_range_error, std::abs(obs.pseudorange(r,s) - expected));
+        max_rate_error = std::max(max_rate_error, std::abs(obs.pseudorange_rate(r,s) - expected_rate));
+        max_accel_error = std::max(max_accel_error, std::abs(obs.pseudorange_accel(r,s) - expected_accel));
+        max_time_error = std::max(max_time_error,
+                                  std::abs(obs.transmit_time(r,s) - (gps_time - (expected / Gps::LIGHT_SPEED))));
+      }
+    }
+
+    if (offset == 0.499) {
+      Gps::ObservableModel fresh_model(ephemerides, clock_data, 1.0, 1);
+      fresh_model.Compute(gps_time, rx_pos, vel, rx_acc, fresh_obs);
+      max_reuse_difference = (obs.pseudorange - fresh_obs.pseudorange).cwiseAbs().maxCoeff();
+    }
+  }
+  // a zero difference would mean the reference was not reused
+  passed &= (max_range_error < 2.0e-7) && (max_rate_error < 8.0e-5) && (max_accel_error < 1.0e-4)
+         && (max_time_error < 1.0e-14) && (max_reuse_difference > 0.0) && (max_reuse_difference < 1.0e-6);
+  std::cout << (passed ? "passed" : "failed") << " (pseudorange " << max_range_error << " m, rate " << max_rate_error
+            << " m/s, acceleration " << max_accel_error << " m/s^2, transmit time " << max_time_error
+            << " s, reused vs refreshed " << max_reuse_difference << " m)\n";
+  return passed;
+}
+
+/*
+A grid large enough to be split across threads must give the same results, bit for bit, as one
+thread. A small epoch with all hardware threads requested stays on the calling thread; its cost
+per epoch is reported.
+*/
+bool ObservableThreadsTest()
+{
+  std::cout << "Observable Threads Test: ";
+  std::vector<Gps::Ephemeris> ephemerides;
+  std::vector<Gps::ClockData> clock_data;
+  MakeConstellation(ephemerides, clock_data);
+  Gps::ObservableModel serial_model(ephemerides, clock_data, 1.0, 1);
+  Gps::ObservableModel threaded_model(ephemerides, clock_data, 1.0, 4);
+  Gps::ObservableModel small_model(ephemerides, clock_data, 1.0, 0);
+
+  constexpr std::size_t num_receivers = 1000;
+  std::mt19937_64 gen(8);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  Gps::SoaVector3 rx_pos(num_receivers, 3);
+  for (std::size_t r = 0; r < num_receivers; r++) {
+    rx_pos.row(r) = Gps::LlaToEcef(1.4 * unit(gen), std::numbers::pi * unit(gen), 1000.0 * (unit(gen) + 1.0));
+  }
+  Gps::ObservableBatch serial_obs, threaded_obs;
+  serial_model.Compute(7300.0, rx_pos, serial_obs);
+  threaded_model.Compute(7300.0, rx_pos, threaded_obs);
+  bool passed = (num_receivers * ephemerides.size() >= 4 * Gps::ObservableModel::MIN_PAIRS_PER_THREAD)
+             && (serial_obs.pseudorange == threaded_obs.pseudorange)
+             && (serial_obs.pseudorange_rate == threaded_obs.pseudorange_rate)
+             && (serial_obs.pseudorange_accel == threaded_obs.pseudorange_accel)
+             && (serial_obs.transmit_time == threaded_obs.transmit_time);
+
+  // 24 satellites x 4 receivers at 1 kHz
+  constexpr int num_epochs = 1000;
+  Gps::SoaVector3 small_pos = rx_pos.topRows(4);
+  Gps::ObservableBatch small_obs;
+  small_model.Compute(7300.0, small_pos, small_obs);
+  serial_model.Compute(7300.0, small_pos, serial_obs);
+  passed &= (small_obs.pseudorange == serial_obs.pseudorange);
+  auto start = std::chrono::steady_clock::now();
+  for (int k = 0; k < num_epochs; k++) {
+    small_model.Compute(7300.0 + (1.0e-3 * k), small_pos, small_obs);
+  }
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << (passed ? "passed" : "failed") << " (" << 1.0e6 * elapsed / num_epochs
+            << " us per 24 x 4 epoch)\n";
+  return passed;
+}
+
+
+/*
+Generates pseudoranges for receivers around the globe (with receiver clock bias and noise), builds
+measurements from the broadcast data and solves them, checking the position and clock errors and
+that the DOPs are consistent. Also runs a batch of epochs through the threaded solver.
+*/
+bool PvtEndToEndTest()
+{
+  std::cout << "PVT End To End Test: ";
+  std::vector<Gps::Ephemeris> ephemerides;
+  std::vector<Gps::ClockData> clock_data;
+  MakeConstellation(ephemerides, clock_data);
+  Gps::ObservableModel model(ephemerides, clock_data, 1.0, 1);
+
+  constexpr std::size_t num_receivers = 50;
+  constexpr double noise_sigma = 3.0;
+  std::mt19937_64 gen(5);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  std::normal_distribution<double> noise(0.0, noise_sigma);
+  Gps::SoaVector3 rx_pos(num_receivers, 3);
+  std::vector<double> rx_bias(num_receivers);
+  for (std::size_t r = 0; r < num_receivers; r++) {
+    rx_pos.row(r) = Gps::LlaToEcef(1.4 * unit(gen), std::numbers::pi * unit(gen), 1000.0 * (unit(gen) + 1.0));
+    rx_bias[r] = 3.0e4 * unit(gen); // meters
+  }
+
+  constexpr std::size_t num_times = 200;
+  std::vector<Gps::PvtEpoch> epochs(num_times * num_receivers);
+  Gps::ObservableBatch obs;
+  for (std::size_t k = 0; k < num_times; k++) {
+    double gps_time = 3600.0 + (k * 36.0);
+    model.Compute(gps_time, rx_pos, obs);
+    for (std::size_t r = 0; r < num_receivers; r++) {
+      Gps::PvtEpoch& epoch = epochs[(k * num_receivers) + r];
+      Eigen::Vector3d pos = rx_pos.row(r).transpose();
+      double receive_time = gps_time + (rx_bias[r] / Gps::LIGHT_SPEED);
+      for (std::size_t s = 0; s < model.NumSatellites(); s++) {
+        Eigen::Vector3d sat_pos;
+        model.Orbit(s).P(gps_time, sat_pos);
+        if (Gps::Elevation(pos, sat_pos) < 10.0 * std::numbers::pi / 180.0) continue;
+        double pseudorange = obs.pseudorange(r,s) + rx_bias[r] + noise(gen);
+        Gps::PvtMeasurement& measurement = epoch.measurements[epoch.count++];
+        Gps::MakePvtMeasurement(model.Orbit(s), model.ClockParams(s), receive_time, pseudorange, measurement);
+        measurement.weight = 1.0 / (noise_sigma * noise_sigma);
+      }
+    }
+  }
+
+  // noiseless single solve for the model error
+  double max_model_error = 0.0;
+  {
+    model.Compute(3600.0, rx_pos, obs);
+    Gps::PvtEpoch epoch;
+    Eigen::Vector3d pos = rx_pos.row(0).transpose();
+    for (std::size_t s = 0; s < model.NumSatellites(); s++) {
+      Eigen::Vector3d sat_pos;
+      model.Orbit(s).P(3600.0, sat_pos);
+      if (Gps::Elevation(pos, sat_pos) < 0.0) continue;
+      Gps::MakePvtMeasurement(model.Orbit(s), model.ClockParams(s), 3600.0, obs.pseudorange(0,s),
+        epoch.measurements[epoch.count++]);
+    }
+    Gps::PvtSolution solution;
+    bool valid = Gps::SolvePvt(epoch, solution);
+    max_model_error = valid ? std::max((solution.pos - pos).norm(), std::abs(solution.clock_bias)) : 1.0e9;
+  }
+
+  std::vector<Gps::PvtSolution> solutions(epochs.size());
+  auto start = std::chrono::steady_clock::now();
+  Gps::SolvePvt(epochs.data(), epochs.size(), solutions.data());
+  double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::size_t num_valid = 0;
+  std::size_t num_outliers = 0;
+  bool dops_consistent = true;
+  double sum_square_error = 0.0;
+  double sum_square_predicted = 0.0;
+  for (std::size_t i = 0; i < epochs.size(); i++) {
+    const Gps::PvtSolution& solution = solutions[i];
+    if (!solution.valid) continue;
+    num_valid++;
+    std::size_t r = i % num_receivers;
+    double error = (solution.pos - rx_pos.row(r).transpose()).norm();
+    sum_square_error += error * error;
+    sum_square_predicted += noise_sigma * noise_sigma * solution.pdop * solution.pdop;
+    num_outliers += (error > 6.0 * noise_sigma * solution.pdop) || (std::abs(solution.clock_bias - rx_bias[r]) > 6.0 * noise_sigma * solution.tdop);
+    double pdop_square = solution.pdop * solution.pdop;
+    double gdop_square = solution.gdop * solution.gdop;
+    dops_consistent &= (std::abs((solution.hdop * solution.hdop) + (solution.vdop * solution.vdop) - pdop_square) < 1.0e-9 * pdop_square)
+                    && (std::abs(pdop_square + (solution.tdop * solution.tdop) - gdop_square) < 1.0e-9 * gdop_square);
+  }
+  // position errors match the PDOP prediction in mean square
+  double error_ratio = std::sqrt(sum_square_error / sum_square_predicted);
+
+  bool passed = (max_model_error < 1.0e-3) && (num_valid == epochs.size()) && (num_outliers == 0) && dops_consistent
+             && (error_ratio > 0.9) && (error_ratio < 1.1);
+  std::cout << (passed ? "passed" : "failed") << " (model error " << max_model_error << " m, " << num_valid << "/"
+            << epochs.size() << " valid, error/predicted " << error_ratio << ", "
+            << 1.0e6 * elapsed / epochs.size() << " us per epoch)\n";
+  return passed;
+}
+
+
+/*
+Too few satellites and degenerate geometry must be reported invalid rather than solved.
+*/
+bool PvtInvalidTest()
+{
+  std::cout << "PVT Invalid Test: ";
+  Gps::PvtEpoch epoch;
+  for (std::size_t i = 0; i < 3; i++) {
+    epoch.measurements[i].sat_pos = Eigen::Vector3d(2.0e7, 1.0e6 * i, 1.0e7);
+    epoch.measurements[i].pseudorange = 2.0e7;
+  }
+  epoch.count = 3;
+  Gps::PvtSolution solution;
+  bool too_few = !Gps::SolvePvt(epoch, solution) && !solution.valid;
+
+  // four satellites at the same point
+  epoch.measurements[1].sat_pos = epoch.measurements[0].sat_pos;
+  epoch.measurements[2].sat_pos = epoch.measurements[0].sat_pos;
+  epoch.measurements[3] = epoch.measurements[0];
+  epoch.count = 4;
+  bool degenerate = !Gps::SolvePvt(epoch, solution) && !solution.valid;
+
+  bool passed = too_few && degenerate;
+  std::cout << (passed ? "passed" : "failed") << "\n";
+  return passed;
+}
+
+
+/*
+A block of sequential scalar updates must match the joint Kalman update with a diagonal R.
+*/
+bool KalmanSequentialTest()
+{
+  std::cout << "Kalman Sequential Test: ";
+  using Filter = Gps::KalmanFilter<6>;
+  std::mt19937_64 gen(7);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  double max_state_error = 0.0;
+  double max_covariance_error = 0.0;
+  for (int trial = 0; trial < 100; trial++) {
+    Filter::StateMatrix root;
+    Filter::StateVector state;
+    Filter::MeasurementMatrix<4> jacobian;
+    Filter::MeasurementVector<4> innovations, variances;
+    for (int i = 0; i < 6; i++) {
+      state(i) = normal(gen);
+      for (int j = 0; j < 6; j++) root(i,j) = normal(gen);
+    }
+    for (int i = 0; i < 4; i++) {
+      innovations(i) = normal(gen);
+      variances(i) = 0.1 + std::abs(normal(gen));
+      for (int j = 0; j < 6; j++) jacobian(i,j) = normal(gen);
+    }
+    Filter::StateMatrix covariance = (root * root.transpose()) + Filter::StateMatrix::Identity();
+
+    Filter filter;
+    filter.Initialize(state, covariance);
+    filter.Update<4>(innovations, jacobian, variances);
+
+    Eigen::Matrix4d innovation_covariance = (jacobian * covariance * jacobian.transpose());
+    innovation_covariance += variances.asDiagonal().toDenseMatrix();
+    Eigen::Matrix<double,6,4> gain = covariance * jacobian.transpose() * innovation_covariance.inverse();
+    Filter::StateVector joint_state = state + (gain * innovations);
+    Filter::StateMatrix joint_covariance = covariance - (gain * jacobian * covariance);
+
+    max_state_error = std::max(max_state_error, (filter.State() - joint_state).cwiseAbs().maxCoeff());
+    max_covariance_error = std::max(max_covariance_error, (filter.Covariance() - joint_covariance).cwiseAbs().maxCoeff());
+  }
+
+  bool passed = (max_state_error < 1.0e-10) && (max_covariance_error < 1.0e-10);
+  std::cout << (passed ? "passed" : "failed") << " (state " << max_state_error << ", covariance "
+            << max_covariance_error << ")\n";
+  return passed;
+}
+
+
+/*
+Runs filters at 100 Hz for receivers moving at constant velocity with drifting clocks, from
+snapshot fixes, on noisy pseudoranges and pseudorange rates. Final position, velocity and clock
+errors must be small and consistent with the filter covariance.
+*/
+bool NavigationFilterTest()
+{
+  std::cout << "Navigation Filter Test: ";
+  std::vector<Gps::Ephemeris> ephemerides;
+  std::vector<Gps::ClockData> clock_data;
+  MakeConstellation(ephemerides, clock_data);
+  Gps::ObservableModel model(ephemerides, clock_data, 1.0, 1);
+
+  constexpr std::size_t num_receivers = 20;
+  constexpr std::size_t num_epochs = 3000;
+  constexpr double rate = 100.0;
+  constexpr double range_sigma = 3.0;
+  constexpr double rate_sigma = 0.05;
+  std::mt19937_64 gen(9);
+  std::uniform_real_distribution<double> unit(-1.0, 1.0);
+  std::normal_distribution<double> normal(0.0, 1.0);
+  Gps::SoaVector3 start_pos(num_receivers, 3), rx_pos(num_receivers, 3);
+  Gps::SoaVector3 rx_vel(num_receivers, 3), rx_acc = Gps::SoaVector3::Zero(num_receivers, 3);
+  std::vector<double> bias(num_receivers), drift(num_receivers);
+  for (std::size_t r = 0; r < num_receivers; r++) {
+    start_pos.row(r) = Gps::LlaToEcef(1.4 * unit(gen), std::numbers::pi * unit(gen), 100.0);
+    rx_vel.row(r) = 30.0 * Eigen::Vector3d(unit(gen), unit(gen), unit(gen));
+    bias[r] = 1.0e4 * unit(gen);
+    drift[r] = 100.0 * unit(gen);
+  }
+
+  Gps::NavigationFilterConfig config;
+  config.accel_psd = 0.01;
+  config.clock_bias_psd = 0.01;
+  config.clock_drift_psd = 0.01;
+  config.gate = 6.0;
+  std::vector<Gps::NavigationFilter> filters(num_receivers, Gps::NavigationFilter(config));
+  std::vector<Gps::PvtEpoch> epochs(num_receivers);
+  Gps::ObservableBatch obs;
+  double update_seconds = 0.0;
+  std::size_t num_updates = 0;
+  for (std::size_t k = 0; k < num_epochs; k++) {
+    double gps_time = 3600.0 + (k / rate);
+    double elapsed = k / rate;
+    rx_pos = start_pos + (elapsed * rx_vel);
+    model.Compute(gps_time, rx_pos, rx_vel, rx_acc, obs);
+    for (std::size_t r = 0; r < num_receivers; r++) {
+      double clock_bias = bias[r] + (drift[r] * elapsed);
+      double receive_time = gps_time + (clock_bias / Gps::LIGHT_SPEED);
+      Gps::PvtEpoch& epoch = epochs[r];
+      epoch.count = 0;
+      Eigen::Vector3d pos = rx_pos.row(r).transpose();
+      for (std::size_t s = 0; s < model.NumSatellites(); s++) {
+        Eigen::Vector3d sat_pos;
+        model.Orbit(s).P(gps_time, sat_pos);
+        if (Gps::Elevation(pos, sat_pos) < 10.0 * std::numbers::pi / 180.0) continue;
+        Gps::PvtMeasurement& measurement = epoch.measurements[epoch.count++];
+        Gps::MakePvtMeasurement(model.Orbit(s), model.ClockParams(s), receive_time,
+          obs.pseudorange(r,s) + clock_bias + (range_sigma * normal(gen)),
+          obs.pseudorange_rate(r,s) + drift[r] + (rate_sigma * normal(gen)), measurement);
+        measurement.weight = 1.0 / (range_sigma * range_sigma);
+        measurement.rate_weight = 1.0 / (rate_sigma * rate_sigma);
+      }
+      if (k == 0) {
+        Gps::PvtSolution solution;
+        Gps::SolvePvt(epoch, solution);
+        filters[r].Initialize(gps_time, solution);
+      }
+    }
+    if (k == 0) continue;
+    auto start = std::chrono::steady_clock::now();
+    Gps::UpdateNavigationFilters(filters.data(), num_receivers, &gps_time, epochs.data(), 1, 1);
+    update_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    num_updates += num_receivers;
+  }
+
+  double max_position_error = 0.0, max_velocity_error = 0.0, max_bias_error = 0.0, max_drift_error = 0.0;
+  double max_normalized_error = 0.0;
+  double elapsed = (num_epochs - 1) / rate;
+  for (std::size_t r = 0; r < num_receivers; r++) {
+    const Gps::NavigationFilter& filter = filters[r];
+    Eigen::Vector3d position_error = filter.Position() - rx_pos.row(r).transpose();
+    Eigen::Vector3d velocity_error = filter.Velocity() - rx_vel.row(r).transpose();
+    double bias_error = filter.ClockBias() - (bias[r] + (drift[r] * elapsed));
+    double drift_error = filter.ClockDrift() - drift[r];
+    max_position_error = std::max(max_position_error, position_error.norm());
+    max_velocity_error = std::max(max_velocity_error, velocity_error.norm());
+    max_bias_error = std::max(max_bias_error, std::abs(bias_error));
+    max_drift_error = std::max(max_drift_error, std::abs(drift_error));
+    for (int i = 0; i < 3; i++) {
+      max_normalized_error = std::max({max_normalized_error, std::abs(position_error(i)) / filter.Kalman().Sigma(i),
+                                       std::abs(velocity_error(i)) / filter.Kalman().Sigma(i + 3)});
+    }
+  }
+
+  bool passed = (max_position_error < 2.0) && (max_velocity_error < 0.05) && (max_bias_error < 2.0)
+             && (max_drift_error < 0.05) && (max_normalized_error < 5.0);
+  std::cout << (passed ? "passed" : "failed") << " (position " << max_position_error << " m, velocity "
+            << max_velocity_error << " m/s, bias " << max_bias_error << " m, drift " << max_drift_error
+            << " m/s, " << max_normalized_error << " sigma, " << 1.0e6 * update_seconds / num_updates
+            << " us per update)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = ObservableModelTest();
+  passed &= ObservableThreadsTest();
+  passed &= PvtEndToEndTest();
+  passed &= PvtInvalidTest();
+  passed &= KalmanSequentialTest();
+  passed &= NavigationFilterTest();
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,330 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "gps_rinex.hpp"
+
+// Reference conversion of a field, with Fortran D exponents rewritten for strtod
+double Strtod(std::string field)
+{
+  std::replace_if(field.begin(), field.end(), [](const char c) { return c == 'D' || c == 'd'; }, 'E');
+  return std::strtod(field.c_str(), nullptr);
+}
+
+
+// Value after a round trip through a 19 character D19.12 field
+double Written(const double value)
+{
+  char buffer[32];
+  std::snprintf(buffer, sizeof(buffer), "%19.12E", value);
+  return Strtod(buffer);
+}
+
+
+struct CivilDate
+{
+  int year, month, day;
+};
+
+// Calendar date of a day count from 1970-01-01
+CivilDate CivilFromDays(int64_t days)
+{
+  days += 719468;
+  const int64_t era = ((days >= 0) ? days : days - 146096) / 146097;
+  const int64_t day_of_era = days - (era * 146097);
+  const int64_t year_of_era = (day_of_era - (day_of_era / 1460) + (day_of_era / 36524) - (day_of_era / 146096)) / 365;
+  const int64_t day_of_year = day_of_era - ((365 * year_of_era) + (year_of_era / 4) - (year_of_era / 100));
+  const int64_t mp = ((5 * day_of_year) + 2) / 153;
+  const int day = static_cast<int>(day_of_year - (((153 * mp) + 2) / 5) + 1);
+  const int month = static_cast<int>((mp < 10) ? mp + 3 : mp - 9);
+  return {static_cast<int>(year_of_era + (era * 400) + ((month <= 2) ? 1 : 0)), month, day};
+}
+
+
+// Writes records as RINEX text with randomly blanked zero fields and trimmed lines
+class RinexWriter
+{
+public:
+  RinexWriter(const bool version3, std::mt19937_64& gen) : version3_{version3}, gen_{gen} {}
+
+  void Header()
+  {
+    char line[96];
+    std::snprintf(line, sizeof(line), "%9.2f%11s%-20s%-20s", version3_ ? 3.04 : 2.11, "",
+                  version3_ ? "N: GNSS NAV DATA" : "N: GPS NAV DATA", version3_ ? "M: MIXED" : "");
+    HeaderLine(line, "RINEX VERSION / TYPE");
+    HeaderLine("synthetic           unit tests          20240101 000000 UTC", "PGM / RUN BY / DATE");
+    HeaderLine("", "END OF HEADER");
+  }
+
+  void Record(const Gps::NavigationRecord& record, const double fit_hours)
+  {
+    const Gps::Ephemeris& eph = record.ephemeris;
+    const Gps::ClockData& clock = record.clock_data;
+    const int64_t days = (7 * static_cast<int64_t>(record.week)) + static_cast<int64_t>(clock.t_oc / 86400.0);
+    const CivilDate date = CivilFromDays(days + 3657); // 1980-01-06 is day 3657
+    const int seconds_of_day = static_cast<int>(std::fmod(clock.t_oc, 86400.0));
+    const int hour = seconds_of_day / 3600, minute = (seconds_of_day / 60) % 60, second = seconds_of_day % 60;
+    char epoch[32];
+    if (version3_) {
+      std::snprintf(epoch, sizeof(epoch), "G%02d %04d %02d %02d %02d %02d %02d", record.prn, date.year, date.month,
+                    date.day, hour, minute, second);
+    } else {
+      std::snprintf(epoch, sizeof(epoch), "%2d %02d %2d %2d %2d %2d%5.1f", record.prn, date.year % 100, date.month,
+                    date.day, hour, minute, static_cast<double>(second));
+    }
+    Line(epoch, {clock.a_f0, clock.a_f1, clock.a_f2});
+    const std::string indent(version3_ ? 4 : 3, ' ');
+    Line(indent, {static_cast<double>(eph.IODE), eph.C_rs, eph.del_n, eph.M_0});
+    Line(indent, {eph.C_uc, eph.e, eph.C_us, eph.sqrtA});
+    Line(indent, {eph.t_oe, eph.C_ic, eph.Omega_0, eph.C_is});
+    Line(indent, {eph.i_0, eph.C_rc, eph.omega, eph.Omega_dot});
+    Line(indent, {eph.IDOT, 1.0, static_cast<double>(record.week), 0.0});
+    Line(indent, {record.accuracy, static_cast<double>(record.health), clock.T_GD, static_cast<double>(clock.IODC)});
+    // the spares of the last line are often left out
+    Line(indent, {record.transmit_time, fit_hours});
+  }
+
+  // A record of another system with the given number of orbit lines, to be skipped
+  void OtherRecord(const char system, const int prn, const int orbit_lines)
+  {
+    char epoch[32];
+    std::snprintf(epoch, sizeof(epoch), "%c%02d 2020 03 04 05 06 00", system, prn);
+    Line(epoch, {1.0e-4, -2.0e-12, 0.0});
+    for (int l = 0; l < orbit_lines; l++) {
+      Line("    ", {1.5e4, -3.25, 1.0e-9, 2.0});
+    }
+  }
+
+  const std::string& Text() const { return text_; }
+
+private:
+  void HeaderLine(const std::string& content, const std::string& label)
+  {
+    std::string line = content;
+    line.resize(60, ' ');
+    text_ += line + label + "\n";
+  }
+
+  void Line(const std::string& start, const std::vector<double>& values)
+  {
+    std::bernoulli_distribution coin(0.3);
+    std::string line = start;
+    for (double value : values) {
+      char field[32];
+      if (value == 0.0 && coin(gen_)) {
+        std::snprintf(field, sizeof(field), "%19s", "");
+      } else {
+        std::snprintf(field, sizeof(field), "%19.12E", value);
+      }
+      if (!version3_) {
+        std::replace(field, field + 19, 'E', 'D');
+      }
+      line += field;
+    }
+    if (coin(gen_)) {
+      line.erase(line.find_last_not_of(' ') + 1);
+    }
+    text_ += line + (version3_ ? "\r\n" : "\n");
+  }
+
+  bool version3_;
+  std::mt19937_64& gen_;
+  std::string text_;
+};
+
+
+// Random record as the writer will round it, fit interval as parsed from the written hours
+Gps::NavigationRecord RandomRecord(std::mt19937_64& gen, double& fit_hours)
+{
+  std::uniform_int_distribution<int> prn(1, 32), week(1900, 2400), hours(0, 167), code(0, 1023);
+  std::bernoulli_distribution coin(0.2);
+  Gps::NavigationRecord record;
+  record.prn = static_cast<uint8_t>(prn(gen));
+  record.week = static_cast<uint16_t>(week(gen));
+  Gps::Ephemeris& eph = record.ephemeris;
+  Gps::ClockData& clock = record.clock_data;
+  eph.Randomize();
+  clock.Randomize();
+  eph.t_oe = 3600.0 * hours(gen);
+  clock.t_oc = eph.t_oe;
+  eph.IODE = static_cast<uint8_t>(code(gen) % 256);
+  clock.IODC = static_cast<uint16_t>(code(gen));
+  // some zero terms, which the writer may leave blank
+  if (coin(gen)) eph.C_is = 0.0;
+  if (coin(gen)) eph.IDOT = 0.0;
+  if (coin(gen)) clock.a_f2 = 0.0;
+  for (double* value : {&eph.M_0, &eph.del_n, &eph.e, &eph.sqrtA, &eph.Omega_0, &eph.i_0, &eph.omega, &eph.Omega_dot,
+                        &eph.IDOT, &eph.C_uc, &eph.C_us, &eph.C_rc, &eph.C_rs, &eph.C_ic, &eph.C_is, &clock.T_GD,
+                        &clock.a_f0, &clock.a_f1, &clock.a_f2}) {
+    *value = Written(*value);
+  }
+  record.transmit_time = std::max(eph.t_oe - 7200.0, 0.0);
+  record.accuracy = coin(gen) ? 0.0 : 2.4;
+  record.health = coin(gen) ? 63 : 0;
+  fit_hours = coin(gen) ? 0.0 : 6.0;
+  record.fit_interval = (fit_hours > 0.0) ? fit_hours * 3600.0 : 14400.0;
+  return record;
+}
+
+
+bool SameRecord(const Gps::NavigationRecord& a, const Gps::NavigationRecord& b)
+{
+  const Gps::Ephemeris& ea = a.ephemeris;
+  const Gps::Ephemeris& eb = b.ephemeris;
+  const Gps::ClockData& ca = a.clock_data;
+  const Gps::ClockData& cb = b.clock_data;
+  return (a.prn == b.prn) && (a.week == b.week) && (a.fit_interval == b.fit_interval)
+      && (a.transmit_time == b.transmit_time) && (a.accuracy == b.accuracy) && (a.health == b.health)
+      && (ea.M_0 == eb.M_0) && (ea.del_n == eb.del_n) && (ea.e == eb.e) && (ea.sqrtA == eb.sqrtA)
+      && (ea.Omega_0 == eb.Omega_0) && (ea.i_0 == eb.i_0) && (ea.omega == eb.omega) && (ea.Omega_dot == eb.Omega_dot)
+      && (ea.IDOT == eb.IDOT) && (ea.C_uc == eb.C_uc) && (ea.C_us == eb.C_us) && (ea.C_rc == eb.C_rc)
+      && (ea.C_rs == eb.C_rs) && (ea.C_ic == eb.C_ic) && (ea.C_is == eb.C_is) && (ea.t_oe == eb.t_oe)
+      && (ea.IODE == eb.IODE) && (ca.T_GD == cb.T_GD) && (ca.t_oc == cb.t_oc) && (ca.a_f0 == cb.a_f0)
+      && (ca.a_f1 == cb.a_f1) && (ca.a_f2 == cb.a_f2) && (ca.IODC == cb.IODC);
+}
+
+
+/*
+Parses fixed-width fields in the forms RINEX writers produce (D and E exponents, missing leading
+digits, explicit signs, padding, long mantissas and far exponents that leave the exact fast path)
+and requires the bit-exact result of strtod. Blank fields read as zero and malformed ones fail.
+*/
+bool RinexNumberTest()
+{
+  std::cout << "Rinex Number Test: ";
+  std::mt19937_64 gen(11);
+  std::uniform_real_distribution<double> mantissa(-10.0, 10.0);
+  std::uniform_int_distribution<int> exponent(-40, 40), precision(0, 17), form(0, 4);
+  bool passed = true;
+  std::size_t checked = 0;
+  for (int i = 0; i < 200000; i++) {
+    double value = mantissa(gen) * std::pow(10.0, exponent(gen));
+    char field[64];
+    switch (form(gen)) {
+      case 0: std::snprintf(field, sizeof(field), "%19.12E", value); std::replace(field, field + 19, 'E', 'D'); break;
+      case 1: std::snprintf(field, sizeof(field), "%+.*e", precision(gen), value); break;
+      case 2: std::snprintf(field, sizeof(field), "%*.*f", 24, precision(gen), std::abs(value) < 1e15 ? value : 1.0); break;
+      case 3: std::snprintf(field, sizeof(field), "  %.0f  ", std::round(std::abs(value) < 1e25 ? value : 12.0)); break;
+      default: std::snprintf(field, sizeof(field), "%.25g", value); break;
+    }
+    // ".5D-03" and "-.5D-03" forms without the leading zero
+    std::string text = field;
+    std::size_t zero = text.find("0.");
+    if ((i % 7 == 0) && zero != std::string::npos && (zero == 0 || text[zero - 1] == '-' || text[zero - 1] == ' ')) {
+      text.erase(zero, 1);
+    }
+    if (i % 5 == 0) {
+      std::replace(text.begin(), text.end(), 'e', 'd');
+    }
+    double parsed;
+    bool ok = Gps::ParseRinexNumber(text.data(), text.data() + text.size(), parsed);
+    double expected = Strtod(text);
+    if (!ok || std::memcmp(&parsed, &expected, sizeof(double)) != 0) {
+      passed = false;
+      std::cout << "(\"" << text << "\" " << parsed << " vs " << expected << ") ";
+      break;
+    }
+    checked++;
+  }
+
+  for (const std::string blank : {"", "   ", "                   "}) {
+    double parsed = 1.0;
+    passed &= Gps::ParseRinexNumber(blank.data(), blank.data() + blank.size(), parsed) && (parsed == 0.0);
+  }
+  for (const std::string bad : {"1.2.3", "abc", "1.5D", "1.5D+", "--1", "1 2", "+", ".", "1.0X", "D5"}) {
+    double parsed;
+    passed &= !Gps::ParseRinexNumber(bad.data(), bad.data() + bad.size(), parsed);
+  }
+  std::cout << (passed ? "passed" : "failed") << " (" << checked << " fields)\n";
+  return passed;
+}
+
+
+/*
+Writes random GPS records to synthetic 2.11 (D exponents) and mixed 3.04 (E exponents, CRLF, with
+GLONASS, Galileo, BeiDou and SBAS records to skip) files, with zero fields randomly blank and lines
+randomly trimmed, and reads them back in one and several threads. The files are large enough to be
+split into many chunks, and every record must come back exactly and in file order. Also reads one
+file from disk and checks the rejections of bad input.
+*/
+bool RinexRoundTripTest()
+{
+  std::cout << "Rinex Round Trip Test: ";
+  constexpr std::size_t num_records = 1500;
+  std::mt19937_64 gen(13);
+  std::uniform_int_distribution<int> other(0, 3);
+  bool passed = true;
+  double parse_seconds = 0.0;
+  std::size_t parse_bytes = 0;
+  std::string version2_text;
+  for (bool version3 : {false, true}) {
+    RinexWriter writer(version3, gen);
+    writer.Header();
+    std::vector<Gps::NavigationRecord> expected;
+    for (std::size_t k = 0; k < num_records; k++) {
+      double fit_hours;
+      expected.push_back(RandomRecord(gen, fit_hours));
+      writer.Record(expected.back(), fit_hours);
+      if (version3) {
+        switch (other(gen)) {
+          case 0: writer.OtherRecord('R', 5, 3); break;
+          case 1: writer.OtherRecord('E', 11, 7); break;
+          case 2: writer.OtherRecord('C', 30, 7); break;
+          default: writer.OtherRecord('S', 20, 3); break;
+        }
+      }
+    }
+    const std::string& text = writer.Text();
+    if (!version3) version2_text = text;
+
+    for (unsigned int num_threads : {1u, 4u}) {
+      std::vector<Gps::NavigationRecord> records;
+      auto start = std::chrono::steady_clock::now();
+      passed &= Gps::ParseRinexNavigation(text.data(), text.size(), records, num_threads);
+      parse_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      parse_bytes += text.size();
+      passed &= (records.size() == num_records);
+      for (std::size_t k = 0; passed && k < num_records; k++) {
+        if (!SameRecord(records[k], expected[k])) {
+          std::cout << "(version " << (version3 ? 3 : 2) << ", " << num_threads << " threads, record " << k << ") ";
+          passed = false;
+        }
+      }
+    }
+  }
+
+  // from disk, appending to existing records
+  const std::filesystem::path path = std::filesystem::temp_directory_path() / "gps_rinex_tests.nav";
+  std::ofstream(path, std::ios::binary) << version2_text;
+  std::vector<Gps::NavigationRecord> records(1);
+  passed &= Gps::ReadRinexNavigation(path.string(), records, 2) && (records.size() == num_records + 1);
+  std::filesystem::remove(path);
+  passed &= !Gps::ReadRinexNavigation(path.string(), records);
+
+  const std::string observation = "     3.04           O: OBSERVATION DATA    M: MIXED          RINEX VERSION / TYPE\n";
+  const std::string no_end = version2_text.substr(0, 81 * 2);
+  passed &= !Gps::ParseRinexNavigation(observation.data(), observation.size(), records)
+         && !Gps::ParseRinexNavigation(no_end.data(), no_end.size(), records);
+
+  std::cout << (passed ? "passed" : "failed") << " (" << num_records << " records per file, "
+            << parse_bytes / (1.0e6 * parse_seconds) << " MB/s)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = RinexNumberTest();
+  passed &= RinexRoundTripTest();
+  return passed ? 0 : 1;
+}
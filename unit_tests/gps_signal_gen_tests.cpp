@@ -0,0 +1,490 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <numbers>
+#include <sstream>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "gps_checkpoint.hpp"
+#include "gps_common.hpp"
+#include "gps_coordinates.hpp"
+#include "gps_signal_dynamics.hpp"
+#include "gps_signal_gen.hpp"
+
+constexpr double TEST_TIME = 100000.0;
+
+// 24 GPS-like orbits with a common clock, seen from a mid-latitude receiver
+std::vector<Gps::SatelliteDynamics> MakeDynamics(const double elevation_mask = 0.0)
+{
+  Gps::Ephemeris eph;
+  eph.sqrtA = 5153.6;
+  eph.e = 0.01;
+  eph.i_0 = 0.96;
+  eph.omega = 0.3;
+  eph.t_oe = TEST_TIME;
+  eph.Omega_dot = -8.0e-9;
+  eph.del_n = 4.0e-9;
+  Gps::ClockData clock;
+  clock.t_oc = TEST_TIME;
+  clock.a_f0 = 1.0e-5;
+  clock.a_f1 = 1.0e-11;
+  std::vector<Gps::SatelliteDynamics> dynamics;
+  for (int s = 0; s < 24; s++) {
+    eph.M_0 = 0.26 * s;
+    eph.Omega_0 = 1.05 * (s % 6);
+    dynamics.emplace_back(eph, clock, elevation_mask);
+  }
+  return dynamics;
+}
+
+Eigen::Vector3d TestReceiver()
+{
+  return Gps::LlaToEcef(0.7, 0.6, 100.0);
+}
+
+Gps::SignalObservables Observe(const Gps::SatelliteDynamics& dynamics, const double gps_time)
+{
+  Gps::SignalObservables obs;
+  Eigen::Vector3d zero = Eigen::Vector3d::Zero();
+  dynamics.Observe(gps_time, TestReceiver(), zero, zero, obs);
+  return obs;
+}
+
+// Generates one satellite alone, baseband, without quantization
+std::vector<std::complex<double>> Generate(const Gps::SatelliteDynamics& dynamics, const std::size_t num_samples,
+  const double sample_frequency, const std::size_t block_size, Gps::Lnav::State<double>& state)
+{
+  std::vector<Gps::Lnav::State<double>> states(1);
+  std::vector<Gps::Lnav::SatelliteInfo> sat_info;
+  sat_info.emplace_back(1);
+  sat_info[0].Frame().RandomizeParams();
+  std::vector<Gps::SatelliteDynamics> sats {dynamics};
+  std::vector<std::complex<double>> samples(num_samples);
+  double gps_time = TEST_TIME;
+  Gps::Lnav::GenSignalsWithDynamics<double>(states, sat_info, sats, Gps::StaticReceiver(TestReceiver()),
+    gps_time, samples.data(), num_samples, sample_frequency, 0.0, 1.0, block_size);
+  state = states[0];
+  return samples;
+}
+
+
+/*
+The code and carrier frequencies of a block must be the derivatives of the pseudorange (up to the
+neglected rate of change of the light time, ~0.01 Hz), and the generated carrier must show that
+Doppler: with the data and code removed by squaring, the phase advance per sample gives the
+frequency. After 2000 blocks the code phase and data indices must still match the transmit time.
+*/
+bool DynamicsDopplerTest()
+{
+  std::cout << "Dynamics Doppler Test: ";
+  std::vector<Gps::SatelliteDynamics> dynamics = MakeDynamics();
+  Eigen::Vector3d zero = Eigen::Vector3d::Zero();
+  constexpr double h = 0.5;
+  double max_freq_error = 0.0, max_rate_error = 0.0;
+  std::size_t best = 0;
+  double best_doppler = 0.0;
+  for (std::size_t s = 0; s < dynamics.size(); s++) {
+    Gps::PhasePolynomial poly;
+    if (!dynamics[s].Block(TEST_TIME, TestReceiver(), zero, zero, 0.0, poly)) continue;
+    double before = Observe(dynamics[s], TEST_TIME - h).pseudorange;
+    double now = Observe(dynamics[s], TEST_TIME).pseudorange;
+    double after = Observe(dynamics[s], TEST_TIME + h).pseudorange;
+    double rate = (after - before) / (2.0 * h);
+    double accel = (after - (2.0 * now) + before) / (h * h);
+    max_freq_error = std::max({max_freq_error,
+      std::abs(poly.carrier_frequency + (Gps::L1_FREQUENCY * rate / Gps::LIGHT_SPEED)),
+      std::abs(poly.code_frequency - (Gps::CA_RATE * (1.0 - (rate / Gps::LIGHT_SPEED))))});
+    max_rate_error = std::max(max_rate_error,
+      std::abs(poly.carrier_frequency_rate + (Gps::L1_FREQUENCY * accel / Gps::LIGHT_SPEED)));
+    if (std::abs(poly.carrier_frequency) > best_doppler) {
+      best = s;
+      best_doppler = std::abs(poly.carrier_frequency);
+    }
+  }
+
+  // carrier frequency of the generated signal over its last block
+  constexpr double sample_frequency = 2.046e6;
+  constexpr std::size_t block_size = 2046;
+  constexpr std::size_t num_samples = 2000 * block_size;
+  Gps::Lnav::State<double> state;
+  std::vector<std::complex<double>> samples = Generate(dynamics[best], num_samples, sample_frequency, block_size, state);
+  std::complex<double> sum = 0.0;
+  for (std::size_t k = num_samples - block_size; k + 1 < num_samples; k++) {
+    sum += (samples[k + 1] * samples[k + 1]) * std::conj(samples[k] * samples[k]);
+  }
+  double measured = std::arg(sum) * sample_frequency / (2.0 * TwoPi<double>);
+  double end_time = TEST_TIME + (num_samples / sample_frequency);
+  Gps::PhasePolynomial poly;
+  dynamics[best].Block(end_time - (block_size / sample_frequency), TestReceiver(), zero, zero, 0.0, poly);
+  double doppler_error = std::abs(measured - poly.carrier_frequency);
+
+  Gps::Lnav::State<double> truth;
+  Gps::Lnav::SetStateFromTransmitTime(truth, Observe(dynamics[best], end_time).transmit_time);
+  double chip_error = std::abs(std::remainder(state.chip - truth.chip, 1023.0));
+  bool indices = (state.subframe == truth.subframe) && (state.bit == truth.bit)
+              && (state.code_cycle == truth.code_cycle);
+
+  bool passed = (max_freq_error < 0.05) && (max_rate_error < 1.0e-3) && (doppler_error < 0.5)
+             && (std::abs(poly.carrier_frequency) > 500.0) && (chip_error < 1.0e-5) && indices;
+  std::cout << (passed ? "passed" : "failed") << " (frequency " << max_freq_error << " Hz, rate "
+            << max_rate_error << " Hz/s, generated Doppler " << measured << " vs " << poly.carrier_frequency
+            << " Hz, code phase " << chip_error << " chips)\n";
+  return passed;
+}
+
+
+/*
+Sets the elevation mask of a rising and of a setting satellite to their elevation 0.4005 s into a
+one second run of 1 ms blocks. The rising satellite must be silent until the first block at or after the
+crossing and then start at the code phase of its transmit time; the setting satellite the reverse.
+*/
+bool RiseSetTest()
+{
+  std::cout << "Rise Set Test: ";
+  std::vector<Gps::SatelliteDynamics> dynamics = MakeDynamics();
+  constexpr double sample_frequency = 1.023e6;
+  constexpr std::size_t block_size = 1023;
+  constexpr std::size_t num_samples = 1000 * block_size;
+  constexpr double deg = std::numbers::pi / 180.0;
+
+  bool passed = true;
+  int tested[2] = {0, 0}; // setting, rising
+  for (Gps::SatelliteDynamics& sat : dynamics) {
+    double start_el = Observe(sat, TEST_TIME).elevation;
+    double end_el = Observe(sat, TEST_TIME + 1.0).elevation;
+    bool rising = (end_el > start_el);
+    if ((start_el < 10.0 * deg) || (start_el > 60.0 * deg) || (tested[rising] > 0)) continue;
+    tested[rising]++;
+    sat.SetElevationMask(Observe(sat, TEST_TIME + 0.4005).elevation);
+
+    // crossing time by bisection
+    double low = TEST_TIME, high = TEST_TIME + 1.0;
+    for (int i = 0; i < 60; i++) {
+      double mid = 0.5 * (low + high);
+      bool above = (Observe(sat, mid).elevation >= sat.ElevationMask());
+      ((above == rising) ? high : low) = mid;
+    }
+    std::size_t switch_block = static_cast<std::size_t>(std::ceil((high - TEST_TIME) * 1000.0));
+
+    Gps::Lnav::State<double> state;
+    std::vector<std::complex<double>> samples = Generate(sat, num_samples, sample_frequency, block_size, state);
+    std::size_t first_on = num_samples, last_on = 0;
+    for (std::size_t k = 0; k < num_samples; k++) {
+      if (std::abs(samples[k]) > 0.5) {
+        first_on = std::min(first_on, k);
+        last_on = k;
+      }
+    }
+    if (rising) {
+      passed &= (first_on == switch_block * block_size) && (last_on == num_samples - 1) && state.visible;
+    }
+    else {
+      passed &= (first_on == 0) && (last_on + 1 == switch_block * block_size) && !state.visible;
+    }
+  }
+  passed &= (tested[0] == 1) && (tested[1] == 1);
+  std::cout << (passed ? "passed" : "failed") << "\n";
+  return passed;
+}
+
+
+// num_sats satellites with distinct code phases, Dopplers and data, frame buffers initialized
+void MakeSignals(const std::size_t num_sats, std::vector<Gps::Lnav::State<double>>& states,
+  std::vector<Gps::Lnav::SatelliteInfo>& sat_info)
+{
+  states.assign(num_sats, Gps::Lnav::State<double>());
+  sat_info.clear();
+  for (std::size_t i = 0; i < num_sats; i++) {
+    sat_info.emplace_back(static_cast<uint8_t>(i + 1));
+    sat_info[i].Frame().RandomizeParams();
+    sat_info[i].Initialize(0);
+    states[i].chip = 100.3 * i;
+    states[i].code_frequency = Gps::CA_RATE + (0.2 * i);
+    states[i].carrier_frequency = 1.0e6 + (300.0 * i) - 1000.0;
+    states[i].carrier_phase = 0.1 * i;
+  }
+}
+
+
+/*
+The fixed-point path must match the floating path to the resolution of its sine table, continue
+the same integer sequence when a run is split into two calls (samples and final states identical),
+and be faster.
+*/
+bool FixedPointTest()
+{
+  std::cout << "Fixed Point Test: ";
+  constexpr std::size_t num_sats = 8;
+  constexpr std::size_t num_samples = 2000000;
+  constexpr double sample_frequency = 5.0e6;
+  constexpr double amplitude = 1000.0;
+  std::vector<Gps::Lnav::State<double>> float_states, fixed_states, split_states;
+  std::vector<Gps::Lnav::SatelliteInfo> float_info, fixed_info, split_info;
+  MakeSignals(num_sats, float_states, float_info);
+  fixed_states = float_states;
+  fixed_info = float_info;
+  split_states = float_states;
+  split_info = float_info;
+
+  std::vector<std::complex<int16_t>> floating(num_samples), fixed(num_samples), split(num_samples);
+  auto start = std::chrono::steady_clock::now();
+  Gps::Lnav::GenSignalsWithData<int16_t,double,false>(float_states, float_info, floating.data(), num_samples,
+    sample_frequency, amplitude);
+  auto middle = std::chrono::steady_clock::now();
+  Gps::Lnav::GenSignalsWithData<int16_t,double,true>(fixed_states, fixed_info, fixed.data(), num_samples,
+    sample_frequency, amplitude);
+  auto end = std::chrono::steady_clock::now();
+  double float_time = std::chrono::duration<double>(middle - start).count();
+  double fixed_time = std::chrono::duration<double>(end - middle).count();
+
+  constexpr std::size_t first = 777777;
+  Gps::Lnav::GenSignalsWithData<int16_t,double,true>(split_states, split_info, split.data(), first,
+    sample_frequency, amplitude);
+  Gps::Lnav::GenSignalsWithData<int16_t,double,true>(split_states, split_info, split.data() + first,
+    num_samples - first, sample_frequency, amplitude);
+
+  // table phase error is at most pi/1024 per satellite; a chip edge within an NCO LSB of a sample
+  // may land on the other side, flipping that one sample
+  double sum_squares = 0.0;
+  std::size_t large_errors = 0;
+  for (std::size_t k = 0; k < num_samples; k++) {
+    double error = std::abs(std::complex<double>(floating[k].real() - fixed[k].real(),
+                                                 floating[k].imag() - fixed[k].imag()));
+    sum_squares += error * error;
+    large_errors += (error > num_sats * ((amplitude * std::numbers::pi / 1024.0) + 1.0)) ? 1 : 0;
+  }
+  double rms_error = std::sqrt(sum_squares / num_samples);
+
+  bool passed = (split == fixed) && (rms_error < 0.01 * amplitude) && (large_errors < 10)
+             && (fixed_time < float_time);
+  for (std::size_t i = 0; i < num_sats; i++) {
+    passed &= (split_states[i].chip == fixed_states[i].chip)
+           && (split_states[i].carrier_phase == fixed_states[i].carrier_phase)
+           && (split_states[i].subframe == fixed_states[i].subframe) && (split_states[i].bit == fixed_states[i].bit)
+           && (split_states[i].code_cycle == fixed_states[i].code_cycle)
+           && (std::abs(std::remainder(fixed_states[i].chip - float_states[i].chip, 1023.0)) < 1.0e-6)
+           && (fixed_states[i].bit == float_states[i].bit);
+  }
+  std::cout << (passed ? "passed" : "failed") << " (rms error " << rms_error << ", " << large_errors
+            << " flipped samples, " << float_time / fixed_time << "x faster than floating)\n";
+  return passed;
+}
+
+
+/*
+One zero-delay unit tap per satellite on one element must reproduce GenSignalsWithData: identical
+final states, and samples bit for bit unless the compiler contracts the two paths' products and sums
+into FMAs differently (then within a few ulp). A second element with steering phases must be the same signal rotated. A tap delayed by 0.3 ms
+starting on the first bit of a subframe must use the last bit of the previous subframe, checked
+against the undelayed generator started 0.3 ms earlier.
+*/
+bool SignalTapsTest()
+{
+  std::cout << "Signal Taps Test: ";
+  constexpr std::size_t num_sats = 4;
+  constexpr std::size_t num_samples = 200000;
+  constexpr double sample_frequency = 5.0e6;
+  constexpr double amplitude = 3.0;
+  using Tap = Gps::Lnav::SignalTap<double>;
+  std::vector<Gps::Lnav::State<double>> direct_states, tap_states;
+  std::vector<Gps::Lnav::SatelliteInfo> direct_info, tap_info;
+  MakeSignals(num_sats, direct_states, direct_info);
+  tap_states = direct_states;
+  tap_info = direct_info;
+
+  std::vector<std::vector<Tap>> taps(num_sats, std::vector<Tap>(1));
+  for (std::size_t i = 0; i < num_sats; i++) {
+    taps[i][0].steering_phases = {0.0, 0.5 + i};
+  }
+  std::vector<std::complex<double>> direct(num_samples), element0(num_samples), element1(num_samples);
+  std::complex<double>* elements[2] = {element0.data(), element1.data()};
+  Gps::Lnav::GenSignalsWithData<double>(direct_states, direct_info, direct.data(), num_samples,
+    sample_frequency, amplitude);
+  Gps::Lnav::GenSignalsWithTaps<double>(tap_states, tap_info, taps, elements, 2, num_samples,
+    sample_frequency, amplitude);
+  double direct_error = 0.0;
+  for (std::size_t k = 0; k < num_samples; k++) {
+    direct_error = std::max(direct_error, std::abs(element0[k] - direct[k]));
+  }
+  bool passed = (direct_error < 1.0e-14 * amplitude * num_sats);
+  for (std::size_t i = 0; i < num_sats; i++) {
+    passed &= (tap_states[i].chip == direct_states[i].chip) && (tap_states[i].carrier_phase == direct_states[i].carrier_phase)
+           && (tap_states[i].bit == direct_states[i].bit);
+  }
+
+  // steered element, single satellite
+  std::vector<Gps::Lnav::State<double>> one_state(1, tap_states[0]);
+  std::vector<Gps::Lnav::SatelliteInfo> one_info(1, tap_info[0]);
+  std::vector<std::vector<Tap>> one_tap(1, taps[0]);
+  Gps::Lnav::GenSignalsWithTaps<double>(one_state, one_info, one_tap, elements, 2, num_samples,
+    sample_frequency, amplitude);
+  double steering_error = 0.0;
+  std::complex<double> rotation = std::polar(1.0, taps[0][0].steering_phases[1]);
+  for (std::size_t k = 0; k < num_samples; k++) {
+    steering_error = std::max(steering_error, std::abs(element1[k] - (rotation * element0[k])));
+  }
+
+  // delayed tap from the start of subframe 1 against the direct signal 0.3 ms earlier
+  constexpr double delay = 3.0e-4;
+  Gps::Lnav::State<double> start;
+  start.subframe = 1;
+  start.code_frequency = Gps::CA_RATE;
+  start.carrier_frequency = 1500.0;
+  std::vector<Gps::Lnav::State<double>> delayed_state(1, start), early_state(1, start);
+  early_state[0].subframe = 0;
+  early_state[0].bit = 299;
+  early_state[0].code_cycle = 19;
+  early_state[0].chip = 1023.0 - (delay * Gps::CA_RATE);
+  std::vector<Gps::Lnav::SatelliteInfo> delayed_info, early_info;
+  delayed_info.emplace_back(7);
+  delayed_info[0].Frame().RandomizeParams();
+  delayed_info[0].Initialize(0);
+  early_info = delayed_info;
+  bool preamble_differs = (early_info[0].GetMessageBit(0, 299) != early_info[0].GetMessageBit(1, 0));
+
+  std::vector<std::vector<Tap>> delayed_tap(1, std::vector<Tap>(1));
+  delayed_tap[0][0].delay = delay;
+  std::vector<std::complex<double>> delayed(num_samples), early(num_samples);
+  std::complex<double>* delayed_elements[1] = {delayed.data()};
+  Gps::Lnav::GenSignalsWithTaps<double>(delayed_state, delayed_info, delayed_tap, delayed_elements, 1, num_samples,
+    sample_frequency, amplitude);
+  Gps::Lnav::GenSignalsWithData<double>(early_state, early_info, early.data(), num_samples, sample_frequency, amplitude);
+  std::size_t delayed_mismatches = 0;
+  for (std::size_t k = 0; k < num_samples; k++) {
+    // same carrier; a chip edge within rounding of a sample may fall on either side
+    delayed_mismatches += (std::abs(delayed[k] - early[k]) > 1.0e-6) ? 1 : 0;
+  }
+
+  passed &= (steering_error < 1.0e-12) && preamble_differs && (delayed_mismatches < 3);
+  std::cout << (passed ? "passed" : "failed") << " (direct " << direct_error << ", steering " << steering_error << ", delayed tap "
+            << delayed_mismatches << " mismatched samples)\n";
+  return passed;
+}
+
+
+/*
+The real IF output must be the real part of the complex signal at the full carrier frequency, for
+a generic IF (recurrence mixer) and for IF = fs/4 (sign pattern). Each run is split into calls
+that leave 1 to 3 samples past the last whole fs/4 cycle, so the carried code and carrier state and
+the remainder of the sign pattern are checked as well.
+*/
+bool RealSignalTest()
+{
+  std::cout << "Real Signal Test: ";
+  constexpr std::size_t num_sats = 6;
+  constexpr std::size_t num_samples = 100000;
+  constexpr double sample_frequency = 5.0e6;
+  constexpr double amplitude = 2.0;
+  bool passed = true;
+  double max_error[2] = {0.0, 0.0};
+  const double intermediate_frequencies[2] = {1.1e6, sample_frequency / 4.0};
+  for (int run = 0; run < 2; run++) {
+    std::vector<Gps::Lnav::State<double>> complex_states, real_states;
+    std::vector<Gps::Lnav::SatelliteInfo> complex_info, real_info;
+    MakeSignals(num_sats, complex_states, complex_info);
+    for (Gps::Lnav::State<double>& state : complex_states) {
+      state.carrier_frequency += intermediate_frequencies[run] - 1.0e6;
+    }
+    real_states = complex_states;
+    real_info = complex_info;
+
+    std::vector<std::complex<double>> complex_samples(num_samples);
+    std::vector<double> real_samples(num_samples);
+    const std::size_t call_sizes[4] = {25001, 25002, 25003, num_samples - 75006};
+    std::size_t start = 0;
+    for (std::size_t call_size : call_sizes) {
+      Gps::Lnav::GenSignalsWithData<double>(complex_states, complex_info, &complex_samples[start],
+        call_size, sample_frequency, amplitude);
+      Gps::Lnav::GenRealSignalsWithData<double>(real_states, real_info, &real_samples[start],
+        call_size, sample_frequency, intermediate_frequencies[run], amplitude);
+      start += call_size;
+    }
+    for (std::size_t k = 0; k < num_samples; k++) {
+      max_error[run] = std::max(max_error[run], std::abs(real_samples[k] - complex_samples[k].real()));
+    }
+    for (std::size_t i = 0; i < num_sats; i++) {
+      passed &= (real_states[i].chip == complex_states[i].chip) && (real_states[i].bit == complex_states[i].bit)
+             && (std::abs(std::remainder(real_states[i].carrier_phase - complex_states[i].carrier_phase,
+                                         TwoPi<double>)) < 1.0e-9);
+    }
+    passed &= (max_error[run] < 1.0e-10 * amplitude * num_sats);
+  }
+  std::cout << (passed ? "passed" : "failed") << " (max error " << max_error[0] << " generic IF, "
+            << max_error[1] << " fs/4)\n";
+  return passed;
+}
+
+
+/*
+Stopping partway, writing a checkpoint, reading it into fresh containers and generating the rest
+must give the same samples and states, bit for bit, as making the same two calls without stopping.
+(The floating path re-derives its steps from the state at each call, so the split point itself
+matters at the 1e-5 rad level after 400000 samples; the checkpoint must not add anything to that.)
+The low sample rate lets the run cross subframe boundaries on both sides of the checkpoint, with
+frequency rates so that every State field matters.
+*/
+bool CheckpointResumeTest()
+{
+  std::cout << "Checkpoint Resume Test: ";
+  constexpr std::size_t num_sats = 5;
+  constexpr std::size_t num_samples = 700000;
+  constexpr std::size_t split = 400000;
+  constexpr double sample_frequency = 50.0e3;
+  constexpr double amplitude = 1.5;
+  std::vector<Gps::Lnav::State<double>> straight_states, resumed_states;
+  std::vector<Gps::Lnav::SatelliteInfo> straight_info, resumed_info;
+  MakeSignals(num_sats, straight_states, straight_info);
+  for (std::size_t i = 0; i < num_sats; i++) {
+    straight_states[i].code_frequency_rate = 0.01 * (i + 1.0);
+    straight_states[i].carrier_frequency_rate = -0.7 * (i + 1.0);
+  }
+  resumed_states = straight_states;
+  resumed_info = straight_info;
+
+  std::vector<std::complex<double>> straight(num_samples), resumed(num_samples);
+  Gps::Lnav::GenSignalsWithData<double>(straight_states, straight_info, straight.data(), split,
+    sample_frequency, amplitude);
+  Gps::Lnav::GenSignalsWithData<double>(straight_states, straight_info, &straight[split], num_samples - split,
+    sample_frequency, amplitude);
+
+  Gps::Lnav::GenSignalsWithData<double>(resumed_states, resumed_info, resumed.data(), split,
+    sample_frequency, amplitude);
+  std::stringstream checkpoint(std::ios::in | std::ios::out | std::ios::binary);
+  Gps::Lnav::WriteCheckpoint(checkpoint, split / sample_frequency, resumed_states, resumed_info);
+  std::vector<Gps::Lnav::State<double>> loaded_states;
+  std::vector<Gps::Lnav::SatelliteInfo> loaded_info;
+  double gps_time = 0.0;
+  bool passed = Gps::Lnav::ReadCheckpoint(checkpoint, gps_time, loaded_states, loaded_info)
+             && (gps_time == split / sample_frequency) && (loaded_states.size() == num_sats);
+  if (passed) {
+    Gps::Lnav::GenSignalsWithData<double>(loaded_states, loaded_info, &resumed[split], num_samples - split,
+      sample_frequency, amplitude);
+    passed &= (straight == resumed);
+    for (std::size_t i = 0; i < num_sats; i++) {
+      passed &= (loaded_states[i].subframe == straight_states[i].subframe)
+             && (loaded_states[i].bit == straight_states[i].bit)
+             && (loaded_states[i].chip == straight_states[i].chip)
+             && (loaded_states[i].carrier_phase == straight_states[i].carrier_phase)
+             && (loaded_states[i].carrier_frequency == straight_states[i].carrier_frequency);
+    }
+  }
+  // subframes 0 and 2 on either side of the checkpoint, which falls inside subframe 1
+  passed &= (resumed_states[0].subframe == 1) && (straight_states[0].subframe == 2);
+  std::cout << (passed ? "passed" : "failed") << " (" << checkpoint.str().size() << " byte checkpoint)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = DynamicsDopplerTest();
+  passed &= RiseSetTest();
+  passed &= FixedPointTest();
+  passed &= SignalTapsTest();
+  passed &= RealSignalTest();
+  passed &= CheckpointResumeTest();
+  return passed ? 0 : 1;
+}
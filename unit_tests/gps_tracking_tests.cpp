@@ -0,0 +1,138 @@
+#include <iostream>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include "gps_tracking_sim.hpp"
+
+// Steady-state thermal jitter of the default loops, Kaplan 5.6.2 (Costas PLL, cycles) and
+// 5.6.1 (noncoherent early-minus-late DLL, chips)
+double PllJitter(const double cno_db, const double bandwidth, const double T)
+{
+  double cno = std::pow(10.0, 0.1 * cno_db);
+  return std::sqrt((bandwidth / cno) * (1.0 + (1.0 / (2.0 * T * cno)))) / (2.0 * std::numbers::pi);
+}
+
+double DllJitter(const double cno_db, const double bandwidth, const double spacing, const double T)
+{
+  double cno = std::pow(10.0, 0.1 * cno_db);
+  return std::sqrt((bandwidth * spacing / (2.0 * cno)) * (1.0 + (2.0 / ((2.0 - spacing) * T * cno))));
+}
+
+
+/*
+With no dynamics and no initial errors the loops sit in their steady state, so the Monte Carlo
+RMS errors must be the thermal jitter predicted from C/N0 (at C/N0 high enough that the noise in
+the normalization of the envelope DLL discriminator does not reduce its gain). This checks the C/N0 convention of the
+simulated correlator outputs as much as the loops: a 3 dB error in the amplitude shows up as a
+factor sqrt(2) here.
+*/
+bool TrackingJitterTest()
+{
+  std::cout << "Tracking Jitter Test: ";
+  Gps::TrackingLoopConfig config;
+  Gps::TruthProfile truth;
+  truth.duration = 2.0;
+  bool passed = true;
+  double pll_ratios[2], dll_ratios[2];
+  const double cnos[2] = {45.0, 50.0};
+  for (int c = 0; c < 2; c++) {
+    truth.cno = cnos[c];
+    Gps::TrackingStatistics stats = Gps::RunTrackingMonteCarlo(config, truth, 200, 7);
+    pll_ratios[c] = stats.rms_phase_error / PllJitter(cnos[c], config.pll.bandwidth, config.integration_time);
+    dll_ratios[c] = stats.rms_chip_error / DllJitter(cnos[c], config.dll.bandwidth, config.early_late_spacing,
+                                                     config.integration_time);
+    passed &= (stats.num_lost == 0) && (std::abs(pll_ratios[c] - 1.0) < 0.15) && (std::abs(dll_ratios[c] - 1.0) < 0.15);
+  }
+  std::cout << (passed ? "passed" : "failed") << " (RMS / predicted: PLL " << pll_ratios[0] << " and "
+            << pll_ratios[1] << ", DLL " << dll_ratios[0] << " and " << dll_ratios[1] << ")\n";
+  return passed;
+}
+
+
+/*
+Starting from code, frequency and phase errors under a range acceleration, the loops must pull in:
+the same noise stream over a longer duration extends the first trial exactly, so the errors
+accumulated after the first second can be isolated and must be down to the steady-state jitter.
+*/
+bool TrackingConvergenceTest()
+{
+  std::cout << "Tracking Convergence Test: ";
+  Gps::TrackingLoopConfig config;
+  Gps::TruthProfile truth;
+  truth.cno = 45.0;
+  truth.range_rate = -400.0;
+  truth.range_accel = 5.0;
+  truth.initial_chip_error = 0.3;
+  truth.initial_frequency_error = 8.0;
+  truth.initial_phase_error = 0.2;
+
+  truth.duration = 1.0;
+  std::mt19937_64 gen(17);
+  Gps::TrialResult first = Gps::RunTrackingTrial(config, truth, gen);
+  truth.duration = 3.0;
+  gen.seed(17);
+  Gps::TrialResult full = Gps::RunTrackingTrial(config, truth, gen);
+
+  double late_epochs = static_cast<double>(full.epochs - first.epochs);
+  double late_chip = std::sqrt((full.sum_sq_chip_error - first.sum_sq_chip_error) / late_epochs);
+  double late_phase = std::sqrt((full.sum_sq_phase_error - first.sum_sq_phase_error) / late_epochs);
+  double early_chip = std::sqrt(first.sum_sq_chip_error / first.epochs);
+  double chip_jitter = DllJitter(truth.cno, config.dll.bandwidth, config.early_late_spacing, config.integration_time);
+  double phase_jitter = PllJitter(truth.cno, config.pll.bandwidth, config.integration_time);
+  bool passed = !full.lost_lock && (full.epochs == 3000) && (early_chip > 10.0 * chip_jitter)
+             && (late_chip < 2.0 * chip_jitter) && (late_phase < 2.0 * phase_jitter);
+  std::cout << (passed ? "passed" : "failed") << " (first second " << early_chip << " chips, then "
+            << late_chip << " chips and " << late_phase << " cycles)\n";
+  return passed;
+}
+
+
+/*
+Lock statistics: no losses at high C/N0, near-certain loss well below the PLL threshold, with loss
+times inside the run. Results must be identical for the same seed at any thread count and for a
+sweep entry, and differ for another seed.
+*/
+bool TrackingLockTest()
+{
+  std::cout << "Tracking Lock Test: ";
+  Gps::TrackingLoopConfig config;
+  Gps::TruthProfile truth;
+  truth.duration = 2.0;
+  truth.range_accel = 10.0;
+
+  truth.cno = 40.0;
+  Gps::TrackingStatistics strong = Gps::RunTrackingMonteCarlo(config, truth, 200, 3);
+  truth.cno = 18.0;
+  Gps::TrackingStatistics weak = Gps::RunTrackingMonteCarlo(config, truth, 200, 3);
+  Gps::TrackingStatistics weak_serial = Gps::RunTrackingMonteCarlo(config, truth, 200, 3, 1);
+  Gps::TrackingStatistics weak_other = Gps::RunTrackingMonteCarlo(config, truth, 200, 4);
+  Gps::TrackingLoopConfig wide = config;
+  wide.pll.bandwidth = 25.0;
+  std::vector<Gps::TrackingStatistics> sweep = Gps::RunTrackingSweep({wide, config}, truth, 200, 3, 3);
+
+  auto same = [](const Gps::TrackingStatistics& a, const Gps::TrackingStatistics& b)
+  {
+    return (a.num_lost == b.num_lost) && (a.rms_chip_error == b.rms_chip_error)
+        && (a.rms_phase_error == b.rms_phase_error) && (a.rms_frequency_error == b.rms_frequency_error)
+        && (a.mean_loss_of_lock_time == b.mean_loss_of_lock_time);
+  };
+  bool passed = (strong.lock_probability == 1.0) && (strong.num_trials == 200)
+             && (weak.lock_probability < 0.1) && (weak.mean_loss_of_lock_time > 0.0)
+             && (weak.mean_loss_of_lock_time < truth.duration)
+             && (std::abs(weak.lock_probability - (1.0 - (static_cast<double>(weak.num_lost) / weak.num_trials))) < 1.0e-12)
+             && same(weak, weak_serial) && same(weak, sweep[1]) && !same(weak, weak_other);
+  std::cout << (passed ? "passed" : "failed") << " (lock probability " << strong.lock_probability << " at 40 dB-Hz, "
+            << weak.lock_probability << " at 18 dB-Hz, mean loss after " << weak.mean_loss_of_lock_time << " s)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = TrackingJitterTest();
+  passed &= TrackingConvergenceTest();
+  passed &= TrackingLockTest();
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,161 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "gps_coordinates.hpp"
+#include "gps_visibility.hpp"
+#include "test_constellation.hpp"
+
+// Passes from sampling the exact orbit every second, crossings by bisection and peaks by ternary search
+std::vector<Gps::SatellitePass> ReferencePasses(const std::vector<Gps::Ephemeris>& ephemerides,
+  const Eigen::Vector3d& rx_pos, const double start_time, const double end_time, const double mask)
+{
+  std::vector<Gps::SatellitePass> passes;
+  for (std::size_t s = 0; s < ephemerides.size(); s++) {
+    auto elevation = [&](const double t)
+    {
+      Eigen::Vector3d sat_pos;
+      ephemerides[s].P(t, sat_pos);
+      return Gps::Elevation(rx_pos, sat_pos) - mask;
+    };
+    auto crossing = [&](double a, double b)
+    {
+      bool rising = elevation(a) < 0.0;
+      while ((b - a) > 1.0e-6) {
+        double c = 0.5 * (a + b);
+        ((elevation(c) < 0.0) == rising ? a : b) = c;
+      }
+      return 0.5 * (a + b);
+    };
+
+    double rise = 0.0, peak_sample = 0.0, peak_value = -1.0;
+    double prev = elevation(start_time);
+    if (prev >= 0.0) {
+      rise = start_time;
+      peak_sample = start_time;
+      peak_value = prev;
+    }
+    for (double t = start_time + 1.0; t <= end_time + 0.5; t += 1.0) {
+      double value = elevation(t);
+      bool last = t > end_time - 0.5;
+      bool set = ((prev >= 0.0) && (value < 0.0)) || (last && (value >= 0.0));
+      if (value >= 0.0 && prev < 0.0) {
+        rise = crossing(t - 1.0, t);
+        peak_sample = t;
+        peak_value = value;
+      } else if (value >= 0.0 && value > peak_value) {
+        peak_sample = t;
+        peak_value = value;
+      }
+      if (set) {
+        Gps::SatellitePass& pass = passes.emplace_back();
+        pass.satellite = static_cast<uint16_t>(s);
+        pass.rise_time = rise;
+        pass.set_time = (value < 0.0) ? crossing(t - 1.0, t) : end_time;
+        double a = std::max(peak_sample - 1.0, pass.rise_time);
+        double b = std::min(peak_sample + 1.0, pass.set_time);
+        while ((b - a) > 1.0e-7) {
+          double c = a + ((b - a) / 3.0);
+          double d = b - ((b - a) / 3.0);
+          if (elevation(c) > elevation(d)) {
+            b = d;
+          } else {
+            a = c;
+          }
+        }
+        pass.peak_time = 0.5 * (a + b);
+        pass.peak_elevation = elevation(pass.peak_time) + mask;
+        peak_value = -1.0;
+      }
+      prev = value;
+    }
+  }
+  return passes;
+}
+
+
+// Orders passes by satellite, then rise time, since equal rise times at the span start leave the order open
+void SortBySatellite(std::vector<Gps::SatellitePass>& passes)
+{
+  std::sort(passes.begin(), passes.end(), [](const Gps::SatellitePass& a, const Gps::SatellitePass& b)
+  {
+    return (a.satellite != b.satellite) ? (a.satellite < b.satellite) : (a.rise_time < b.rise_time);
+  });
+}
+
+
+/*
+Predicts passes above a 10 degree mask over 8 hours for receivers from the equator to near the pole,
+and compares every rise, set and peak to a 1 second scan of the exact orbit. The span is chosen so
+that some passes are already up at its start and some are still up at its end; those must be clipped
+to the span. The prediction must not depend on the thread count.
+*/
+bool PassPredictionTest()
+{
+  std::cout << "Pass Prediction Test: ";
+  constexpr double deg = std::numbers::pi / 180.0;
+  constexpr double mask = 10.0 * deg;
+  constexpr double start_time = 3600.0;
+  constexpr double end_time = start_time + (8.0 * 3600.0);
+  const std::vector<Gps::Ephemeris> ephemerides = MakeConstellation();
+  const Gps::EphemerisSet satellites(ephemerides);
+  const std::vector<Eigen::Vector3d> receivers = {
+    Gps::LlaToEcef(0.0, 0.0, 0.0), Gps::LlaToEcef(37.4 * deg, -122.1 * deg, 30.0),
+    Gps::LlaToEcef(-33.9 * deg, 151.2 * deg, 50.0), Gps::LlaToEcef(64.8 * deg, -147.7 * deg, 150.0),
+    Gps::LlaToEcef(-77.8 * deg, 166.7 * deg, 20.0), Gps::LlaToEcef(19.8 * deg, -155.5 * deg, 4200.0)};
+
+  std::vector<std::vector<Gps::SatellitePass>> passes =
+    Gps::PredictPasses(satellites, receivers, start_time, end_time, mask, 60.0, 1);
+  const std::vector<std::vector<Gps::SatellitePass>> threaded =
+    Gps::PredictPasses(satellites, receivers, start_time, end_time, mask, 60.0, 3);
+
+  bool passed = (passes.size() == receivers.size()) && (threaded.size() == receivers.size());
+  double rise_set_error = 0.0, peak_time_error = 0.0, peak_elevation_error = 0.0;
+  std::size_t num_passes = 0, open_at_start = 0, open_at_end = 0;
+  for (std::size_t r = 0; passed && r < receivers.size(); r++) {
+    passed &= std::is_sorted(passes[r].begin(), passes[r].end(), [](const auto& a, const auto& b)
+    {
+      return a.rise_time < b.rise_time;
+    });
+    passed &= (threaded[r].size() == passes[r].size());
+    for (std::size_t k = 0; passed && k < passes[r].size(); k++) {
+      passed &= (threaded[r][k].satellite == passes[r][k].satellite) && (threaded[r][k].rise_time == passes[r][k].rise_time)
+             && (threaded[r][k].peak_time == passes[r][k].peak_time);
+    }
+
+    std::vector<Gps::SatellitePass> reference = ReferencePasses(ephemerides, receivers[r], start_time, end_time, mask);
+    SortBySatellite(passes[r]);
+    SortBySatellite(reference);
+    passed &= (reference.size() == passes[r].size());
+    for (std::size_t k = 0; passed && k < reference.size(); k++) {
+      const Gps::SatellitePass& pass = passes[r][k];
+      const Gps::SatellitePass& expected = reference[k];
+      passed &= (pass.satellite == expected.satellite) && (pass.rise_time <= pass.peak_time)
+             && (pass.peak_time <= pass.set_time);
+      rise_set_error = std::max({rise_set_error, std::abs(pass.rise_time - expected.rise_time),
+                                 std::abs(pass.set_time - expected.set_time)});
+      peak_time_error = std::max(peak_time_error, std::abs(pass.peak_time - expected.peak_time));
+      peak_elevation_error = std::max(peak_elevation_error, std::abs(pass.peak_elevation - expected.peak_elevation));
+      // clipped passes carry the span limits exactly
+      open_at_start += (pass.rise_time == start_time) ? 1 : 0;
+      open_at_end += (pass.set_time == end_time) ? 1 : 0;
+      num_passes++;
+    }
+  }
+  passed &= (rise_set_error < 0.01) && (peak_time_error < 0.01) && (peak_elevation_error < 1.0e-9)
+         && (open_at_start >= receivers.size()) && (open_at_end >= receivers.size());
+  std::cout << (passed ? "passed" : "failed") << " (" << num_passes << " passes, " << open_at_start
+            << " open at start, " << open_at_end << " open at end, rise/set error " << rise_set_error
+            << " s, peak time error " << peak_time_error << " s, peak elevation error " << peak_elevation_error
+            << " rad)\n";
+  return passed;
+}
+
+
+int main()
+{
+  bool passed = PassPredictionTest();
+  return passed ? 0 : 1;
+}
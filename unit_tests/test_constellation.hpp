@@ -0,0 +1,44 @@
+#ifndef SATELLITE_CONSTELLATIONS_UNIT_TESTS_TEST_CONSTELLATION
+#define SATELLITE_CONSTELLATIONS_UNIT_TESTS_TEST_CONSTELLATION
+
+#include <numbers>
+#include <vector>
+
+#include "gps_ephemeris.hpp"
+
+// 24 satellites in six planes with GPS-like orbits
+inline std::vector<Gps::Ephemeris> MakeConstellation()
+{
+  constexpr double pi = std::numbers::pi;
+  std::vector<Gps::Ephemeris> ephemerides(24);
+  for (std::size_t s = 0; s < ephemerides.size(); s++) {
+    Gps::Ephemeris& eph = ephemerides[s];
+    std::size_t plane = s / 4;
+    std::size_t slot = s % 4;
+    eph.sqrtA = 5153.7;
+    eph.e = 0.002 + (0.001 * slot);
+    eph.i_0 = 0.96;
+    eph.Omega_0 = plane * pi / 3.0;
+    eph.M_0 = (slot * pi / 2.0) + (plane * pi / 12.0);
+    eph.omega = 0.3 * slot;
+    eph.Omega_dot = -8.0e-9;
+    eph.t_oe = 7200.0;
+  }
+  return ephemerides;
+}
+
+// The same constellation with clocks: distinct offsets, a common drift and group delay
+inline void MakeConstellation(std::vector<Gps::Ephemeris>& ephemerides, std::vector<Gps::ClockData>& clock_data)
+{
+  ephemerides = MakeConstellation();
+  clock_data.assign(ephemerides.size(), Gps::ClockData());
+  for (std::size_t s = 0; s < ephemerides.size(); s++) {
+    Gps::ClockData& clock = clock_data[s];
+    clock.t_oc = ephemerides[s].t_oe;
+    clock.a_f0 = 1.0e-5 * (static_cast<double>(s) - 12.0);
+    clock.a_f1 = 1.0e-12;
+    clock.T_GD = -5.0e-9;
+  }
+}
+
+#endif